@@ -0,0 +1,119 @@
+﻿using NUnit.Framework;
+using System;
+using System.Linq;
+using System.Text;
+
+namespace Receive.Tests
+{
+    [TestFixture]
+    public class FragmentReassemblyTest
+    {
+
+        // Record "|45|14.6C;|46|14.8C;|47|15.1C;" sent as record 200 in 2 fragment frames, encoded by Transmit/msg_kineis_frag.c
+        private static readonly string[] Fragments =
+        {
+            "A49DDC801A87C34357C31342E36433B7C34367C31342E38433B7C6888EDF50",
+            "A631DC8114834377C31352E31433B000000000000000000000000ED6BBA030"
+        };
+        private const string Record = "|45|14.6C;|46|14.8C;|47|15.1C;";
+        private static readonly DateTime Received = new DateTime(2021, 3, 26, 13, 40, 0, DateTimeKind.Utc);
+
+        [Test]
+        [TestCase(new[] { 0, 1 })]
+        [TestCase(new[] { 1, 0 })]
+        [TestCase(new[] { 1, 1, 0 })]
+        public void Given_AllFragments_When_Add_Then_ReturnsRecordOnce(int[] order)
+        {
+            // Arrange
+            var reassembly = new FragmentReassembly(TimeSpan.FromDays(1));
+
+            // Act
+            var results = order.Select(index => reassembly.Add(FrameRecovery.ToBytes(Fragments[index]), Received)).ToList();
+
+            // Assert
+            Assert.That(results.Take(results.Count - 1), Is.All.Null);
+            Assert.That(Encoding.ASCII.GetString(results.Last()), Is.EqualTo(Record));
+            Assert.That(reassembly.PartialCount, Is.EqualTo(0));
+            Assert.That(reassembly.Add(FrameRecovery.ToBytes(Fragments[0]), Received), Is.Null);
+            Assert.That(reassembly.PartialCount, Is.EqualTo(0));
+
+        }
+
+        [Test]
+        public void Given_SingleFragmentRecord_When_ParseKineisRecord_Then_ReturnsReading()
+        {
+            // Arrange
+            var reassembly = new FragmentReassembly(TimeSpan.FromDays(1));
+
+            // Act
+            var record = reassembly.Add(FrameRecovery.ToBytes("0504DC900507C377C32312E3235433B0000000000000000000000D53F565F0"), Received);
+            var result = IoTHubData.ParseKineisRecord(record);
+
+            // Assert
+            Assert.That(result.Converted, Is.EqualTo("|7|21.25C;"));
+            Assert.That(result.Id, Is.EqualTo(7));
+            Assert.That(result.Temperature, Is.EqualTo(21.25));
+            Assert.That(result.IsValid, Is.True);
+
+        }
+
+        [Test]
+        public void Given_NewRecordOfSameNumber_When_Add_Then_ReturnsNewRecord()
+        {
+            // Arrange
+            // Record "|3|15.2C;|4|15.4C;|5|15.9C;" also sent as record 200, after a reset of the transmitter
+            var newFragments = new[]
+            {
+                "37B1DC801A87C337C31352E32433B7C347C31352E34433B7C357CEDFB3C000",
+                "98BBDC8113031352E39433B0000000000000000000000000000004BF68A820"
+            };
+            var reassembly = new FragmentReassembly(TimeSpan.FromDays(1));
+            reassembly.Add(FrameRecovery.ToBytes(Fragments[0]), Received);
+            reassembly.Add(FrameRecovery.ToBytes(Fragments[1]), Received);
+
+            // Act
+            var results = newFragments.Select(fragment => reassembly.Add(FrameRecovery.ToBytes(fragment), Received.AddHours(2))).ToList();
+
+            // Assert
+            Assert.That(results[0], Is.Null);
+            Assert.That(Encoding.ASCII.GetString(results[1]), Is.EqualTo("|3|15.2C;|4|15.4C;|5|15.9C;"));
+            Assert.That(reassembly.Add(FrameRecovery.ToBytes(Fragments[1]), Received.AddHours(3)), Is.Null);
+            Assert.That(reassembly.PartialCount, Is.EqualTo(0));
+
+        }
+
+        [Test]
+        public void Given_FragmentOlderThanExpiry_When_Add_Then_RecordIsIncomplete()
+        {
+            // Arrange
+            var reassembly = new FragmentReassembly(TimeSpan.FromHours(12));
+            reassembly.Add(FrameRecovery.ToBytes(Fragments[0]), Received);
+
+            // Act
+            var result = reassembly.Add(FrameRecovery.ToBytes(Fragments[1]), Received.AddDays(1));
+
+            // Assert
+            Assert.That(result, Is.Null);
+            Assert.That(reassembly.PartialCount, Is.EqualTo(1));
+
+        }
+
+        [Test]
+        [TestCase("A49DDC801A87C34357C31342E36433B7C34367C31342E38433B7C6888EDF50", true)]
+        [TestCase("85F1FA6D036EE80186A038B0015041EC000000000000000000000CDDA8CA20", false)]
+        [TestCase("8EDECFFE320ECD31B11B944EC0000000000000000000000000000C18A11360", false)]
+        [TestCase("005DE952A37EE80186A0387C37397C31302E33324300376461746366030185", false)]
+        public void Given_KineisData_When_IsFragment_Then_ReturnsFragmentFrames(string rawData, bool expected)
+        {
+            // Arrange
+
+            // Act
+            var result = FragmentReassembly.IsFragment(FrameRecovery.ToBytes(rawData));
+
+            // Assert
+            Assert.That(result, Is.EqualTo(expected));
+
+        }
+
+    }
+}
@@ -0,0 +1,118 @@
+﻿using NUnit.Framework;
+using System.Linq;
+
+namespace Receive.Tests
+{
+    [TestFixture]
+    public class FrameRecoveryTest
+    {
+
+        // Group of 3 packed frames (sequences 4094, 4095 and 0) and its 2 parity frames, encoded by Transmit/msg_kineis_fec.c
+        private static readonly string[] Group =
+        {
+            "5F7FFA6D036EE80186A038BFFE5101EC714500000000000000000D2A51C840",
+            "0A1CFA75036EE80186A038BFFF513FC7BD4600000000000000000BDE207DB0",
+            "BCD2FA7D036EE80186A038B000511FFF9DB6000000000000000008520DA1D0",
+            "78FCCFFE320ECD31B11B944EC000000000000000000D368993F006DB8213D0",
+            "74FDCFFE3216AA93F4B050168000000000000000000D368993F00748665050"
+        };
+
+        [Test]
+        [TestCase(new[] { 0 })]
+        [TestCase(new[] { 1 })]
+        [TestCase(new[] { 2, 3 })]
+        [TestCase(new[] { 0, 2 })]
+        [TestCase(new[] { 1, 4 })]
+        public void Given_LostFrames_When_RecoverFrames_Then_ReturnsSameReadings(int[] lostFrames)
+        {
+            // Arrange
+            var received = Group.Where((frame, index) => !lostFrames.Contains(index)).ToList();
+
+            // Act
+            var result = FrameRecovery.RecoverFrames(received);
+
+            // Assert
+            var lostDataFrames = lostFrames.Where(index => index < 3).ToList();
+            Assert.That(result.Count, Is.EqualTo(lostDataFrames.Count));
+            foreach (var recovered in result.Select(IoTHubData.ParseKineisData))
+            {
+                var expected = lostDataFrames.Select(index => IoTHubData.ParseKineisData(Group[index])).Single(a => a.Id == recovered.Id);
+                Assert.That(recovered.IsValid, Is.True);
+                Assert.That(recovered.Day, Is.EqualTo(expected.Day));
+                Assert.That(recovered.Hour, Is.EqualTo(expected.Hour));
+                Assert.That(recovered.Minute, Is.EqualTo(expected.Minute));
+                Assert.That(recovered.Interval, Is.EqualTo(expected.Interval));
+                Assert.That(recovered.Readings.Select(a => a.Temperature), Is.EqualTo(expected.Readings.Select(a => a.Temperature)));
+            }
+
+        }
+
+        [Test]
+        [TestCase(new[] { 0, 1, 3 })]
+        [TestCase(new[] { 0, 1, 2 })]
+        [TestCase(new[] { 3, 4 })]
+        public void Given_TooFewOrNoLostFrames_When_RecoverFrames_Then_ReturnsNothing(int[] lostFrames)
+        {
+            // Arrange
+            var received = Group.Where((frame, index) => !lostFrames.Contains(index)).ToList();
+
+            // Act
+            var result = FrameRecovery.RecoverFrames(received);
+
+            // Assert
+            Assert.That(result, Is.Empty);
+
+        }
+
+        [Test]
+        public void Given_FrameOfSameSequenceBeforeReset_When_RecoverFrames_Then_RebuildsFrameOfGroup()
+        {
+            // Arrange
+            // Sequence 4094 sent a day before the group, the sequences restarted in between
+            var earlierFrame = "5F7FF96D036EE80186A038BFFE5101EC714500000000000000000D2A51C840";
+            var received = new[] { earlierFrame, Group[1], Group[2], Group[3] };
+
+            // Act
+            var result = FrameRecovery.RecoverFrames(received);
+
+            // Assert
+            Assert.That(result.Count, Is.EqualTo(1));
+            var recovered = IoTHubData.ParseKineisData(result[0]);
+            var expected = IoTHubData.ParseKineisData(Group[0]);
+            Assert.That(recovered.Day, Is.EqualTo(expected.Day));
+            Assert.That(recovered.Readings.Select(a => a.Temperature), Is.EqualTo(expected.Readings.Select(a => a.Temperature)));
+
+        }
+
+        [Test]
+        public void Given_FrameNotOfGroup_When_RecoverFrames_Then_ReturnsNothing()
+        {
+            // Arrange
+            // Sequence 4095 with one reading changed, the frame rebuilt from it would be wrong
+            var otherFrame = "0A1CFA75036EE80186A038BFFF513F47BD4600000000000000000BDE207DB0";
+            var received = new[] { otherFrame, Group[2], Group[3] };
+
+            // Act
+            var result = FrameRecovery.RecoverFrames(received);
+
+            // Assert
+            Assert.That(result, Is.Empty);
+
+        }
+
+        [Test]
+        public void Given_ParityFrame_When_Parse_Then_IsNotValid()
+        {
+            // Arrange
+
+            // Act
+            var result = IoTHubData.ParseKineisData(Group[3]);
+
+            // Assert
+            Assert.That(result.IsPacked, Is.False);
+            Assert.That(result.IsValid, Is.False);
+
+        }
+
+    }
+}
@@ -0,0 +1,66 @@
+﻿using NUnit.Framework;
+using System.Linq;
+
+namespace Receive.Tests
+{
+    [TestFixture]
+    public class ParsePackedReadingsTest
+    {
+
+        // Frames encoded by Transmit/msg_kineis_packed.c, as found in the raw data of Kineis exports
+        [Test]
+        [TestCase("85F1FA6D036EE80186A038B0015041EC000000000000000000000CDDA8CA20", 1, 20, new[] { 12.3 })]
+        [TestCase("782CFA6D036EE80186A038BFFF53C1A45D218709E0F5C7DF7FFFCB8BC5EE20", 4095, 20, new[] { 10.5, 11.0, 9.8, 6.7, 3.6, 2.0, -0.5, -3.7, -4.0, -1.2, 1.9, 5.0, 8.1, 8.0, 7.9 })]
+        [TestCase("6C71FA6D036EE80186A038B04DFCE001F8400000000000000000069030A5C0", 77, 63, new[] { -204.8, -201.7, -204.8 })]
+        [TestCase("E893FA6D036EE80186A038B800049FFE1000000000000000000007EC078540", 2048, 1, new[] { 204.7, 201.6 })]
+        public void Given_PackedKineisData_When_Parse_Then_ReturnsReadings(string stringToParse, int expectedId, int expectedInterval, double[] expectedTemperatures)
+        {
+            // Arrange
+
+            // Act
+            var result = IoTHubData.ParseKineisData(stringToParse);
+
+            // Assert
+            Assert.That(result.IsPacked, Is.True);
+            Assert.That(result.IsValid, Is.True);
+            Assert.That(result.Id, Is.EqualTo(expectedId));
+            Assert.That(result.Interval, Is.EqualTo(expectedInterval));
+            Assert.That(result.Readings.Select(a => a.Temperature), Is.EqualTo(expectedTemperatures).Within(0.001));
+            Assert.That(result.Readings.Select(a => a.MinutesAfterFirst), Is.EqualTo(Enumerable.Range(0, expectedTemperatures.Length).Select(a => a * expectedInterval)));
+            Assert.That(result.Temperature, Is.EqualTo(expectedTemperatures[0]).Within(0.001));
+
+        }
+
+        [Test]
+        [TestCase("85F1FA6D036EE80186A038B0000041EC000000000000000000000CDDA8CA20")]
+        [TestCase("85F1FA6D036EE80186A038B0015001EC000000000000000000000CDDA8CA20")]
+        public void Given_PackedKineisDataWithoutReadings_When_Parse_Then_IsNotValid(string stringToParse)
+        {
+            // Arrange
+
+            // Act
+            var result = IoTHubData.ParseKineisData(stringToParse);
+
+            // Assert
+            Assert.That(result.IsPacked, Is.True);
+            Assert.That(result.IsValid, Is.False);
+
+        }
+
+        [Test]
+        [TestCase("FA63836EE80186A0387C327C31332E39324300000000000000")]
+        public void Given_TextKineisData_When_Parse_Then_IsNotPacked(string stringToParse)
+        {
+            // Arrange
+
+            // Act
+            var result = IoTHubData.ParseKineisData(stringToParse);
+
+            // Assert
+            Assert.That(result.IsPacked, Is.False);
+            Assert.That(result.Readings, Is.Empty);
+
+        }
+
+    }
+}
@@ -0,0 +1,125 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Receive
+{
+    // Puts back together records too long for one frame, sent as fragment frames, see Transmit/msg_kineis_frag.h
+    // The fragments of a record may come in different exports, so they are kept, by record number, until the
+    // record is complete or they expire. Positions are bits in the raw data, which leaves out the 4 bit extension id
+    // The record numbers restart at each reset of the transmitter: a fragment is only taken for a copy of one already
+    // received when its data is the same
+    internal class FragmentReassembly
+    {
+        internal const int FragmentTag = 0xD;
+        private const int TagBit = 16;
+        private const int RecordBit = 20;
+        private const int IndexBit = 28;
+        private const int LastBit = 32;
+        private const int LengthBit = 36;
+        private const int DataBit = 44;
+        private const int DataLength = 21;
+        private const int FrameLength = 31;
+
+        private class PartialRecord
+        {
+            public int Last { get; set; }
+            public DateTime FirstReceived { get; set; }
+            public Dictionary<int, byte[]> Fragments { get; } = new Dictionary<int, byte[]>();
+        }
+
+        private readonly TimeSpan _expiry;
+        private readonly Dictionary<int, PartialRecord> _partialRecords = new Dictionary<int, PartialRecord>();
+        // Records put back together, by number and time of their first fragment, so copies of their fragments received
+        // later do not start them again
+        private readonly Dictionary<(int Record, DateTime FirstReceived), PartialRecord> _completedRecords = new Dictionary<(int Record, DateTime FirstReceived), PartialRecord>();
+        private readonly object _lock = new object();
+
+        internal FragmentReassembly(TimeSpan expiry)
+        {
+            _expiry = expiry;
+        }
+
+        // Records waiting for fragments
+        internal int PartialCount
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _partialRecords.Count;
+                }
+            }
+        }
+
+        internal static bool IsFragment(List<byte> bytes)
+        {
+            return bytes != null && bytes.Count >= FrameLength && IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, TagBit, 4) == FragmentTag;
+        }
+
+        // Adds a fragment frame received at the given time. Returns the record once all its fragments are in,
+        // otherwise null. Records and fragments older than the expiry are dropped first
+        internal byte[] Add(List<byte> bytes, DateTime received)
+        {
+            if (!IsFragment(bytes))
+            {
+                return null;
+            }
+            var record = IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, RecordBit, 8);
+            var index = IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, IndexBit, 4);
+            var last = IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, LastBit, 4);
+            var length = IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, LengthBit, 5);
+            // Only the last fragment of a record is not full
+            if (index > last || length == 0 || length > DataLength || (index < last && length != DataLength))
+            {
+                return null;
+            }
+            var data = new byte[length];
+            for (int i = 0; i < length; i++)
+            {
+                data[i] = (byte)IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, DataBit + i * 8, 8);
+            }
+
+            lock (_lock)
+            {
+                Expire(received);
+                if (_completedRecords.Any(a => a.Key.Record == record && IsCopy(a.Value, index, last, data)))
+                {
+                    return null;
+                }
+                // The record number wraps around: fragments of another length or other data are from a new record
+                if (!_partialRecords.TryGetValue(record, out var partialRecord) || partialRecord.Last != last ||
+                    (partialRecord.Fragments.ContainsKey(index) && !IsCopy(partialRecord, index, last, data)))
+                {
+                    partialRecord = new PartialRecord { Last = last, FirstReceived = received };
+                    _partialRecords[record] = partialRecord;
+                }
+                partialRecord.Fragments[index] = data;
+                if (partialRecord.Fragments.Count <= last)
+                {
+                    return null;
+                }
+                _partialRecords.Remove(record);
+                _completedRecords[(record, partialRecord.FirstReceived)] = partialRecord;
+                return Enumerable.Range(0, last + 1).SelectMany(a => partialRecord.Fragments[a]).ToArray();
+            }
+        }
+
+        private static bool IsCopy(PartialRecord record, int index, int last, byte[] data)
+        {
+            return record.Last == last && record.Fragments.TryGetValue(index, out var fragment) && fragment.SequenceEqual(data);
+        }
+
+        private void Expire(DateTime now)
+        {
+            foreach (var record in _partialRecords.Where(a => now - a.Value.FirstReceived > _expiry).Select(a => a.Key).ToList())
+            {
+                _partialRecords.Remove(record);
+            }
+            foreach (var record in _completedRecords.Where(a => now - a.Key.FirstReceived > _expiry).Select(a => a.Key).ToList())
+            {
+                _completedRecords.Remove(record);
+            }
+        }
+    }
+}
@@ -0,0 +1,307 @@
+﻿using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+
+namespace Receive
+{
+    // Rebuilds packed frames lost on the way from the parity frames sent after them, see Transmit/msg_kineis_fec.h
+    // Positions are bits in the raw data, which leaves out the 4 bit extension id starting the frame
+    // The sequences restart at each reset of the transmitter: a group is matched to the data frames by the date of its
+    // first frame as well, and the frames rebuilt are dropped unless the group passes the check of its parity frames
+    internal static class FrameRecovery
+    {
+        internal const int ParityTag = 0xC;
+        private const int SymbolLength = 16;
+        private const int FirstDataPoint = 16;
+        private const int SequenceModulo = 4096;
+        // Dates are a day of the month, hour and minute. The data frames of a group follow its first one within the window
+        private const int MinutesPerDay = 24 * 60;
+        private const int DateModulo = 32 * MinutesPerDay;
+        private const int GroupWindow = 4 * MinutesPerDay;
+
+        // Data frames: acquisition period, date, then the packed user data
+        private const int AcquisitionPeriodBit = 16;
+        private const int DateBit = 19;
+        private const int DateBits = 16;
+        private const int LocationBit = 35;
+        private const int LocationBits = 53;
+        private const int PackedTagBit = 88;
+        private const int SequenceBit = 92;
+        private const int ProtectedBit = 104;
+        private const int ProtectedBits = 108;
+        private const int FrameLength = 31;
+
+        // Parity frames
+        private const int ParityTagBit = 16;
+        private const int FirstSequenceBit = 20;
+        private const int DataCountBit = 32;
+        private const int IndexBit = 40;
+        private const int ParityBit = 44;
+        private const int GroupDateBit = ParityBit + SymbolLength * 8;
+        private const int CheckBit = GroupDateBit + DateBits;
+
+        internal static List<string> RecoverFrames(IEnumerable<string> rawData)
+        {
+            var dataFrames = new Dictionary<int, List<List<byte>>>();
+            var parityFrames = new Dictionary<(int FirstSequence, int DataCount, int Date, int Check), Dictionary<int, byte[]>>();
+            foreach (var raw in rawData)
+            {
+                var bytes = ToBytes(raw);
+                if (bytes == null || bytes.Count < FrameLength)
+                {
+                    continue;
+                }
+                if (IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, ParityTagBit, 4) == ParityTag)
+                {
+                    var key = (IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, FirstSequenceBit, 12), IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, DataCountBit, 4),
+                        IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, GroupDateBit, DateBits), IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, CheckBit, 16));
+                    if (!parityFrames.ContainsKey(key))
+                    {
+                        parityFrames[key] = new Dictionary<int, byte[]>();
+                    }
+                    parityFrames[key][IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, IndexBit, 4)] = GetBytes(bytes, ParityBit, SymbolLength * 8);
+                }
+                else if (IoTHubData.IsPackedFrame(bytes))
+                {
+                    var sequence = IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, SequenceBit, 12);
+                    if (!dataFrames.ContainsKey(sequence))
+                    {
+                        dataFrames[sequence] = new List<List<byte>>();
+                    }
+                    dataFrames[sequence].Add(bytes);
+                }
+            }
+
+            var recovered = new List<string>();
+            foreach (var group in parityFrames)
+            {
+                var sequences = Enumerable.Range(0, group.Key.DataCount).Select(index => (group.Key.FirstSequence + index) % SequenceModulo).ToList();
+                var frames = Enumerable.Range(0, group.Key.DataCount).Select(index => FindFrame(dataFrames, sequences[index], group.Key.Date, index == 0)).ToList();
+                var missing = Enumerable.Range(0, group.Key.DataCount).Where(index => frames[index] == null).ToList();
+                if (missing.Count == 0 || missing.Count > group.Value.Count)
+                {
+                    continue;
+                }
+                // The location is not protected, it is the same for all the frames of a device
+                var location = frames.Where(frame => frame != null).Select(frame => GetBytes(frame, LocationBit, LocationBits)).FirstOrDefault();
+                var dataSymbols = frames.Select(frame => frame != null ? GetSymbol(frame) : null).ToList();
+                var symbols = Solve(group.Value.Take(missing.Count).ToList(), missing, dataSymbols);
+                for (int index = 0; index < missing.Count; index++)
+                {
+                    dataSymbols[missing[index]] = symbols[index];
+                }
+                if (Crc16(dataSymbols) != group.Key.Check)
+                {
+                    continue;
+                }
+                recovered.AddRange(missing.Select(index => ToRawData(sequences[index], dataSymbols[index], location)));
+            }
+            return recovered;
+        }
+
+        // Data frame of a sequence sent in the group starting at groupDate: the first frame of the group has its date, the
+        // others the nearest date after it, within the window
+        private static List<byte> FindFrame(Dictionary<int, List<List<byte>>> dataFrames, int sequence, int groupDate, bool isFirst)
+        {
+            if (!dataFrames.TryGetValue(sequence, out var candidates))
+            {
+                return null;
+            }
+            var groupMinutes = DateMinutes(groupDate);
+            return candidates
+                .Select(frame => (Frame: frame, After: (DateMinutes(IoTHubData.ExtractNumberFromBitsMsbFirst(frame, DateBit, DateBits)) - groupMinutes + DateModulo) % DateModulo))
+                .Where(candidate => isFirst ? candidate.After == 0 : candidate.After <= GroupWindow)
+                .OrderBy(candidate => candidate.After)
+                .Select(candidate => candidate.Frame)
+                .FirstOrDefault();
+        }
+
+        // Day, Hour and Minute fields to minutes since the start of the month
+        private static int DateMinutes(int date)
+        {
+            return (date >> 11) * MinutesPerDay + ((date >> 6) & 0x1F) * 60 + (date & 0x3F);
+        }
+
+        // CRC16 of the symbols of a group, polynomial 0x1021 from 0 as for the CRC16 of a frame
+        private static int Crc16(List<byte[]> symbols)
+        {
+            var crc = 0;
+            foreach (var value in symbols.SelectMany(symbol => symbol))
+            {
+                crc ^= value << 8;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    crc = (crc & 0x8000) != 0 ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+                }
+            }
+            return crc;
+        }
+
+        // Parity frame j is the sum of the data symbols i times 1 / (j xor (16 + i)): remove the symbols received,
+        // which leaves as many equations as symbols missing
+        private static List<byte[]> Solve(List<KeyValuePair<int, byte[]>> parities, List<int> missing, List<byte[]> symbols)
+        {
+            var size = missing.Count;
+            var matrix = new byte[size, size];
+            var values = new byte[size][];
+            for (int row = 0; row < size; row++)
+            {
+                var parityIndex = parities[row].Key;
+                values[row] = (byte[])parities[row].Value.Clone();
+                for (int index = 0; index < symbols.Count; index++)
+                {
+                    if (symbols[index] != null)
+                    {
+                        AddProduct(values[row], Coefficient(parityIndex, index), symbols[index]);
+                    }
+                }
+                for (int column = 0; column < size; column++)
+                {
+                    matrix[row, column] = Coefficient(parityIndex, missing[column]);
+                }
+            }
+            // Gauss-Jordan elimination, any square part of a Cauchy matrix can be inverted
+            for (int column = 0; column < size; column++)
+            {
+                var pivot = Enumerable.Range(column, size - column).First(row => matrix[row, column] != 0);
+                if (pivot != column)
+                {
+                    for (int index = 0; index < size; index++)
+                    {
+                        (matrix[pivot, index], matrix[column, index]) = (matrix[column, index], matrix[pivot, index]);
+                    }
+                    (values[pivot], values[column]) = (values[column], values[pivot]);
+                }
+                var inverse = Inverse(matrix[column, column]);
+                for (int index = 0; index < size; index++)
+                {
+                    matrix[column, index] = Multiply(matrix[column, index], inverse);
+                }
+                values[column] = values[column].Select(value => Multiply(value, inverse)).ToArray();
+                for (int row = 0; row < size; row++)
+                {
+                    var factor = matrix[row, column];
+                    if (row == column || factor == 0)
+                    {
+                        continue;
+                    }
+                    for (int index = 0; index < size; index++)
+                    {
+                        matrix[row, index] ^= Multiply(factor, matrix[column, index]);
+                    }
+                    AddProduct(values[row], factor, values[column]);
+                }
+            }
+            return values.ToList();
+        }
+
+        private static byte Coefficient(int parityIndex, int dataIndex)
+        {
+            return Inverse((byte)(parityIndex ^ (FirstDataPoint + dataIndex)));
+        }
+
+        private static void AddProduct(byte[] target, byte factor, byte[] symbol)
+        {
+            for (int index = 0; index < target.Length; index++)
+            {
+                target[index] ^= Multiply(factor, symbol[index]);
+            }
+        }
+
+        // GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1
+        internal static byte Multiply(byte a, byte b)
+        {
+            var product = 0;
+            int left = a;
+            for (int right = b; right != 0; right >>= 1)
+            {
+                if ((right & 1) != 0)
+                {
+                    product ^= left;
+                }
+                left = (left << 1) ^ ((left & 0x80) != 0 ? 0x11D : 0);
+            }
+            return (byte)product;
+        }
+
+        internal static byte Inverse(byte a)
+        {
+            // a^254
+            byte square = a;
+            byte inverse = 1;
+            for (int bit = 1; bit < 8; bit++)
+            {
+                square = Multiply(square, square);
+                inverse = Multiply(inverse, square);
+            }
+            return inverse;
+        }
+
+        private static byte[] GetSymbol(List<byte> bytes)
+        {
+            var symbol = new byte[SymbolLength];
+            SetBits(symbol, 0, DateBits, GetBytes(bytes, DateBit, DateBits));
+            SetBits(symbol, DateBits, ProtectedBits, GetBytes(bytes, ProtectedBit, ProtectedBits));
+            return symbol;
+        }
+
+        // Raw data of a packed frame from its sequence, symbol and location if known, without CRC16 or BCH32
+        private static string ToRawData(int sequence, byte[] symbol, byte[] location)
+        {
+            var frame = new byte[FrameLength];
+            SetBits(frame, AcquisitionPeriodBit, 3, new[] { (byte)(IoTHubData.UserMessage << 5) });
+            SetBits(frame, DateBit, DateBits, GetBytes(symbol.ToList(), 0, DateBits));
+            if (location != null)
+            {
+                SetBits(frame, LocationBit, LocationBits, location);
+            }
+            SetBits(frame, PackedTagBit, 4, new[] { (byte)(IoTHubData.PackedTag << 4) });
+            SetBits(frame, SequenceBit, 12, new[] { (byte)(sequence >> 4), (byte)(sequence << 4) });
+            SetBits(frame, ProtectedBit, ProtectedBits, GetBytes(symbol.ToList(), DateBits, ProtectedBits));
+            return string.Concat(frame.Select(value => value.ToString("X2")));
+        }
+
+        // Bits from startBit, left aligned in bytes
+        private static byte[] GetBytes(List<byte> bytes, int startBit, int numberOfBits)
+        {
+            var result = new byte[(numberOfBits + 7) / 8];
+            for (int bit = 0; bit < numberOfBits; bit++)
+            {
+                if (IoTHubData.ExtractNumberFromBitsMsbFirst(bytes, startBit + bit, 1) != 0)
+                {
+                    result[bit / 8] |= (byte)(0x80 >> (bit % 8));
+                }
+            }
+            return result;
+        }
+
+        private static void SetBits(byte[] target, int startBit, int numberOfBits, byte[] source)
+        {
+            for (int bit = 0; bit < numberOfBits; bit++)
+            {
+                if ((source[bit / 8] & (0x80 >> (bit % 8))) != 0)
+                {
+                    target[(startBit + bit) / 8] |= (byte)(0x80 >> ((startBit + bit) % 8));
+                }
+            }
+        }
+
+        internal static List<byte> ToBytes(string raw)
+        {
+            if (string.IsNullOrEmpty(raw) || raw.Length % 2 != 0)
+            {
+                return null;
+            }
+            var bytes = new List<byte>();
+            for (int i = 0; i < raw.Length; i = i + 2)
+            {
+                if (!byte.TryParse(raw.Substring(i, 2), NumberStyles.HexNumber, CultureInfo.InvariantCulture, out var value))
+                {
+                    return null;
+                }
+                bytes.Add(value);
+            }
+            return bytes;
+        }
+    }
+}
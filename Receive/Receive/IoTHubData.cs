@@ -23,6 +23,8 @@ namespace Receive
 
     public static class IoTHubData
     {
+        // Fragments of long records waiting for the others, kept while the function app stays loaded
+        private static readonly FragmentReassembly Fragments = new FragmentReassembly(TimeSpan.FromDays(1));
 
         [FunctionName("IoTHubData")]
         public static async Task Run(
@@ -48,50 +50,78 @@ namespace Receive
             }
 
             // Unpack and interpret kineis data package
+            var rawDataList = new List<string>();
             if (payload.StartsWith("DEVICE_ID"))
             {
                 // CSV Format
                 var kineisData = ParseKineisCsv(payload);
-                foreach (var csvLine in kineisData)
-                {
-                    var parsedData = ParseKineisData(csvLine.RawSensorData);
-                    log.LogInformation($"Received raw data {csvLine.RawSensorData} which converted to {parsedData.Converted}, Id: {parsedData.Id}, Temperature: {parsedData.Temperature}, IsValid: {parsedData.IsValid}");
-                    if (parsedData.IsValid)
-                    {
-                        // Store business data to azure table storage
-                        try
-                        {
-                            outputTable.Add(new TelemetryOutput { PartitionKey = "Temperature3e", RowKey = parsedData.Id.ToString(), Message = parsedData.Temperature.ToString() });
-                        }
-                        catch (Exception exception)
-                        {
-                            log.LogWarning(exception, "Failed to save temperature reading. Does rowid already exist?");
-                        }
-                    }
-                }
+                rawDataList.AddRange(kineisData.Select(csvLine => csvLine.RawSensorData));
             }
             else
             {
                 // JSON Format
                 var result = JsonSerializer.Deserialize<KineisRoot>(payload);
-                foreach (var data in result.Data)
+                // Deal with both types of schema with varying locations of raw data
+                rawDataList.AddRange(result.Data.Select(data => data.Sensors != null ? data.Sensors.RawData : data.RawData));
+            }
+
+            // Rebuild the frames lost from their parity frames
+            var recoveredData = FrameRecovery.RecoverFrames(rawDataList);
+            foreach (var rawData in recoveredData)
+            {
+                log.LogInformation($"Recovered raw data {rawData} from parity frames");
+            }
+            rawDataList.AddRange(recoveredData);
+
+            foreach (var rawData in rawDataList)
+            {
+                var bytes = FrameRecovery.ToBytes(rawData);
+                if (FragmentReassembly.IsFragment(bytes))
                 {
-                    // Deal with both types of schema with varying locations of raw data
-                    var rawData = data.Sensors != null ? data.Sensors.RawData : data.RawData;
-                    var parsedData = ParseKineisData(rawData);
-                    log.LogInformation($"Received raw data {rawData} which converted to {parsedData.Converted}, Id: {parsedData.Id}, Temperature: {parsedData.Temperature}, IsValid: {parsedData.IsValid}");
-                    if (parsedData.IsValid)
+                    var record = Fragments.Add(bytes, DateTime.UtcNow);
+                    if (record == null)
                     {
-                        // Store business data to azure table storage
-                        try
-                        {
-                            outputTable.Add(new TelemetryOutput { PartitionKey = "Temperature3e", RowKey = parsedData.Id.ToString(), Message = parsedData.Temperature.ToString() });
-                        }
-                        catch (Exception exception)
-                        {
-                            log.LogWarning(exception, "Failed to save temperature reading. Does rowid already exist?");
-                        }
+                        log.LogInformation($"Received raw data {rawData} which is a fragment of a record, {Fragments.PartialCount} records incomplete");
+                        continue;
+                    }
+                    var parsedRecord = ParseKineisRecord(record);
+                    log.LogInformation($"Received raw data {rawData} which completed record {parsedRecord.Converted}, Id: {parsedRecord.Id}, Temperature: {parsedRecord.Temperature}, IsValid: {parsedRecord.IsValid}");
+                    if (parsedRecord.IsValid)
+                    {
+                        StoreTemperatures(outputTable, parsedRecord, log);
                     }
+                    continue;
+                }
+                var parsedData = ParseKineisData(rawData);
+                log.LogInformation($"Received raw data {rawData} which converted to {parsedData.Converted}, Id: {parsedData.Id}, Temperature: {parsedData.Temperature}, IsValid: {parsedData.IsValid}");
+                if (parsedData.IsValid)
+                {
+                    // Store business data to azure table storage
+                    StoreTemperatures(outputTable, parsedData, log);
+                }
+            }
+        }
+
+        private static void StoreTemperatures(ICollector<TelemetryOutput> outputTable, TelemetryResult parsedData, ILogger log)
+        {
+            var outputs = new List<TelemetryOutput>();
+            if (parsedData.IsPacked)
+            {
+                outputs.AddRange(parsedData.Readings.Select(reading => new TelemetryOutput { PartitionKey = "Temperature3e", RowKey = $"{parsedData.Id}-{reading.Index}", Message = reading.Temperature.ToString() }));
+            }
+            else
+            {
+                outputs.Add(new TelemetryOutput { PartitionKey = "Temperature3e", RowKey = parsedData.Id.ToString(), Message = parsedData.Temperature.ToString() });
+            }
+            foreach (var output in outputs)
+            {
+                try
+                {
+                    outputTable.Add(output);
+                }
+                catch (Exception exception)
+                {
+                    log.LogWarning(exception, "Failed to save temperature reading. Does rowid already exist?");
                 }
             }
         }
@@ -113,18 +143,18 @@ namespace Receive
             // Convert to chars from 24 175 234 to ascii characters
             var convertedString = string.Join("", bytes.Select(a => (char)a));
 
-            // TODO: Deal with rubbish data coming through
-            // Extra user data in format |45|14.6C (ID = 45, Temperature = 14.6C
-            var match = Regex.Match(convertedString, @"\|([0-9]{1,3})\|([0-9.]{1,5})C");
             var result = new TelemetryResult
             {
                 Converted = convertedString
             };
 
-            if (match.Groups.Count == 3)
+            if (IsPackedFrame(bytes))
             {
-                result.Id = int.Parse(match.Groups[1].Value);
-                result.Temperature = double.Parse(match.Groups[2].Value);
+                ParsePackedReadings(bytes, result);
+            }
+            else
+            {
+                ParseTextReading(convertedString, result);
             }
             // TODO: Extract day and time:
             // Skip 23 bits
@@ -137,6 +167,85 @@ namespace Receive
             return result;
         }
 
+        // Text reading of a record put back together from its fragments, which carry no date
+        internal static TelemetryResult ParseKineisRecord(byte[] record)
+        {
+            var result = new TelemetryResult
+            {
+                Converted = string.Join("", record.Select(a => (char)a))
+            };
+            ParseTextReading(result.Converted, result);
+            return result;
+        }
+
+        private static void ParseTextReading(string convertedString, TelemetryResult result)
+        {
+            // TODO: Deal with rubbish data coming through
+            // Extra user data in format |45|14.6C (ID = 45, Temperature = 14.6C
+            var match = Regex.Match(convertedString, @"\|([0-9]{1,3})\|([0-9.]{1,5})C");
+            if (match.Groups.Count == 3)
+            {
+                result.Id = int.Parse(match.Groups[1].Value);
+                result.Temperature = double.Parse(match.Groups[2].Value);
+            }
+        }
+
+        // Packed readings, see Transmit/msg_kineis_packed.h. The raw data leaves out the 4 bit extension id which
+        // starts the frame, so the user data starts at byte 11, where the text readings are found
+        internal const int UserDataOffset = 11;
+        internal const int PackedTag = 0xB;
+        internal const int UserMessage = 0b111;
+
+        // Packed frames are "position and user data" frames, with the acquisition period of a user message. Frames
+        // in the "user data only" format, as the parity frames, start their user data there instead
+        internal static bool IsPackedFrame(List<byte> bytes)
+        {
+            return bytes.Count > UserDataOffset && bytes[2] >> 5 == UserMessage && bytes[UserDataOffset] >> 4 == PackedTag;
+        }
+
+        internal static void ParsePackedReadings(List<byte> bytes, TelemetryResult result)
+        {
+            var start = UserDataOffset * 8;
+            if (bytes.Count < UserDataOffset + 16)
+            {
+                return;
+            }
+            var count = ExtractNumberFromBitsMsbFirst(bytes, start + 22, 4);
+            result.IsPacked = true;
+            result.Id = ExtractNumberFromBitsMsbFirst(bytes, start + 4, 12);
+            result.Interval = ExtractNumberFromBitsMsbFirst(bytes, start + 16, 6);
+            if (count == 0 || result.Interval == 0)
+            {
+                return;
+            }
+            // First reading on 12 bits then the difference to the previous one on 6 bits, signed in tenths of a degree
+            var tenths = ToSigned(ExtractNumberFromBitsMsbFirst(bytes, start + 26, 12), 12);
+            for (int index = 0; index < count; index++)
+            {
+                if (index > 0)
+                {
+                    tenths += ToSigned(ExtractNumberFromBitsMsbFirst(bytes, start + 38 + (index - 1) * 6, 6), 6);
+                }
+                result.Readings.Add(new TemperatureReading { Index = index, MinutesAfterFirst = index * result.Interval, Temperature = tenths / 10.0 });
+            }
+            result.Temperature = result.Readings[0].Temperature;
+        }
+
+        internal static int ExtractNumberFromBitsMsbFirst(List<byte> bytes, int startBit, int numberOfBits)
+        {
+            var result = 0;
+            for (int i = startBit; i < startBit + numberOfBits; i++)
+            {
+                result = (result << 1) | ((bytes[i / 8] >> (7 - i % 8)) & 0x01);
+            }
+            return result;
+        }
+
+        private static int ToSigned(int value, int numberOfBits)
+        {
+            return value >= 1 << (numberOfBits - 1) ? value - (1 << numberOfBits) : value;
+        }
+
         internal static byte ExtractNumberFromBits(List<byte> bytes, int startBit, int numberOfBits)
         {
             var bitArray = bytes.ToBitArray(bytes.Count * 8);
@@ -1,4 +1,6 @@
-﻿namespace Receive.Models
+﻿using System.Collections.Generic;
+
+namespace Receive.Models
 {
     public class TelemetryResult
     {
@@ -8,6 +10,10 @@
         public byte Day { get; set; }
         public byte Hour { get; set; }
         public byte Minute { get; set; }
-        public bool IsValid => Id != 0 && Temperature > 0;
+        // Several readings packed in binary, Id is the frame number and Temperature the first reading
+        public bool IsPacked { get; set; }
+        public int Interval { get; set; }
+        public List<TemperatureReading> Readings { get; set; } = new List<TemperatureReading>();
+        public bool IsValid => IsPacked ? Readings.Count > 0 : Id != 0 && Temperature > 0;
     }
 }
@@ -0,0 +1,9 @@
+﻿namespace Receive.Models
+{
+    public class TemperatureReading
+    {
+        public int Index { get; set; }
+        public int MinutesAfterFirst { get; set; }
+        public double Temperature { get; set; }
+    }
+}
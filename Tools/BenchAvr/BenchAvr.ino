@@ -0,0 +1,82 @@
+/*
+  Device benchmark of the Kineis codec: the cases of Tools/bench_codec_cases.h, timed in CPU
+  cycles per frame on the board, over realistic and random frames. The output is the JSON of
+  Tools/bench_codec.c, with cycles in place of nanoseconds, so host and device runs compare case
+  by case.
+
+  Copy the codec into the sketch folder first (from the repository root):
+    make -C Tools bench_avr_sources
+  then build and upload the sketch and save its serial output (115200 baud).
+*/
+
+#include "bench_codec_cases.h"
+
+#define FRAME_SET_SIZE 8
+#define FRAMES_PER_CASE 512
+
+ArgosMsgTypeDef_t frames[FRAME_SET_SIZE];
+volatile uint32_t sink;
+
+// Loop and call overhead, taken off every case
+static uint32_t benchEmpty(ArgosMsgTypeDef_t *frame) {
+  return frame->payload[0];
+}
+
+uint32_t cycles(uint32_t (*run)(ArgosMsgTypeDef_t *frame), uint16_t count) {
+  uint32_t acc = 0;
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < count; i++) {
+    acc ^= run(&frames[i % FRAME_SET_SIZE]);
+  }
+  unsigned long elapsed = micros() - start;
+  sink = acc;
+  return elapsed * clockCyclesPerMicrosecond();
+}
+
+void benchPayload(const char *payload, bool &first) {
+  uint32_t overhead = cycles(benchEmpty, FRAMES_PER_CASE);
+  for (uint8_t i = 0; i < CODEC_BENCH_CASE_COUNT; i++) {
+    // The bit-wise checksums are an order of magnitude slower
+    uint16_t count = strstr(codecBenchCases[i].name, "bitwise") != NULL ? FRAMES_PER_CASE / 8 : FRAMES_PER_CASE;
+    uint32_t total = cycles(codecBenchCases[i].run, count);
+    uint32_t overheadPart = overhead / (FRAMES_PER_CASE / count);
+    Serial.print(first ? F("\n") : F(",\n"));
+    Serial.print(F("    {\"name\": \""));
+    Serial.print(codecBenchCases[i].name);
+    Serial.print(F("\", \"payload\": \""));
+    Serial.print(payload);
+    Serial.print(F("\", \"cycles_per_frame\": "));
+    Serial.print((double)(total > overheadPart ? total - overheadPart : 0) / count, 1);
+    Serial.print(F("}"));
+    first = false;
+  }
+}
+
+void setup() {
+  bool first = true;
+
+  Serial.begin(115200);
+  while (!Serial) {
+    delay(10);
+  }
+  srand(1);
+  vCodecBenchInit();
+
+  Serial.print(F("{\n  \"benchmark\": \"bench_codec\",\n  \"platform\": \"avr\",\n  \"f_cpu\": "));
+  Serial.print(F_CPU);
+  Serial.print(F(",\n  \"frames_per_case\": "));
+  Serial.print(FRAMES_PER_CASE);
+  Serial.print(F(",\n  \"unit\": \"cycles_per_frame\",\n  \"results\": ["));
+  for (uint8_t i = 0; i < FRAME_SET_SIZE; i++) {
+    vCodecBenchRealisticFrame(&frames[i], i);
+  }
+  benchPayload("realistic", first);
+  for (uint8_t i = 0; i < FRAME_SET_SIZE; i++) {
+    vCodecBenchRandomFrame(&frames[i]);
+  }
+  benchPayload("random", first);
+  Serial.println(F("\n  ]\n}"));
+}
+
+void loop() {
+}
@@ -0,0 +1,190 @@
+/*
+  Host benchmark of the Kineis codec of the transmitter (msg_kineis_std and msg_kineis_utils).
+
+  Times the field setters at every bit alignment, the user data, location and CRC16/BCH32
+  setters, the hex encoder and the raw CRC16/BCH32 functions, in ns per frame, over realistic
+  frames (built as the transmitter builds them) and random ones. Results are written as JSON so
+  runs can be compared across changes, the cases are those of bench_codec_cases.h which
+  BenchAvr/BenchAvr.ino times in cycles on the device. The hex decoders of the ground side, scalar
+  and SSE2 (msg_kineis_hex_sse), are timed on the host only, after checking they agree, as are the
+  checks of whole messages and of messages received in pieces.
+
+  Build (from the repository root):
+    make -C Tools bench_codec
+  Run:
+    Tools/build/bench_codec [frames per case] > bench.json
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_codec_cases.h"
+#include "msg_kineis_hex_sse.h"
+#include "msg_kineis_std_decode.h"
+
+#define FRAME_SET_SIZE 4096
+
+static ArgosMsgTypeDef_t frames[FRAME_SET_SIZE];
+// Hex text of the frames, decoded by the host cases
+static char hexFrames[FRAME_SET_SIZE][ARGOS_FRAME_HEX_LENGTH + 1];
+
+static uint32_t benchFromHexScalar(ArgosMsgTypeDef_t *frame) {
+  ArgosMsgTypeDef_t decoded;
+  bMSGKINEIS_STDV1_fromHex(hexFrames[frame - frames], ARGOS_FRAME_HEX_LENGTH, &decoded);
+  return decoded.payload[ARGOS_FRAME_LENGTH - 1];
+}
+
+static uint32_t benchFromHexSse2(ArgosMsgTypeDef_t *frame) {
+  ArgosMsgTypeDef_t decoded;
+  bMSG_KINEIS_HEX_fromHex(hexFrames[frame - frames], ARGOS_FRAME_HEX_LENGTH, &decoded);
+  return decoded.payload[ARGOS_FRAME_LENGTH - 1];
+}
+
+static uint32_t benchVerifyWhole(ArgosMsgTypeDef_t *frame) {
+  return bMSGKINEIS_STDV1_checkCRC16(frame) + bMSGKINEIS_STDV1_checkBCH32(frame);
+}
+
+// The message in the 3 pieces of about 10 bytes it could arrive in
+static uint32_t benchVerifyStream(ArgosMsgTypeDef_t *frame) {
+  ArgosMsgVerifierTypeDef_t verifier;
+  bool crcOk, bchOk;
+  vMSGKINEIS_STDV1_initVerifier(&verifier);
+  u16MSGKINEIS_STDV1_updateVerifier(&verifier, frame->payload, 80);
+  u16MSGKINEIS_STDV1_updateVerifier(&verifier, frame->payload + 10, 80);
+  u16MSGKINEIS_STDV1_updateVerifier(&verifier, frame->payload + 20, 88);
+  bMSGKINEIS_STDV1_finalVerifier(&verifier, &crcOk, &bchOk);
+  return crcOk + bchOk;
+}
+
+static const CodecBenchCase hostBenchCases[] = {
+  { "fromHex/scalar", benchFromHexScalar },
+  { "fromHex/sse2", benchFromHexSse2 },
+  { "verify/whole", benchVerifyWhole },
+  { "verify/stream", benchVerifyStream },
+};
+
+static double nowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Best of 3 runs, to leave out the runs disturbed by other processes
+static double nsPerFrame(const CodecBenchCase *benchCase, long count) {
+  volatile uint32_t sink = 0;
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    uint32_t acc = 0;
+    double start = nowSeconds();
+    for (long i = 0; i < count; i++) {
+      acc ^= benchCase->run(&frames[i % FRAME_SET_SIZE]);
+    }
+    double elapsed = (nowSeconds() - start) * 1e9 / count;
+    sink ^= acc;
+    if (run == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  (void)sink;
+  return best;
+}
+
+// Both decoders on every length and on every character in every position, upper and lower case
+static bool hexDecodersAgree(void) {
+  char hex[ARGOS_FRAME_HEX_LENGTH + 1];
+  ArgosMsgTypeDef_t scalar, sse2;
+  int length, position, c;
+
+  for (length = 0; length <= ARGOS_FRAME_HEX_LENGTH + 1; length++) {
+    for (position = 0; position < length; position++) {
+      for (c = 0; c < 256; c++) {
+        memcpy(hex, hexFrames[length], sizeof(hex));
+        hex[position] = (char)c;
+        bool scalarValid = bMSGKINEIS_STDV1_fromHex(hex, length, &scalar);
+        if (scalarValid != bMSG_KINEIS_HEX_fromHex(hex, length, &sse2) ||
+            (scalarValid && memcmp(scalar.payload, sse2.payload, ARGOS_FRAME_LENGTH) != 0)) {
+          fprintf(stderr, "hex decoders differ: length %d, character %d at %d\n", length, c, position);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Both encoders of a "user data only" message on every frame of the set, as user data
+static bool encodersAgree(void) {
+  ArgosMsgTypeDef_t setters, writer;
+
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    memcpy(benchUserData, frames[i].payload, USER_DATA_LENGTH);
+    benchEncodeUserDataOnlySetters(&setters);
+    benchEncodeUserDataOnlyFrameWriter(&writer);
+    if (memcmp(setters.payload, writer.payload, ARGOS_FRAME_LENGTH) != 0) {
+      fprintf(stderr, "encoders differ on frame %d\n", i);
+      return false;
+    }
+  }
+  vCodecBenchInit();
+  return true;
+}
+
+static void benchCases(const CodecBenchCase *cases, size_t caseCount, const char *payload, long count, bool *first) {
+  for (size_t i = 0; i < caseCount; i++) {
+    const CodecBenchCase *benchCase = &cases[i];
+    // The bit-wise checksums are an order of magnitude slower
+    long caseCount = strstr(benchCase->name, "bitwise") != NULL ? count / 10 : count;
+    printf("%s\n    {\"name\": \"%s\", \"payload\": \"%s\", \"ns_per_frame\": %.2f}", *first ? "" : ",",
+      benchCase->name, payload, nsPerFrame(benchCase, caseCount));
+    *first = false;
+  }
+}
+
+static void benchPayload(const char *payload, long count, bool *first) {
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    vMSGKINEIS_STDV1_toHex(&frames[i], hexFrames[i]);
+  }
+  benchCases(codecBenchCases, CODEC_BENCH_CASE_COUNT, payload, count, first);
+  benchCases(hostBenchCases, sizeof(hostBenchCases) / sizeof(hostBenchCases[0]), payload, count, first);
+}
+
+int main(int argc, char *argv[]) {
+  long count = argc > 1 ? atol(argv[1]) : 1000000;
+  bool first = true;
+
+  if (count <= 0) {
+    fprintf(stderr, "usage: %s [frames per case]\n", argv[0]);
+    return 1;
+  }
+  srand(1);
+  vCodecBenchInit();
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+  vMSG_KINEIS_UTILS_initSlice8();
+#endif
+
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    vCodecBenchRandomFrame(&frames[i]);
+    vMSGKINEIS_STDV1_toHex(&frames[i], hexFrames[i]);
+  }
+  if (!hexDecodersAgree() || !encodersAgree()) {
+    return 1;
+  }
+
+  printf("{\n  \"benchmark\": \"bench_codec\",\n  \"platform\": \"host\",\n");
+#ifdef __VERSION__
+  printf("  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+  printf("  \"frames_per_case\": %ld,\n  \"unit\": \"ns_per_frame\",\n  \"results\": [", count);
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    vCodecBenchRealisticFrame(&frames[i], (uint16_t)i);
+  }
+  benchPayload("realistic", count, &first);
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    vCodecBenchRandomFrame(&frames[i]);
+  }
+  benchPayload("random", count, &first);
+  printf("\n  ]\n}\n");
+  return 0;
+}
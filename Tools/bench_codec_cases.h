@@ -0,0 +1,154 @@
+/*
+  Cases of the Kineis codec benchmark, shared by the host benchmark (bench_codec.c) and the
+  device one (BenchAvr/BenchAvr.ino) so both report the same names.
+
+  Each case encodes or checks one frame of a set. Frames are either realistic, built as the
+  transmitter builds them (a position and packed readings), or random bytes.
+*/
+#ifndef BENCH_CODEC_CASES_H
+#define BENCH_CODEC_CASES_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "msg_kineis_packed.h"
+#include "msg_kineis_std.h"
+#include "msg_kineis_utils.h"
+
+#define BENCH_CRC16_LENGTH_BIT (ARGOS_FRAME_LENGTH_BIT - 16 - 32)
+#define BENCH_BCH32_LENGTH_BIT (ARGOS_FRAME_LENGTH_BIT - 32)
+// Fields written at every bit alignment, from this byte
+#define BENCH_FIELD_BYTE 3
+
+typedef struct {
+  const char *name;
+  uint32_t (*run)(ArgosMsgTypeDef_t *frame);
+} CodecBenchCase;
+
+// Same user data for every frame, so the cases only time the codec
+static uint8_t benchUserData[USER_DATA_LENGTH];
+
+#define BENCH_SET_VALUE(alignment, width) \
+  static uint32_t benchSetValue##alignment##_##width(ArgosMsgTypeDef_t *frame) { \
+    return u16MSGKINEIS_STDV1_setValue(frame, frame->payload[0], BENCH_FIELD_BYTE * 8 + alignment, width); \
+  }
+#define BENCH_SET_VALUE_WIDTH(width) \
+  BENCH_SET_VALUE(0, width) BENCH_SET_VALUE(1, width) BENCH_SET_VALUE(2, width) BENCH_SET_VALUE(3, width) \
+  BENCH_SET_VALUE(4, width) BENCH_SET_VALUE(5, width) BENCH_SET_VALUE(6, width) BENCH_SET_VALUE(7, width)
+
+// Minute, crc16 and longitude widths
+BENCH_SET_VALUE_WIDTH(6)
+BENCH_SET_VALUE_WIDTH(16)
+BENCH_SET_VALUE_WIDTH(22)
+
+static uint32_t benchSetUserData(ArgosMsgTypeDef_t *frame) {
+  return u16MSGKINEIS_STDV1_setUserData(frame, benchUserData, USER_DATA_LENGTH, POSITION_STD_USER_DATA);
+}
+
+static uint32_t benchSetLocation(ArgosMsgTypeDef_t *frame) {
+  return u16MSGKINEIS_STDV1_setLocation(frame, 450000 + frame->payload[1], 25000 + frame->payload[2], 65, POSITION_STD_LOC);
+}
+
+static uint32_t benchSetCrc16AndBch32(ArgosMsgTypeDef_t *frame) {
+  vMSGKINEIS_STDV1_setCRC16andBCH32(frame, POSITION_STD_BCH32);
+  return frame->payload[ARGOS_FRAME_LENGTH - 1];
+}
+
+// A "user data only" message, as the fragments and parity messages, by the setters then its checksums
+static uint32_t benchEncodeUserDataOnlySetters(ArgosMsgTypeDef_t *frame) {
+  vMSGKINEIS_STDV1_cleanPayload(frame);
+  u16MSGKINEIS_STDV1_setUserDataOnly(frame, benchUserData, USER_DATA_LENGTH, POSITION_STD_USER_DATA_ONLY);
+  vMSGKINEIS_STDV1_setCRC16andBCH32(frame, POSITION_STD_BCH32);
+  return frame->payload[ARGOS_FRAME_LENGTH - 1];
+}
+
+// The same message with the checksums taken as it is written
+static uint32_t benchEncodeUserDataOnlyFrameWriter(ArgosMsgTypeDef_t *frame) {
+  ArgosFrameWriterTypeDef_t writer;
+  vMSGKINEIS_STDV1_initFrameWriter(&writer, frame);
+  vMSGKINEIS_STDV1_writeFrameBytes(&writer, benchUserData, USER_DATA_LENGTH);
+  vMSGKINEIS_STDV1_closeFrameWriter(&writer);
+  return frame->payload[ARGOS_FRAME_LENGTH - 1];
+}
+
+static uint32_t benchToHex(ArgosMsgTypeDef_t *frame) {
+  char hex[ARGOS_FRAME_HEX_LENGTH + 1];
+  vMSGKINEIS_STDV1_toHex(frame, hex);
+  return (uint8_t)hex[ARGOS_FRAME_HEX_LENGTH - 1];
+}
+
+static uint32_t benchCrc16Bitwise(ArgosMsgTypeDef_t *frame) {
+  return u16MSG_KINEIS_UTILS_calcCrcBch16(frame->payload + 2, BENCH_CRC16_LENGTH_BIT, CRC16_POLYNOMIAL);
+}
+
+static uint32_t benchCrc16Fast(ArgosMsgTypeDef_t *frame) {
+  return u16MSG_KINEIS_UTILS_calcCrc16Fast(frame->payload + 2, BENCH_CRC16_LENGTH_BIT);
+}
+
+static uint32_t benchBch32Bitwise(ArgosMsgTypeDef_t *frame) {
+  return u32MSG_KINEIS_UTILS_calcCrcBch32(frame->payload, BENCH_BCH32_LENGTH_BIT, BCH32_POLYNOMIAL);
+}
+
+static uint32_t benchBch32Fast(ArgosMsgTypeDef_t *frame) {
+  return u32MSG_KINEIS_UTILS_calcBch32Fast(frame->payload, BENCH_BCH32_LENGTH_BIT);
+}
+
+#define BENCH_SET_VALUE_CASES(width) \
+  { "setValue/" #width "bit/align0", benchSetValue0_##width }, { "setValue/" #width "bit/align1", benchSetValue1_##width }, \
+  { "setValue/" #width "bit/align2", benchSetValue2_##width }, { "setValue/" #width "bit/align3", benchSetValue3_##width }, \
+  { "setValue/" #width "bit/align4", benchSetValue4_##width }, { "setValue/" #width "bit/align5", benchSetValue5_##width }, \
+  { "setValue/" #width "bit/align6", benchSetValue6_##width }, { "setValue/" #width "bit/align7", benchSetValue7_##width }
+
+static const CodecBenchCase codecBenchCases[] = {
+  BENCH_SET_VALUE_CASES(6),
+  BENCH_SET_VALUE_CASES(16),
+  BENCH_SET_VALUE_CASES(22),
+  { "setUserData", benchSetUserData },
+  { "setLocation", benchSetLocation },
+  { "setCRC16andBCH32", benchSetCrc16AndBch32 },
+  { "encodeUserDataOnly/setters", benchEncodeUserDataOnlySetters },
+  { "encodeUserDataOnly/frameWriter", benchEncodeUserDataOnlyFrameWriter },
+  { "toHex", benchToHex },
+  { "crc16/bitwise", benchCrc16Bitwise },
+  { "crc16/fast", benchCrc16Fast },
+  { "bch32/bitwise", benchBch32Bitwise },
+  { "bch32/fast", benchBch32Fast },
+};
+
+#define CODEC_BENCH_CASE_COUNT (sizeof(codecBenchCases) / sizeof(codecBenchCases[0]))
+
+// Frame of readings drifting around 10 degrees C, as the transmitter sends them
+static void vCodecBenchRealisticFrame(ArgosMsgTypeDef_t *frame, uint16_t index) {
+  ArgosPackedReadingsTypeDef_t readings;
+  int16_t temperature = 100 + (int16_t)(rand() % 41) - 20;
+  uint8_t i;
+
+  vMSGKINEIS_PACKED_init(&readings, index, 20);
+  for (i = 0; i < PACKED_MAX_READINGS; i++) {
+    bMSGKINEIS_PACKED_append(&readings, temperature);
+    temperature += (int16_t)(rand() % 7) - 3;
+  }
+  vMSGKINEIS_STDV1_cleanPayload(frame);
+  u16MSGKINEIS_STDV1_setAcqPeriod(frame, USER_MSG, POSITION_STD_ACQ_PERIOD);
+  u16MSGKINEIS_STDV1_setDate(frame, 1 + index % 28, index % 24, (index * 20) % 60, POSITION_STD_DATE);
+  u16MSGKINEIS_STDV1_setLocation(frame, 450000, 25000, 65, POSITION_STD_LOC);
+  u16MSGKINEIS_PACKED_setUserData(frame, &readings, POSITION_STD_USER_DATA);
+  vMSGKINEIS_STDV1_setCRC16andBCH32(frame, POSITION_STD_BCH32);
+}
+
+static void vCodecBenchRandomFrame(ArgosMsgTypeDef_t *frame) {
+  uint8_t i;
+
+  for (i = 0; i < ARGOS_FRAME_LENGTH; i++) {
+    frame->payload[i] = (uint8_t)rand();
+  }
+}
+
+static void vCodecBenchInit(void) {
+  uint8_t i;
+
+  for (i = 0; i < USER_DATA_LENGTH; i++) {
+    benchUserData[i] = (uint8_t)(i * 37 + 11);
+  }
+}
+#endif
@@ -0,0 +1,217 @@
+/*
+  Host benchmark for the CRC16/BCH32 engines of msg_kineis_utils.
+
+  Compares the original bit-wise functions, the 256-entry table engine used on the MCU and the
+  slicing-by-8 engine used on host builds, on the two checksums vMSGKINEIS_STDV1_setCRC16andBCH32
+  computes for every frame. Results are checked bit for bit against the bit-wise functions.
+  The bulk functions of msg_kineis_clmul are checked the same way, with and without carry-less
+  multiply, on valid and corrupted frames: the CRC16 and the BCH32 each on their own and the
+  status of each frame. Their verification is then measured. Any mismatch fails the run.
+
+  Build (from the repository root):
+    cc -O2 -ITransmit -ITools -o bench_crc Tools/bench_crc.c Tools/msg_kineis_clmul.c \
+      Transmit/msg_kineis_std.c Transmit/msg_kineis_utils.c
+  Run:
+    ./bench_crc [frames]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "msg_kineis_clmul.h"
+#include "msg_kineis_std.h"
+#include "msg_kineis_utils.h"
+
+#define BCH32_WIDTH		32
+#define CRC16_WIDTH		16
+#define FRAME_SET_SIZE	4096
+
+enum Engine { ENGINE_BITWISE, ENGINE_TABLE, ENGINE_SLICE8 };
+
+static const char *engineNames[] = { "bitwise", "table", "slice8" };
+
+static ArgosMsgTypeDef_t frames[FRAME_SET_SIZE];
+static ArgosMsgTypeDef_t encoded[FRAME_SET_SIZE]; // Valid frames, half of them with a bit flipped
+
+static double nowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Checksums of one frame, same lengths as vMSGKINEIS_STDV1_setCRC16andBCH32 unless a bit
+// offset is given to exercise the unaligned paths
+static uint32_t checkFrame(enum Engine engine, uint8_t *payload, int16_t offsetBit) {
+  int16_t crcLength = ARGOS_FRAME_LENGTH_BIT - CRC16_WIDTH - BCH32_WIDTH - offsetBit;
+  int16_t bchLength = ARGOS_FRAME_LENGTH_BIT - BCH32_WIDTH - offsetBit;
+  uint16_t crc;
+  uint32_t bch;
+
+  switch (engine) {
+  case ENGINE_BITWISE:
+    crc = u16MSG_KINEIS_UTILS_calcCrcBch16(payload + 2, crcLength, CRC16_POLYNOMIAL);
+    bch = u32MSG_KINEIS_UTILS_calcCrcBch32(payload, bchLength, BCH32_POLYNOMIAL);
+    break;
+  case ENGINE_TABLE:
+    crc = u16MSG_KINEIS_UTILS_calcCrcBch16Table(payload + 2, crcLength,
+      au16MSG_KINEIS_UTILS_crc16Table);
+    bch = u32MSG_KINEIS_UTILS_calcCrcBch32Table(payload, bchLength,
+      au32MSG_KINEIS_UTILS_bch32Table);
+    break;
+  default:
+    crc = u16MSG_KINEIS_UTILS_calcCrcBch16Slice8(payload + 2, crcLength,
+      au16MSG_KINEIS_UTILS_crc16Table);
+    bch = u32MSG_KINEIS_UTILS_calcCrcBch32Slice8(payload, bchLength,
+      au32MSG_KINEIS_UTILS_bch32Table);
+    break;
+  }
+  return bch ^ crc;
+}
+
+static int verify(void) {
+  int errors = 0;
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    for (int16_t offset = 0; offset < 8; offset++) {
+      uint32_t expected = checkFrame(ENGINE_BITWISE, frames[i].payload, offset);
+      if (checkFrame(ENGINE_TABLE, frames[i].payload, offset) != expected ||
+          checkFrame(ENGINE_SLICE8, frames[i].payload, offset) != expected) {
+        errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+// Frames with their CRC16 and BCH32 set, every other one then corrupted by one bit anywhere
+static void encodeFrames(void) {
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    encoded[i] = frames[i];
+    encoded[i].payload[0] &= 0xf0;
+    encoded[i].payload[1] = 0;
+    encoded[i].payload[2] &= 0x0f;
+    vMSGKINEIS_STDV1_setCRC16andBCH32(&encoded[i], ARGOS_FRAME_LENGTH_BIT - BCH32_WIDTH);
+    if (i % 2) {
+      int bit = rand() % ARGOS_FRAME_LENGTH_BIT;
+      encoded[i].payload[bit / 8] ^= 0x80 >> (bit % 8);
+    }
+  }
+}
+
+// Mismatches of the bulk functions against the bit-wise ones, on the path selected
+static int verifyBulk(void) {
+  static uint32_t bch[FRAME_SET_SIZE];
+  static uint16_t crc[FRAME_SET_SIZE];
+  static uint8_t status[FRAME_SET_SIZE];
+  int16_t crcLength = ARGOS_FRAME_LENGTH_BIT - CRC16_WIDTH - BCH32_WIDTH;
+  int16_t bchLengths[] = { ARGOS_FRAME_LENGTH_BIT - BCH32_WIDTH, ARGOS_FRAME_LENGTH_BIT, 75 };
+  int errors = 0;
+
+  vMSG_KINEIS_CLMUL_calcCrc16Frames(encoded, FRAME_SET_SIZE, 2, crcLength, crc);
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    if (crc[i] != u16MSG_KINEIS_UTILS_calcCrcBch16(encoded[i].payload + 2, crcLength, CRC16_POLYNOMIAL)) {
+      errors++;
+    }
+  }
+  for (size_t length = 0; length < sizeof(bchLengths) / sizeof(bchLengths[0]); length++) {
+    vMSG_KINEIS_CLMUL_calcBch32Frames(encoded, FRAME_SET_SIZE, bchLengths[length], bch);
+    for (int i = 0; i < FRAME_SET_SIZE; i++) {
+      if (bch[i] != u32MSG_KINEIS_UTILS_calcCrcBch32(encoded[i].payload, bchLengths[length], BCH32_POLYNOMIAL)) {
+        errors++;
+      }
+    }
+  }
+
+  // The CRC16 as it was encoded, with its own field clear, and the remainder of the whole frame
+  uint32_t valid = u32MSG_KINEIS_CLMUL_verifyFrames(encoded, FRAME_SET_SIZE, status);
+  uint32_t expectedValid = 0;
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    uint8_t cleared[ARGOS_FRAME_LENGTH];
+    memcpy(cleared, encoded[i].payload, ARGOS_FRAME_LENGTH);
+    uint16_t stored = (uint16_t)(((cleared[0] & 0x0f) << 12) | (cleared[1] << 4) | (cleared[2] >> 4));
+    cleared[2] &= 0x0f;
+    bool crcOk = u16MSG_KINEIS_UTILS_calcCrcBch16(cleared + 2, crcLength, CRC16_POLYNOMIAL) == stored;
+    bool bchOk = u32MSG_KINEIS_UTILS_calcCrcBch32(encoded[i].payload, ARGOS_FRAME_LENGTH_BIT, BCH32_POLYNOMIAL) == 0;
+    if (((status[i] & MSG_KINEIS_CLMUL_CRC_OK) != 0) != crcOk || ((status[i] & MSG_KINEIS_CLMUL_BCH_OK) != 0) != bchOk) {
+      errors++;
+    }
+    // A corrupted frame must fail a check, a valid one pass both
+    if (crcOk && bchOk) {
+      expectedValid++;
+    }
+    if ((i % 2 == 0) != (crcOk && bchOk)) {
+      errors++;
+    }
+  }
+  return errors + (valid != expectedValid);
+}
+
+static void bench(enum Engine engine, long count, int16_t offsetBit) {
+  volatile uint32_t sink = 0;
+  uint32_t acc = 0;
+  double start = nowSeconds();
+  for (long i = 0; i < count; i++) {
+    acc ^= checkFrame(engine, frames[i % FRAME_SET_SIZE].payload, offsetBit);
+  }
+  double elapsed = nowSeconds() - start;
+  sink = acc;
+  (void)sink;
+  printf("%-8s offset %d bit  %12.0f frames/s  %8.1f ns/frame\n", engineNames[engine],
+    offsetBit, count / elapsed, elapsed * 1e9 / count);
+}
+
+static void benchBulk(bool clmul, long count) {
+  static uint8_t status[FRAME_SET_SIZE];
+  long done = 0;
+  vMSG_KINEIS_CLMUL_disable(!clmul);
+  double start = nowSeconds();
+  while (done < count) {
+    u32MSG_KINEIS_CLMUL_verifyFrames(frames, FRAME_SET_SIZE, status);
+    done += FRAME_SET_SIZE;
+  }
+  double elapsed = nowSeconds() - start;
+  printf("verify %-6s          %12.0f frames/s  %8.1f ns/frame\n", clmul ? "clmul" : "table",
+    done / elapsed, elapsed * 1e9 / done);
+}
+
+int main(int argc, char *argv[]) {
+  long count = argc > 1 ? atol(argv[1]) : 2000000;
+
+  srand(1);
+  for (int i = 0; i < FRAME_SET_SIZE; i++) {
+    for (int j = 0; j < ARGOS_FRAME_LENGTH; j++) {
+      frames[i].payload[j] = (uint8_t)rand();
+    }
+  }
+  vMSG_KINEIS_UTILS_initSlice8();
+
+  int errors = verify();
+  printf("Bit-exact check against bit-wise functions: %s\n", errors ? "FAILED" : "OK");
+
+  encodeFrames();
+  for (int clmul = 0; clmul < 2; clmul++) {
+    vMSG_KINEIS_CLMUL_disable(!clmul);
+    if (clmul && !bMSG_KINEIS_CLMUL_isSupported()) {
+      printf("Bulk check with clmul: not supported on this CPU\n");
+      continue;
+    }
+    int bulkErrors = verifyBulk();
+    printf("Bulk check with %s against bit-wise functions: %s\n", clmul ? "clmul" : "table",
+      bulkErrors ? "FAILED" : "OK");
+    errors += bulkErrors;
+  }
+
+  for (int16_t offset = 0; offset < 2; offset++) {
+    bench(ENGINE_BITWISE, count / 10, offset * 3);
+    bench(ENGINE_TABLE, count, offset * 3);
+    bench(ENGINE_SLICE8, count, offset * 3);
+  }
+
+  benchBulk(false, count);
+  vMSG_KINEIS_CLMUL_disable(false);
+  if (bMSG_KINEIS_CLMUL_isSupported()) {
+    benchBulk(true, count);
+  }
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/*
+  Host benchmark of the pass predictor of the transmitter against the built in pass table.
+
+  Predicts the passes of the satellites of a TLE file over the days covered by
+  Transmit/satellite_passes.h, then matches each pass of the table with the predicted pass
+  overlapping it most. Reports the start/end time differences, the table passes with no prediction,
+  the predicted passes missing from the table and the CPU time per predicted pass.
+  Use elements from the days of the table (February 2022), e.g. from the Space-Track or Celestrak
+  archives, for the Argos satellites (METOP-A/B/C, NOAA-15/18/19, SARAL, ANGELS), and the location
+  the table was computed for.
+
+  Build (from the repository root):
+    c++ -O2 -ITransmit -ITools/host -o bench_predict Tools/bench_predict.cpp \
+      Transmit/pass_predictor.cpp Transmit/pass_schedule.cpp Transmit/satellite_pass.cpp
+  Run:
+    ./bench_predict <tle file> <latitude> <longitude> [min elevation]
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pass_predictor.h"
+#include "satellite_passes.h"
+
+#define MAX_PREDICTED 1024
+#define MARGIN 3600
+
+struct PredictedPass {
+  SatellitePass pass;
+  int satellite;
+  bool matched;
+};
+
+static OrbitalElements satellites[PREDICT_MAX_SATELLITES];
+static char names[PREDICT_MAX_SATELLITES][32];
+static PredictedPass predicted[MAX_PREDICTED];
+
+static double nowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void trimLine(char *line) {
+  size_t length = strlen(line);
+  while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' || line[length - 1] == ' ')) {
+    line[--length] = '\0';
+  }
+}
+
+// Two or three line sets: an optional name line, then lines 1 and 2
+static int readElements(const char *filename) {
+  FILE *file = fopen(filename, "r");
+  if (file == NULL) {
+    perror(filename);
+    return -1;
+  }
+  char name[80] = "", line[128], previous[128] = "";
+  int count = 0;
+  while (fgets(line, sizeof(line), file) != NULL && count < PREDICT_MAX_SATELLITES) {
+    trimLine(line);
+    if (line[0] == '2' && previous[0] == '1') {
+      if (parseTwoLineElements(previous, line, satellites[count])) {
+        snprintf(names[count], sizeof(names[count]), "%.31s", name[0] ? name : previous + 2);
+        count++;
+      } else {
+        fprintf(stderr, "Invalid elements: %s\n", previous);
+      }
+      name[0] = '\0';
+    } else if (line[0] != '1') {
+      snprintf(name, sizeof(name), "%.79s", line);
+    }
+    strcpy(previous, line);
+  }
+  fclose(file);
+  return count;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    fprintf(stderr, "Usage: %s <tle file> <latitude> <longitude> [min elevation]\n", argv[0]);
+    return 2;
+  }
+  int count = readElements(argv[1]);
+  if (count <= 0) {
+    fprintf(stderr, "No elements read\n");
+    return 1;
+  }
+  PassPredictor predictor((float)atof(argv[2]), (float)atof(argv[3]), 0, argc > 4 ? (float)atof(argv[4]) : 0);
+
+  uint32_t first = pgm_read_dword(&satellitePassTimes[0]) - MARGIN;
+  uint32_t last = pgm_read_dword(&satellitePassTimes[2 * SATELLITE_PASS_COUNT - 1]) + MARGIN;
+  int predictedCount = 0;
+  double start = nowSeconds();
+  for (int satellite = 0; satellite < count; satellite++) {
+    uint32_t time = first;
+    SatellitePass pass;
+    while (time < last && predictedCount < MAX_PREDICTED && predictor.nextPass(satellites[satellite], time, pass)) {
+      if (pass.startTime() < last) {
+        predicted[predictedCount].pass = pass;
+        predicted[predictedCount].satellite = satellite;
+        predicted[predictedCount].matched = false;
+        predictedCount++;
+      }
+      time = pass.endTime() + 1;
+    }
+  }
+  double elapsed = nowSeconds() - start;
+
+  int missed = 0;
+  double startError = 0, endError = 0, worstError = 0;
+  int matched = 0;
+  for (uint16_t i = 0; i < SATELLITE_PASS_COUNT; i++) {
+    uint32_t tableStart = pgm_read_dword(&satellitePassTimes[2 * i]);
+    uint32_t tableEnd = pgm_read_dword(&satellitePassTimes[2 * i + 1]);
+    int best = -1;
+    long bestOverlap = 0;
+    for (int j = 0; j < predictedCount; j++) {
+      long overlap = (long)fmin(tableEnd, predicted[j].pass.endTime()) - (long)fmax(tableStart, predicted[j].pass.startTime());
+      if (overlap >= 0 && (best < 0 || overlap > bestOverlap)) {
+        best = j;
+        bestOverlap = overlap;
+      }
+    }
+    if (best < 0) {
+      printf("missed    %u - %u\n", tableStart, tableEnd);
+      missed++;
+      continue;
+    }
+    predicted[best].matched = true;
+    long startDelta = (long)predicted[best].pass.startTime() - (long)tableStart;
+    long endDelta = (long)predicted[best].pass.endTime() - (long)tableEnd;
+    printf("matched   %u - %u  %-24s start %+5ld s  end %+5ld s\n", tableStart, tableEnd,
+      names[predicted[best].satellite], startDelta, endDelta);
+    startError += labs(startDelta);
+    endError += labs(endDelta);
+    worstError = fmax(worstError, fmax(labs(startDelta), labs(endDelta)));
+    matched++;
+  }
+  int extra = 0;
+  for (int j = 0; j < predictedCount; j++) {
+    if (!predicted[j].matched) {
+      printf("extra     %u - %u  %s\n", predicted[j].pass.startTime(), predicted[j].pass.endTime(),
+        names[predicted[j].satellite]);
+      extra++;
+    }
+  }
+
+  printf("{\"satellites\": %d, \"table_passes\": %u, \"predicted_passes\": %d, \"matched\": %d, "
+    "\"missed\": %d, \"extra\": %d, \"mean_start_error_s\": %.1f, \"mean_end_error_s\": %.1f, "
+    "\"worst_error_s\": %.0f, \"us_per_prediction\": %.1f}\n",
+    count, (unsigned)SATELLITE_PASS_COUNT, predictedCount, matched, missed, extra,
+    matched ? startError / matched : 0, matched ? endError / matched : 0, worstError,
+    predictedCount ? elapsed * 1e6 / predictedCount : 0);
+  return 0;
+}
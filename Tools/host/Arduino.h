@@ -0,0 +1,101 @@
+/*
+  Host stand-in for the parts of the Arduino core used by the transmitter sketch, so transmit.ino
+  builds with a host compiler (see Tools/simulate_transmit.cpp). Time runs on the virtual clock of
+  host_clock.h, digitalRead and analogRead ask the simulation for a value and Serial output is only
+  shown when hostSerialEcho is set.
+*/
+#ifndef Arduino_h
+#define Arduino_h
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "host_clock.h"
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define A0 14
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_word
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#endif
+#ifndef pgm_read_dword
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#endif
+#define F(string) (string)
+#define constrain(value, low, high) ((value) < (low) ? (low) : ((value) > (high) ? (high) : (value)))
+
+inline unsigned long millis() { return (unsigned long)hostClockMillis; }
+inline void delay(unsigned long ms) { hostClockMillis += ms; }
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+// Level read on a digital pin, HIGH when not set
+inline int (*hostDigitalRead)(uint8_t pin) = 0;
+inline int digitalRead(uint8_t pin) { return hostDigitalRead ? hostDigitalRead(pin) : HIGH; }
+
+// Value read on an analogue pin, 512 when not set
+inline int (*hostAnalogRead)(uint8_t pin) = 0;
+inline int analogRead(uint8_t pin) { return hostAnalogRead ? hostAnalogRead(pin) : 512; }
+
+class String {
+  public:
+    String(const char *text = "") : _text(text) {}
+    String(int value) : _text(std::to_string(value)) {}
+    String(unsigned int value) : _text(std::to_string(value)) {}
+    String(long value) : _text(std::to_string(value)) {}
+    String(unsigned long value) : _text(std::to_string(value)) {}
+    String(double value, unsigned char decimals = 2) {
+      char text[32];
+      snprintf(text, sizeof(text), "%.*f", decimals, value);
+      _text = text;
+    }
+    void reserve(unsigned int size) { _text.reserve(size); }
+    unsigned int length() const { return _text.length(); }
+    const char *c_str() const { return _text.c_str(); }
+    String substring(unsigned int from, unsigned int to) const { return String(_text.substr(from, to - from).c_str()); }
+    // Copies at most size - 1 characters and a terminating 0
+    void getBytes(unsigned char *buffer, unsigned int size) const {
+      if (size == 0) {
+        return;
+      }
+      unsigned int count = _text.length() < size - 1 ? _text.length() : size - 1;
+      memcpy(buffer, _text.c_str(), count);
+      buffer[count] = 0;
+    }
+    String &operator+=(const String &other) { _text += other._text; return *this; }
+    String &operator+=(const char *other) { _text += other; return *this; }
+    String &operator+=(int value) { return *this += String(value); }
+    String &operator+=(double value) { return *this += String(value); }
+    friend String operator+(const String &left, const String &right) { String result(left); return result += right; }
+    friend String operator+(const char *left, const String &right) { String result(left); return result += right; }
+  private:
+    std::string _text;
+};
+
+// Echo the sketch's serial output to stdout
+inline bool hostSerialEcho = false;
+
+class HostSerial {
+  public:
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+    void flush() { fflush(stdout); }
+    void print(const char *text) { if (hostSerialEcho) fputs(text, stdout); }
+    void print(const String &text) { print(text.c_str()); }
+    void print(long value) { print(String(value)); }
+    void println() { print("\n"); }
+    void println(const char *text) { print(text); println(); }
+    void println(const String &text) { println(text.c_str()); }
+    void println(long value) { println(String(value)); }
+};
+inline HostSerial Serial;
+#endif
@@ -0,0 +1,58 @@
+/*
+  Host stand-in for the Kineis KIM1 library. The module is always found. Each frame sent is handed
+  to hostKimSend when the transmission starts, then takes hostKimSendMillis of the virtual clock,
+  as the module keeps the sketch waiting while it transmits.
+*/
+#ifndef KIM_h
+#define KIM_h
+#include <stdint.h>
+#include "host_clock.h"
+
+#define RX_KIM 8
+#define TX_KIM 9
+
+typedef enum {
+  OK_KIM,
+  ERROR_KIM,
+  TIMEOUT_KIM,
+  UNKNOWN_ERROR_KIM
+} RetStatusKIMTypeDef;
+
+inline void (*hostKimSend)(const char *data, uint8_t length) = 0;
+inline uint32_t hostKimSendMillis = 1000;
+
+class SoftwareSerial {
+  public:
+    SoftwareSerial(uint8_t, uint8_t) {}
+};
+
+class KIM {
+  public:
+    KIM(SoftwareSerial *) : _sleeping(false) {}
+    bool check() { return true; }
+    RetStatusKIMTypeDef set_BAND(const char *, uint8_t) { return OK_KIM; }
+    RetStatusKIMTypeDef set_FRQ(const char *, uint8_t) { return OK_KIM; }
+    RetStatusKIMTypeDef set_PWR(const char *, uint8_t) { return OK_KIM; }
+    RetStatusKIMTypeDef set_TCXOWU(const char *, uint8_t) { return OK_KIM; }
+    const char *get_ID() { return "HOST"; }
+    const char *get_SN() { return "0"; }
+    const char *get_FW() { return "HOST"; }
+    const char *get_BAND() { return "B1"; }
+    const char *get_PWR() { return "1000"; }
+    const char *get_FRQ() { return "300"; }
+    const char *get_TCXOWU() { return "5000"; }
+    RetStatusKIMTypeDef set_sleepMode(bool sleeping) { _sleeping = sleeping; return OK_KIM; }
+    RetStatusKIMTypeDef send_data(const char *data, uint8_t length) {
+      if (_sleeping) {
+        return ERROR_KIM;
+      }
+      if (hostKimSend) {
+        hostKimSend(data, length);
+      }
+      hostClockMillis += hostKimSendMillis;
+      return OK_KIM;
+    }
+  private:
+    bool _sleeping;
+};
+#endif
@@ -0,0 +1,112 @@
+/*
+  Host stand-in for the Adafruit RTClib DateTime class, so the Transmit sources which only need
+  times (satellite_pass, pass_schedule, pass_predictor) build with a host compiler for the tools
+  and benchmarks in this folder. Times are seconds since 1970-01-01 as in RTClib.
+  RTC_PCF8523 reads the virtual clock of host_clock.h, its countdown timer runs on it as well.
+*/
+#ifndef RTClib_h
+#define RTClib_h
+#include <stdint.h>
+#include <string.h>
+#include "host_clock.h"
+
+class DateTime {
+  public:
+    DateTime(uint32_t t = 0) : _time(t) {}
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0) {
+      // Days since 1970-01-01 of a date of the Gregorian calendar
+      int32_t y = year - (month <= 2);
+      int32_t era = y / 400;
+      int32_t yearOfEra = y - era * 400;
+      int32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+      int32_t days = era * 146097 + yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear - 719468;
+      _time = (uint32_t)days * 86400UL + hour * 3600UL + min * 60UL + sec;
+    }
+    // Date and time as given by the __DATE__ ("Mar  1 2022") and __TIME__ ("13:45:00") macros
+    DateTime(const char *date, const char *time) {
+      static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+      uint8_t month = 1;
+      while (month < 12 && strncmp(months + (month - 1) * 3, date, 3) != 0) {
+        month++;
+      }
+      *this = DateTime(number(date + 7, 4), month, number(date + 4, 2), number(time, 2), number(time + 3, 2), number(time + 6, 2));
+    }
+    uint32_t unixtime() const { return _time; }
+    uint16_t year() const { int32_t y, m, d; civil(y, m, d); return y; }
+    uint8_t month() const { int32_t y, m, d; civil(y, m, d); return m; }
+    uint8_t day() const { int32_t y, m, d; civil(y, m, d); return d; }
+    uint8_t hour() const { return (_time / 3600) % 24; }
+    uint8_t minute() const { return (_time / 60) % 60; }
+    uint8_t second() const { return _time % 60; }
+    bool operator>=(const DateTime &other) const { return _time >= other._time; }
+    bool operator<=(const DateTime &other) const { return _time <= other._time; }
+  private:
+    static uint16_t number(const char *digits, uint8_t count) {
+      uint16_t value = 0;
+      for (; count > 0; count--, digits++) {
+        value = value * 10 + (*digits >= '0' && *digits <= '9' ? *digits - '0' : 0);
+      }
+      return value;
+    }
+    // Gregorian date of the day
+    void civil(int32_t &year, int32_t &month, int32_t &day) const {
+      int32_t days = _time / 86400 + 719468;
+      int32_t era = days / 146097;
+      int32_t dayOfEra = days - era * 146097;
+      int32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+      int32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+      int32_t monthIndex = (5 * dayOfYear + 2) / 153;
+      day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+      month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+      year = yearOfEra + era * 400 + (month <= 2);
+    }
+    uint32_t _time;
+};
+
+enum PCF8523TimerClockFreq {
+  PCF8523_Frequency4kHz,
+  PCF8523_Frequency64Hz,
+  PCF8523_FrequencySecond,
+  PCF8523_FrequencyMinute,
+  PCF8523_FrequencyHour
+};
+
+// Countdown timer: INT/SQW is low from hostRtcTimerEnd, in milliseconds of the virtual clock, until
+// the timer is disabled. hostRtcTimerMillis adds up the time the timer was running
+inline bool hostRtcTimerEnabled = false;
+inline uint64_t hostRtcTimerStart = 0;
+inline uint64_t hostRtcTimerEnd = 0;
+inline uint64_t hostRtcTimerMillis = 0;
+
+inline bool hostRtcInterrupt() {
+  return hostRtcTimerEnabled && hostClockMillis >= hostRtcTimerEnd;
+}
+
+// Real time clock running on the virtual clock, set when the sketch starts
+class RTC_PCF8523 {
+  public:
+    bool begin() { return true; }
+    bool initialized() { return hostClockStart != 0; }
+    bool lostPower() { return false; }
+    void adjust(const DateTime &dt) { hostClockStart = dt.unixtime() - (uint32_t)(hostClockMillis / 1000); }
+    void start() {}
+    DateTime now() { return DateTime(hostClockNow()); }
+    // The source clock of the timer keeps running, so its first period ends on the next tick
+    void enableCountdownTimer(PCF8523TimerClockFreq frequency, uint8_t periods) {
+      static const uint64_t periodMillis[] = { 1, 16, 1000, 60000, 3600000 };
+      disableCountdownTimer();
+      uint64_t period = periodMillis[frequency];
+      uint64_t clockMillis = hostClockMillis + (uint64_t)hostClockStart * 1000;
+      hostRtcTimerEnabled = true;
+      hostRtcTimerStart = hostClockMillis;
+      hostRtcTimerEnd = (clockMillis / period + periods) * period - (uint64_t)hostClockStart * 1000;
+    }
+    void disableCountdownTimer() {
+      if (hostRtcTimerEnabled) {
+        hostRtcTimerMillis += hostClockMillis - hostRtcTimerStart;
+      }
+      hostRtcTimerEnabled = false;
+    }
+    void deconfigureAllTimers() { disableCountdownTimer(); }
+};
+#endif
@@ -0,0 +1,131 @@
+/*
+  Host stand-in for the Arduino SD library: files are kept in memory, by name, for the life of the
+  program. hostSdFailWrites makes every write fail, as with a card removed or full. Files are
+  opened with FILE_WRITE for appending, as on the Arduino, or with O_WRITE alone for writes in place.
+  hostSdOpens and hostSdWrites count the files opened and the writes, each costing card time.
+*/
+#ifndef SD_h
+#define SD_h
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef O_READ
+#define O_READ 0x01
+#endif
+#ifndef O_WRITE
+#define O_WRITE 0x02
+#endif
+#ifndef O_APPEND
+#define O_APPEND 0x04
+#endif
+#ifndef O_CREAT
+#define O_CREAT 0x10
+#endif
+#define FILE_READ O_READ
+#define FILE_WRITE (O_READ | O_WRITE | O_CREAT | O_APPEND)
+
+inline bool hostSdFailWrites = false;
+inline uint32_t hostSdOpens = 0;
+inline uint32_t hostSdWrites = 0;
+
+class File {
+  public:
+    File() : _mode(0), _position(0) {}
+    File(std::shared_ptr<std::vector<uint8_t> > data, uint8_t mode) : _data(data), _mode(mode), _position(0) {
+      if (mode & O_APPEND) {
+        _position = data->size();
+      }
+    }
+    operator bool() const { return (bool)_data; }
+    uint32_t size() const { return _data ? _data->size() : 0; }
+    uint32_t position() const { return _position; }
+    int available() const { return _data && _position < _data->size() ? _data->size() - _position : 0; }
+    bool seek(uint32_t position) {
+      if (!_data || position > _data->size()) {
+        return false;
+      }
+      _position = position;
+      return true;
+    }
+    int read() {
+      uint8_t value;
+      return read(&value, 1) == 1 ? value : -1;
+    }
+    int read(void *buffer, uint32_t length) {
+      if (!_data || !(_mode & O_READ)) {
+        return -1;
+      }
+      uint32_t count = available() < (int)length ? available() : length;
+      memcpy(buffer, _data->data() + _position, count);
+      _position += count;
+      return count;
+    }
+    size_t readBytesUntil(char terminator, char *buffer, size_t length) {
+      size_t count = 0;
+      int value;
+      while (count < length && (value = read()) >= 0 && value != terminator) {
+        buffer[count++] = (char)value;
+      }
+      return count;
+    }
+    size_t write(const uint8_t *buffer, size_t length) {
+      if (!_data || !(_mode & O_WRITE) || hostSdFailWrites) {
+        return 0;
+      }
+      hostSdWrites++;
+      if (_mode & O_APPEND) {
+        _position = _data->size();
+      }
+      if (_position + length > _data->size()) {
+        _data->resize(_position + length);
+      }
+      memcpy(_data->data() + _position, buffer, length);
+      _position += length;
+      return length;
+    }
+    size_t write(uint8_t value) { return write(&value, 1); }
+    size_t print(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+    size_t println(const char *text) { return print(text) + print("\r\n"); }
+    void flush() {}
+    void close() { _data.reset(); }
+  private:
+    std::shared_ptr<std::vector<uint8_t> > _data;
+    uint8_t _mode;
+    uint32_t _position;
+};
+
+class SDClass {
+  public:
+    bool begin(uint8_t) { return true; }
+    File open(const char *name, uint8_t mode = FILE_READ) {
+      hostSdOpens++;
+      std::map<std::string, std::shared_ptr<std::vector<uint8_t> > >::iterator file = _files.find(name);
+      if (file == _files.end()) {
+        if (!(mode & O_CREAT) || hostSdFailWrites) {
+          return File();
+        }
+        file = _files.insert(std::make_pair(std::string(name), std::make_shared<std::vector<uint8_t> >())).first;
+      }
+      return File(file->second, mode);
+    }
+    template <class Name> File open(const Name &name, uint8_t mode = FILE_READ) { return open(name.c_str(), mode); }
+    bool exists(const char *name) { return _files.count(name) > 0; }
+    bool remove(const char *name) { return _files.erase(name) > 0; }
+    // Copy of a host file put on the card before the sketch starts
+    void hostAddFile(const char *name, const std::vector<uint8_t> &data) {
+      _files[name] = std::make_shared<std::vector<uint8_t> >(data);
+    }
+    // Contents of a file of the card, NULL when there is none
+    const std::vector<uint8_t> *hostFile(const char *name) {
+      std::map<std::string, std::shared_ptr<std::vector<uint8_t> > >::iterator file = _files.find(name);
+      return file != _files.end() ? file->second.get() : NULL;
+    }
+  private:
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t> > > _files;
+};
+inline SDClass SD;
+#endif
@@ -0,0 +1,6 @@
+/*
+  Host stand-in for the Arduino SPI library, which the SD stand-in does not need.
+*/
+#ifndef SPI_h
+#define SPI_h
+#endif
@@ -0,0 +1,18 @@
+/*
+  Virtual clock of the host builds of the transmitter sketch (see Tools/simulate_transmit.cpp).
+  delay() moves it on instead of waiting, so days of operation run in milliseconds. The RTC
+  stand-in reads it as well, from the time it was set to.
+*/
+#ifndef HostClock_h
+#define HostClock_h
+#include <stdint.h>
+
+// Milliseconds since the sketch started
+inline uint64_t hostClockMillis = 0;
+// Seconds since 1970-01-01 at hostClockMillis 0
+inline uint32_t hostClockStart = 0;
+
+inline uint32_t hostClockNow() {
+  return hostClockStart + (uint32_t)(hostClockMillis / 1000);
+}
+#endif
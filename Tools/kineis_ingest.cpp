@@ -0,0 +1,588 @@
+/*
+  Decode Kineis exports in bulk, for backfills of months of data.
+
+  Reads the two shapes of export the Receive function handles: the CSV export
+    DEVICE_ID;MSG_ID;CHECKED;GPS_DATE;CRC_OK;BCH_STATUS;LONG;LAT;ALT;SENSORS;METADATAS;COUNTER
+  whose SENSORS column holds the JSON of the sensors with its quotes doubled, and the JSON export
+  (KineisRoot) with RAW_DATA in each datum or in its SENSORS. Files are memory mapped and cut into
+  chunks on record boundaries, a CSV line or a JSON object starting with DEVICE_ID, which the
+  threads take in turn. Fields are found in place, without copying the records, and RAW_DATA is
+  decoded with the codec of the transmitter (msg_kineis_std_decode, msg_kineis_packed) through the
+  SSE2 hex decoder of msg_kineis_hex_sse.
+
+  RAW_DATA leaves out the 4 bit extension id which starts the frame, it is put back as 0 before
+  decoding. Each frame gives one output row per reading: the packed readings, the text reading
+  |id|temperatureC, or a row without reading for parity frames, fragments (not reassembled) and
+  frames not understood. Rows are in the order of the files and of the records in them.
+
+  Output, -f csv (default):
+    device_id,msg_id,date,kind,id,index,minutes,temperature,day,hour,minute,crc_ok,bch_ok
+  with the date of the message (MSG_DATE, else GPS_DATE) in seconds since 1970-01-01, 0 if none.
+  Output, -f bin: INGEST_RECORD_SIZE byte records, little-endian
+    0  uint32  device id
+    4  uint32  message id
+    8  uint32  date, seconds since 1970-01-01, 0 if none
+    12 uint16  reading id: the packed frame number or the text id
+    14 uint8   reading index in the frame
+    15 uint8   kind (IngestKind) in the low nibble, INGEST_CRC_OK and INGEST_BCH_OK above it
+    16 int16   temperature in hundredths of a degree C
+    18 uint16  minutes after the first reading of the frame
+    20 uint8   day, 21 uint8 hour, 22 uint8 minute of the frame
+    23 uint8   reserved, 0
+  Output, -f frames: the ARGOS_FRAME_LENGTH (31) bytes of each frame, extension id 0, one after the
+  other and without readings, for Tools/verify_frames.c
+
+  Build (from the repository root):
+    make -C Tools kineis_ingest
+  Run:
+    Tools/build/kineis_ingest [-j threads] [-f csv|bin|frames] [-o output] export files...
+  -j: threads, by default one per core
+  -f: output format
+  -o: output file, stdout by default
+  A summary is written to stderr.
+*/
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "msg_kineis_fec.h"
+#include "msg_kineis_frag.h"
+#include "msg_kineis_hex_sse.h"
+#include "msg_kineis_packed.h"
+#include "msg_kineis_std.h"
+#include "msg_kineis_std_decode.h"
+#include "msg_kineis_utils.h"
+
+#define INGEST_RECORD_SIZE 24
+#define INGEST_CRC_OK 0x10
+#define INGEST_BCH_OK 0x20
+// Chunks per thread, so that threads finishing early take the chunks left
+#define CHUNKS_PER_THREAD 8
+#define MIN_CHUNK_SIZE (64 * 1024)
+
+enum IngestKind { KIND_OTHER, KIND_PACKED, KIND_TEXT, KIND_PARITY, KIND_FRAGMENT };
+
+static const char *kindNames[] = { "other", "packed", "text", "parity", "fragment" };
+
+enum ExportFormat { EXPORT_CSV, EXPORT_JSON };
+
+struct MappedFile {
+  const char *path;
+  const char *data;
+  size_t size;
+  ExportFormat format;
+  // CSV columns, -1 when missing
+  int deviceColumn;
+  int messageColumn;
+  int dateColumn;
+  int sensorsColumn;
+  size_t firstRecord;
+};
+
+struct Chunk {
+  const MappedFile *file;
+  size_t begin;
+  size_t end;
+  std::string output;
+  uint32_t records;
+  uint32_t frames;
+  uint32_t validFrames;
+  uint32_t readings;
+};
+
+// Fields of a record, pointing into the mapped file
+struct Field {
+  const char *text;
+  size_t length;
+};
+
+struct ExportRecord {
+  Field device;
+  Field message;
+  Field date;
+  Field rawData;
+};
+
+static bool binaryOutput = false;
+static bool frameOutput = false;
+
+static bool isHexDigit(char c) {
+  return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+static uint32_t fieldNumber(const Field &field) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < field.length && field.text[i] >= '0' && field.text[i] <= '9'; i++) {
+    value = value * 10 + (field.text[i] - '0');
+  }
+  return value;
+}
+
+// Days since 1970-01-01 of a date of the Gregorian calendar
+static long daysFromCivil(int year, int month, int day) {
+  year -= month <= 2;
+  long era = (year >= 0 ? year : year - 399) / 400;
+  long yearOfEra = year - era * 400;
+  long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+// 2022-02-09T10:21:05.197Z, UTC, to seconds since 1970-01-01; 0 if it is not a date
+static uint32_t fieldDate(const Field &field) {
+  int year, month, day, hour, minute, second;
+  char text[20];
+  if (field.length < 19) {
+    return 0;
+  }
+  memcpy(text, field.text, 19);
+  text[19] = '\0';
+  if (sscanf(text, "%4d-%2d-%2dT%2d:%2d:%2d", &year, &month, &day, &hour, &minute, &second) != 6) {
+    return 0;
+  }
+  return (uint32_t)(daysFromCivil(year, month, day) * 86400L + hour * 3600L + minute * 60L + second);
+}
+
+static const char *findText(const char *begin, const char *end, const char *text, size_t length) {
+  while (begin + length <= end) {
+    const char *found = (const char *)memchr(begin, text[0], end - begin - length + 1);
+    if (found == NULL) {
+      return NULL;
+    }
+    if (memcmp(found, text, length) == 0) {
+      return found;
+    }
+    begin = found + 1;
+  }
+  return NULL;
+}
+
+// Value of a key of the JSON between begin and end, its quotes possibly doubled as in the CSV
+// export: the characters after the key and its separators, up to a quote, comma or brace
+static Field jsonValue(const char *begin, const char *end, const char *key) {
+  Field field = { NULL, 0 };
+  size_t keyLength = strlen(key);
+  const char *found = begin;
+  while ((found = findText(found, end, key, keyLength)) != NULL) {
+    const char *value = found + keyLength;
+    // A key is followed by its closing quote, the match may be part of a longer name
+    if (found > begin && found[-1] == '"' && value < end && *value == '"') {
+      while (value < end && (*value == '"' || *value == ':' || *value == ' ')) {
+        value++;
+      }
+      const char *valueEnd = value;
+      while (valueEnd < end && *valueEnd != '"' && *valueEnd != ',' && *valueEnd != '}') {
+        valueEnd++;
+      }
+      field.text = value;
+      field.length = valueEnd - value;
+      return field;
+    }
+    found = value;
+  }
+  return field;
+}
+
+// Start of the next line from position, the end of the data when there is none
+static size_t nextLine(const MappedFile &file, size_t position) {
+  const char *found = (const char *)memchr(file.data + position, '\n', file.size - position);
+  return found != NULL ? found - file.data + 1 : file.size;
+}
+
+// Start of the next JSON datum from position: the object holding the next DEVICE_ID key
+static size_t nextDatum(const MappedFile &file, size_t position) {
+  const char *found = findText(file.data + position, file.data + file.size, "\"DEVICE_ID\"", 11);
+  return found != NULL ? found - file.data : file.size;
+}
+
+static size_t nextRecord(const MappedFile &file, size_t position) {
+  if (position <= file.firstRecord) {
+    return file.firstRecord;
+  }
+  return file.format == EXPORT_CSV ? nextLine(file, position - 1) : nextDatum(file, position);
+}
+
+// Fields of a CSV line, split on semicolons outside quotes
+static ExportRecord csvRecord(const MappedFile &file, const char *line, const char *end) {
+  ExportRecord record = {};
+  int column = 0;
+  bool quoted = false;
+  const char *start = line;
+  for (const char *c = line; c <= end; c++) {
+    if (c < end && *c == '"') {
+      quoted = !quoted;
+    } else if (c == end || (*c == ';' && !quoted)) {
+      Field field = { start, (size_t)(c - start) };
+      if (column == file.deviceColumn) {
+        record.device = field;
+      } else if (column == file.messageColumn) {
+        record.message = field;
+      } else if (column == file.dateColumn) {
+        record.date = field;
+      } else if (column == file.sensorsColumn) {
+        record.rawData = jsonValue(field.text, field.text + field.length, "RAW_DATA");
+      }
+      column++;
+      start = c + 1;
+    }
+  }
+  return record;
+}
+
+static ExportRecord jsonRecord(const char *datum, const char *end) {
+  ExportRecord record;
+  record.device = jsonValue(datum, end, "DEVICE_ID");
+  record.message = jsonValue(datum, end, "MSG_ID");
+  record.date = jsonValue(datum, end, "MSG_DATE");
+  if (record.date.text == NULL) {
+    record.date = jsonValue(datum, end, "GPS_DATE");
+  }
+  record.rawData = jsonValue(datum, end, "RAW_DATA");
+  return record;
+}
+
+// Text reading |id|temperatureC of the user data, as ParseTextReading of the Receive function
+static bool textReading(const uint8_t *data, size_t length, uint16_t &id, int16_t &hundredths) {
+  for (size_t start = 0; start < length; start++) {
+    if (data[start] != '|') {
+      continue;
+    }
+    size_t i = start + 1;
+    uint32_t number = 0;
+    while (i < length && i - start <= 3 && data[i] >= '0' && data[i] <= '9') {
+      number = number * 10 + (data[i++] - '0');
+    }
+    if (i == start + 1 || i >= length || data[i] != '|') {
+      continue;
+    }
+    size_t value = ++i;
+    while (i < length && i - value < 5 && ((data[i] >= '0' && data[i] <= '9') || data[i] == '.')) {
+      i++;
+    }
+    if (i == value || i >= length || data[i] != 'C') {
+      continue;
+    }
+    char text[6];
+    memcpy(text, data + value, i - value);
+    text[i - value] = '\0';
+    id = (uint16_t)number;
+    hundredths = (int16_t)(atof(text) * 100 + 0.5);
+    return true;
+  }
+  return false;
+}
+
+struct Reading {
+  uint16_t id;
+  uint8_t index;
+  int16_t hundredths;
+  uint16_t minutes;
+};
+
+static void putShort(std::string &output, uint16_t value) {
+  output.push_back((char)value);
+  output.push_back((char)(value >> 8));
+}
+
+static void putLong(std::string &output, uint32_t value) {
+  putShort(output, (uint16_t)value);
+  putShort(output, (uint16_t)(value >> 16));
+}
+
+static void writeRow(Chunk &chunk, const ExportRecord &record, uint32_t date, IngestKind kind,
+  const ArgosDecodedMsgTypeDef_t &decoded, const Reading *reading) {
+  if (binaryOutput) {
+    std::string &output = chunk.output;
+    putLong(output, fieldNumber(record.device));
+    putLong(output, fieldNumber(record.message));
+    putLong(output, date);
+    putShort(output, reading ? reading->id : 0);
+    output.push_back(reading ? (char)reading->index : 0);
+    output.push_back((char)(kind | (decoded.crcOk ? INGEST_CRC_OK : 0) | (decoded.bchOk ? INGEST_BCH_OK : 0)));
+    putShort(output, reading ? (uint16_t)reading->hundredths : 0);
+    putShort(output, reading ? reading->minutes : 0);
+    output.push_back((char)decoded.day);
+    output.push_back((char)decoded.hour);
+    output.push_back((char)decoded.min);
+    output.push_back(0);
+    return;
+  }
+  char line[160];
+  int length;
+  if (reading != NULL) {
+    length = snprintf(line, sizeof(line), ",%u,%s,%u,%u,%u,%.2f,%u,%u,%u,%d,%d\n", date, kindNames[kind], reading->id,
+      reading->index, reading->minutes, reading->hundredths / 100.0, decoded.day, decoded.hour, decoded.min, decoded.crcOk, decoded.bchOk);
+  } else {
+    length = snprintf(line, sizeof(line), ",%u,%s,,,,,%u,%u,%u,%d,%d\n", date, kindNames[kind], decoded.day, decoded.hour,
+      decoded.min, decoded.crcOk, decoded.bchOk);
+  }
+  chunk.output.append(record.device.text ? record.device.text : "", record.device.length);
+  chunk.output.push_back(',');
+  chunk.output.append(record.message.text ? record.message.text : "", record.message.length);
+  chunk.output.append(line, length);
+}
+
+// Bytes of a RAW_DATA text and their frame: its bits come after the 4 bit extension id, left as 0
+static bool rawDataFrame(const Field &rawData, ArgosMsgTypeDef_t &raw, ArgosMsgTypeDef_t &frame) {
+  size_t length = 0;
+  while (length < rawData.length && isHexDigit(rawData.text[length])) {
+    length++;
+  }
+  length &= ~(size_t)1;
+  if (length == 0 || length > ARGOS_FRAME_HEX_LENGTH || !bMSG_KINEIS_HEX_fromHex(rawData.text, (uint16_t)length, &raw)) {
+    return false;
+  }
+  frame.payload[0] = raw.payload[0] >> 4;
+  for (int i = 1; i < ARGOS_FRAME_LENGTH; i++) {
+    frame.payload[i] = (uint8_t)((raw.payload[i - 1] << 4) | (raw.payload[i] >> 4));
+  }
+  return true;
+}
+
+static void decodeRecord(Chunk &chunk, const ExportRecord &record) {
+  ArgosMsgTypeDef_t raw;
+  ArgosMsgTypeDef_t frame;
+  ArgosDecodedMsgTypeDef_t decoded;
+  chunk.records++;
+  if (record.rawData.text == NULL || !rawDataFrame(record.rawData, raw, frame)) {
+    return;
+  }
+  chunk.frames++;
+  if (bMSGKINEIS_STDV1_decode(&frame, &decoded)) {
+    chunk.validFrames++;
+  }
+  if (frameOutput) {
+    chunk.output.append((const char *)frame.payload, ARGOS_FRAME_LENGTH);
+    return;
+  }
+  uint32_t date = fieldDate(record.date);
+  uint8_t tag = (uint8_t)u32MSGKINEIS_STDV1_getValue(&frame, POSITION_STD_ACQ_PERIOD, 4);
+  Reading reading;
+  if (decoded.acqPeriod == USER_MSG && bMSGKINEIS_PACKED_isPacked(decoded.userData)) {
+    ArgosPackedReadingsTypeDef_t readings;
+    if (bMSGKINEIS_PACKED_fromUserData(decoded.userData, &readings) && readings.count > 0) {
+      for (uint8_t i = 0; i < readings.count; i++) {
+        reading = Reading { readings.seq, i, (int16_t)(readings.temperature[i] * 10), (uint16_t)(i * readings.interval) };
+        writeRow(chunk, record, date, KIND_PACKED, decoded, &reading);
+      }
+      chunk.readings += readings.count;
+      return;
+    }
+  }
+  // The text is byte aligned in the raw data, searched whole as in the Receive function: the
+  // frames of the first transmitters do not have the acquisition period of a user message
+  reading = Reading { 0, 0, 0, 0 };
+  if (textReading(raw.payload, ARGOS_FRAME_LENGTH, reading.id, reading.hundredths)) {
+    writeRow(chunk, record, date, KIND_TEXT, decoded, &reading);
+    chunk.readings++;
+    return;
+  }
+  IngestKind kind = tag == FEC_TAG ? KIND_PARITY : tag == FRAG_TAG ? KIND_FRAGMENT : KIND_OTHER;
+  writeRow(chunk, record, date, kind, decoded, NULL);
+}
+
+static void decodeChunk(Chunk &chunk) {
+  const MappedFile &file = *chunk.file;
+  size_t position = nextRecord(file, chunk.begin);
+  while (position < chunk.end) {
+    size_t next = nextRecord(file, position + 1);
+    const char *record = file.data + position;
+    const char *recordEnd = file.data + next;
+    if (file.format == EXPORT_CSV) {
+      // Without the line end
+      while (recordEnd > record && (recordEnd[-1] == '\n' || recordEnd[-1] == '\r')) {
+        recordEnd--;
+      }
+      if (recordEnd > record) {
+        decodeRecord(chunk, csvRecord(file, record, recordEnd));
+      }
+    } else {
+      decodeRecord(chunk, jsonRecord(record, recordEnd));
+    }
+    position = next;
+  }
+}
+
+// Columns of the CSV header line
+static void readCsvHeader(MappedFile &file, size_t start) {
+  file.firstRecord = nextLine(file, start);
+  file.deviceColumn = file.messageColumn = file.dateColumn = file.sensorsColumn = -1;
+  const char *c = file.data + start;
+  const char *end = file.data + file.firstRecord;
+  for (int column = 0; c < end; column++) {
+    const char *name = c;
+    while (c < end && *c != ';' && *c != '\r' && *c != '\n') {
+      c++;
+    }
+    std::string header(name, c - name);
+    if (header == "DEVICE_ID") {
+      file.deviceColumn = column;
+    } else if (header == "MSG_ID") {
+      file.messageColumn = column;
+    } else if (header == "GPS_DATE") {
+      file.dateColumn = column;
+    } else if (header == "SENSORS") {
+      file.sensorsColumn = column;
+    }
+    if (c < end && *c != ';') {
+      break;
+    }
+    c++;
+  }
+}
+
+static bool mapFile(const char *path, MappedFile &file) {
+  int descriptor = open(path, O_RDONLY);
+  struct stat status;
+  if (descriptor < 0 || fstat(descriptor, &status) != 0) {
+    if (descriptor >= 0) {
+      close(descriptor);
+    }
+    return false;
+  }
+  file.path = path;
+  file.size = status.st_size;
+  file.data = "";
+  if (file.size > 0) {
+    void *data = mmap(NULL, file.size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (data == MAP_FAILED) {
+      close(descriptor);
+      return false;
+    }
+    madvise(data, file.size, MADV_SEQUENTIAL);
+    file.data = (const char *)data;
+  }
+  close(descriptor);
+  // Skip a UTF-8 byte order mark
+  size_t start = file.size >= 3 && memcmp(file.data, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+  if (file.size - start >= 9 && memcmp(file.data + start, "DEVICE_ID", 9) == 0) {
+    file.format = EXPORT_CSV;
+    readCsvHeader(file, start);
+  } else {
+    file.format = EXPORT_JSON;
+    file.firstRecord = nextDatum(file, start);
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned threads = std::thread::hardware_concurrency();
+  const char *outputPath = NULL;
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      threads = (unsigned)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "bin") == 0) {
+        binaryOutput = true;
+      } else if (strcmp(argv[i], "frames") == 0) {
+        frameOutput = true;
+      } else if (strcmp(argv[i], "csv") != 0) {
+        paths.clear();
+        break;
+      }
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (argv[i][0] == '-') {
+      paths.clear();
+      break;
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.empty()) {
+    fprintf(stderr, "usage: %s [-j threads] [-f csv|bin|frames] [-o output] export files...\n", argv[0]);
+    return 1;
+  }
+  if (threads == 0) {
+    threads = 1;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<MappedFile> files(paths.size());
+  size_t totalSize = 0;
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (!mapFile(paths[i], files[i])) {
+      perror(paths[i]);
+      return 1;
+    }
+    totalSize += files[i].size;
+  }
+
+  // Chunks of about the same size over all the files, cut again on record boundaries by the threads
+  size_t chunkSize = totalSize / (threads * CHUNKS_PER_THREAD) + 1;
+  if (chunkSize < MIN_CHUNK_SIZE) {
+    chunkSize = MIN_CHUNK_SIZE;
+  }
+  std::vector<Chunk> chunks;
+  for (size_t i = 0; i < files.size(); i++) {
+    for (size_t begin = 0; begin < files[i].size; begin += chunkSize) {
+      size_t end = begin + chunkSize < files[i].size ? begin + chunkSize : files[i].size;
+      chunks.push_back(Chunk { &files[i], begin, end, std::string(), 0, 0, 0, 0 });
+    }
+  }
+
+  // Tables of the CRC16/BCH32 checks built on first use, before the threads share them
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+  vMSG_KINEIS_UTILS_initSlice8();
+#endif
+  std::atomic<size_t> nextChunk(0);
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < threads && i < chunks.size(); i++) {
+    workers.push_back(std::thread([&chunks, &nextChunk]() {
+      size_t index;
+      while ((index = nextChunk++) < chunks.size()) {
+        decodeChunk(chunks[index]);
+      }
+    }));
+  }
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+
+  FILE *output = outputPath != NULL ? fopen(outputPath, "wb") : stdout;
+  if (output == NULL) {
+    perror(outputPath);
+    return 1;
+  }
+  if (!binaryOutput && !frameOutput) {
+    fputs("device_id,msg_id,date,kind,id,index,minutes,temperature,day,hour,minute,crc_ok,bch_ok\n", output);
+  }
+  uint64_t records = 0, frames = 0, validFrames = 0, readings = 0;
+  for (size_t i = 0; i < chunks.size(); i++) {
+    fwrite(chunks[i].output.data(), 1, chunks[i].output.size(), output);
+    records += chunks[i].records;
+    frames += chunks[i].frames;
+    validFrames += chunks[i].validFrames;
+    readings += chunks[i].readings;
+  }
+  if (output != stdout ? fclose(output) != 0 : fflush(output) != 0) {
+    perror(outputPath != NULL ? outputPath : "stdout");
+    return 1;
+  }
+  for (size_t i = 0; i < files.size(); i++) {
+    if (files[i].size > 0) {
+      munmap((void *)files[i].data, files[i].size);
+    }
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fprintf(stderr, "%zu files, %.1f MB, %u threads, %zu chunks: %llu records, %llu frames, %llu with CRC16 and BCH32 ok, "
+    "%llu readings in %.3f s, %.0f MB/s\n", files.size(), totalSize / 1e6, threads, chunks.size(),
+    (unsigned long long)records, (unsigned long long)frames, (unsigned long long)validFrames,
+    (unsigned long long)readings, seconds, seconds > 0 ? totalSize / 1e6 / seconds : 0);
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*
+  Convert the binary log written by the transmitter (DATALOG.BIN on the SD card) back to text.
+
+  Prints one line per record, in the order they were logged:
+    28/02/2022 03:00:00 Reading 12: 8.25C (raw 531)
+    28/02/2022 03:00:00 Queued: <frame in hex>
+    28/02/2022 03:41:02 Sending: <frame in hex> sent
+  Zeros at the end of the last sector, not yet written, are skipped. Records failing their check
+  and gaps in the sequence numbers are reported on stderr. See Transmit/log_file_format.h for the
+  format.
+
+  Build (from the repository root):
+    make -C Tools log2text
+  Run:
+    Tools/build/log2text DATALOG.BIN > datalog.txt
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "log_file_format.h"
+#include "msg_kineis_std.h"
+
+// CRC-8 (polynomial 0x07) of the record, inverted, as Transmit/data_logger.cpp
+static uint8_t checkByte(const uint8_t *record) {
+  uint8_t crc = 0;
+  for (int i = 0; i < LOG_FILE_CHECK_OFFSET; i++) {
+    crc ^= record[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = crc & 0x80 ? (uint8_t)(crc << 1) ^ 0x07 : (uint8_t)(crc << 1);
+    }
+  }
+  return (uint8_t)~crc;
+}
+
+static uint32_t getLong(const uint8_t *bytes) {
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint16_t getShort(const uint8_t *bytes) {
+  return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+// Date of the Gregorian calendar of a day since 1970-01-01
+static void civilFromDays(long days, int *year, int *month, int *day) {
+  days += 719468;
+  long era = (days >= 0 ? days : days - 146096) / 146097;
+  long dayOfEra = days - era * 146097;
+  long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  long monthIndex = (5 * dayOfYear + 2) / 153;
+  *day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+  *month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+  *year = (int)(yearOfEra + era * 400 + (*month <= 2));
+}
+
+// As the text log of the transmitter: day/month/year hour:minute:second
+static void printTime(uint32_t time) {
+  int year, month, day;
+  civilFromDays((long)(time / 86400), &year, &month, &day);
+  printf("%02d/%02d/%04d %02d:%02d:%02d", day, month, year, (int)(time % 86400 / 3600), (int)(time % 3600 / 60), (int)(time % 60));
+}
+
+static void printFrame(const uint8_t *frame) {
+  for (int i = 0; i < ARGOS_FRAME_LENGTH; i++) {
+    printf("%02X", frame[i]);
+  }
+}
+
+static int isBlank(const uint8_t *record) {
+  for (int i = 0; i < LOG_FILE_RECORD_SIZE; i++) {
+    if (record[i] != 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void printRecord(const uint8_t *record) {
+  uint32_t time = getLong(&record[8]);
+  const uint8_t *frame = &record[LOG_FILE_FRAME_OFFSET];
+  printTime(time);
+  if (record[0] == LOG_FILE_READING) {
+    printf(" Reading %u: %.2fC (raw %u)\n", getLong(&record[4]), (int16_t)getShort(&record[12]) / 100.0, getShort(&record[2]));
+    if (record[1] & LOG_FILE_FRAME) {
+      printTime(time);
+      printf(" Queued: ");
+      printFrame(frame);
+      printf("\n");
+    }
+  } else if (record[0] == LOG_FILE_TRANSMISSION) {
+    printf(" Sending: ");
+    printFrame(frame);
+    printf(" %s\n", record[1] & LOG_FILE_SENT ? "sent" : "failed");
+  } else {
+    printf(" Unknown record type %u\n", record[0]);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s DATALOG.BIN\n", argv[0]);
+    return 1;
+  }
+  FILE *file = fopen(argv[1], "rb");
+  if (file == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+  uint8_t record[LOG_FILE_RECORD_SIZE];
+  uint32_t index = 0;
+  uint32_t expected = 0;
+  unsigned long records = 0, failed = 0, missing = 0;
+  size_t length;
+  while ((length = fread(record, 1, sizeof(record), file)) > 0) {
+    if (length < sizeof(record)) {
+      memset(record + length, 0, sizeof(record) - length);
+    }
+    if (isBlank(record)) {
+      index++;
+      continue;
+    }
+    if (record[LOG_FILE_CHECK_OFFSET] != checkByte(record)) {
+      fprintf(stderr, "record %u: failed its check\n", index);
+      failed++;
+      index++;
+      continue;
+    }
+    uint32_t sequence = getLong(&record[4]);
+    if (records > 0 && sequence != expected) {
+      fprintf(stderr, "record %u: sequence %u, %u expected\n", index, sequence, expected);
+      if (sequence > expected) {
+        missing += sequence - expected;
+      }
+    }
+    expected = sequence + 1;
+    printRecord(record);
+    records++;
+    index++;
+  }
+  fclose(file);
+  fprintf(stderr, "%lu records, %lu failed their check, %lu missing\n", records, failed, missing);
+  return failed > 0 ? 2 : 0;
+}
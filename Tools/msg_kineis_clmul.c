@@ -0,0 +1,354 @@
+/**
+ * @file    msg_kineis_clmul.c
+ * @brief   Bulk CRC16/BCH32 calculation and frame verification with carry-less multiply.
+ */
+
+/**
+ * @addtogroup MSG_KINEIS_CLMUL
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "msg_kineis_clmul.h"
+#include "msg_kineis_utils.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CLMUL_AVAILABLE		1
+#include <immintrin.h>
+#else
+#define CLMUL_AVAILABLE		0
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define BCH32_WIDTH			32
+#define CRC16_WIDTH			16
+#define CHUNK_WIDTH			64
+
+/** Independent frames in flight in the kernel */
+#define LANES				4
+
+/** Bytes of a frame covered by its CRC16 : from the 3rd byte to the BCH32 */
+#define CRC16_OFFSET_BYTE	2
+#define CRC16_LENGTH_BIT	(ARGOS_FRAME_LENGTH_BIT - CRC16_WIDTH - BCH32_WIDTH)
+#define CRC16_LENGTH_BYTE	(CRC16_LENGTH_BIT / 8)
+
+/* Private types -------------------------------------------------------------*/
+
+/** Barrett reduction constants of one polynomial P of degree width */
+typedef struct {
+	uint64_t mu;		//!< floor(x^(64 + width) / P) without its x^64 term
+	uint64_t poly;		//!< P without its x^width term
+	uint8_t width;
+} ClmulConstTypeDef_t;
+
+/* Private variables ---------------------------------------------------------*/
+static bool bDisabled = false;
+
+#if CLMUL_AVAILABLE
+
+static ClmulConstTypeDef_t bch32Const;
+static ClmulConstTypeDef_t crc16Const;
+static bool bConstReady = false;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void vInitConst(ClmulConstTypeDef_t *c, uint64_t poly, uint8_t width)
+{
+	unsigned __int128 fullPoly = ((unsigned __int128)1 << width) | poly;
+	unsigned __int128 remainder = (unsigned __int128)1 << (CHUNK_WIDTH + width);
+	uint64_t quotient = 0;
+	int8_t i;
+
+	//!< Long division: the x^64 term of the quotient is implicit
+	for (i = CHUNK_WIDTH; i >= 0; i--) {
+		if ((remainder >> (i + width)) & 1) {
+			if (i < CHUNK_WIDTH)
+				quotient |= (uint64_t)1 << i;
+			remainder ^= fullPoly << i;
+		}
+	}
+	c->mu = quotient;
+	c->poly = poly;
+	c->width = width;
+}
+
+static void vInitConsts(void)
+{
+	if (bConstReady)
+		return;
+	vInitConst(&bch32Const, BCH32_POLYNOMIAL, BCH32_WIDTH);
+	vInitConst(&crc16Const, CRC16_POLYNOMIAL, CRC16_WIDTH);
+	bConstReady = true;
+}
+
+__attribute__((target("pclmul,sse2")))
+static inline __m128i xClmul(uint64_t a, uint64_t b)
+{
+	return _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a),
+		_mm_cvtsi64_si128((long long)b), 0x00);
+}
+
+/*
+ * Fold 64 message bits into the remainder: R' = ((R.x^(64 - width) + D).x^width) mod P.
+ * With v = R.x^(64 - width) + D, the Barrett quotient is q = v + floor(v.mu / x^64) and the new
+ * remainder is the low part of q.poly.
+ */
+__attribute__((target("pclmul,sse2")))
+static inline uint32_t u32Fold(
+		uint32_t remainder,
+		uint64_t data,
+		uint64_t mu,
+		uint64_t poly,
+		uint8_t width)
+{
+	uint64_t v = ((uint64_t)remainder << (CHUNK_WIDTH - width)) ^ data;
+	__m128i product = xClmul(v, mu);
+	uint64_t q = v ^ (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(product, product));
+	uint64_t r = (uint64_t)_mm_cvtsi128_si64(xClmul(q, poly));
+
+	return (uint32_t)(r & (((uint64_t)1 << width) - 1));
+}
+
+static inline uint64_t u64LoadBE(const uint8_t *ptr)
+{
+	uint64_t value;
+
+	memcpy(&value, ptr, sizeof(value));
+	return __builtin_bswap64(value);
+}
+
+/* 64 bits starting at bit offsetBit, MSB first */
+static inline uint64_t u64LoadBits(const uint8_t *ptr, int16_t offsetBit)
+{
+	uint8_t shift = offsetBit & 7;
+	uint64_t value;
+
+	ptr += offsetBit >> 3;
+	value = u64LoadBE(ptr);
+	if (shift != 0)
+		value = (value << shift) | (ptr[8] >> (8 - shift));
+	return value;
+}
+
+/* First (lengthBit % 64) bits, right aligned: leading zeros do not change the remainder */
+static inline uint64_t u64LoadHead(const uint8_t *ptr, uint8_t headBit)
+{
+	uint8_t bytes = (headBit + 7) / 8;
+	uint64_t value = 0;
+	uint8_t i;
+
+	for (i = 0; i < bytes; i++)
+		value = (value << 8) | ptr[i];
+	return value >> (bytes * 8 - headBit);
+}
+
+/*
+ * Remainders of LANES messages of the same length. The lanes do not depend on each other, so
+ * their multiplies overlap in the pipeline. Callers repeat a message in unused lanes.
+ */
+__attribute__((target("pclmul,sse2"))) __attribute__((always_inline))
+static inline void vCalcLanes(
+		const uint8_t *ptr[LANES],
+		int16_t lengthBit,
+		const ClmulConstTypeDef_t *c,
+		uint8_t width,
+		uint32_t remainder[LANES])
+{
+	uint64_t mu = c->mu;
+	uint64_t poly = c->poly;
+	uint8_t headBit = lengthBit % CHUNK_WIDTH;
+	int16_t offsetBit;
+	uint8_t lane;
+
+	for (lane = 0; lane < LANES; lane++)
+		remainder[lane] = headBit == 0 ? 0 :
+			u32Fold(0, u64LoadHead(ptr[lane], headBit), mu, poly, width);
+
+	for (offsetBit = headBit; offsetBit < lengthBit; offsetBit += CHUNK_WIDTH)
+		for (lane = 0; lane < LANES; lane++)
+			remainder[lane] = u32Fold(remainder[lane], u64LoadBits(ptr[lane], offsetBit),
+				mu, poly, width);
+}
+
+__attribute__((target("pclmul,sse2")))
+static void vCalcFramesClmul(
+		const ArgosMsgTypeDef_t *frames,
+		uint32_t count,
+		uint8_t offsetByte,
+		int16_t lengthBit,
+		uint8_t width,
+		uint32_t *out32,
+		uint16_t *out16)
+{
+	const ClmulConstTypeDef_t *c = width == BCH32_WIDTH ? &bch32Const : &crc16Const;
+	const uint8_t *ptr[LANES];
+	uint32_t remainder[LANES];
+	uint32_t i;
+	uint8_t lanes;
+	uint8_t lane;
+
+	for (i = 0; i < count; i += lanes) {
+		lanes = count - i < LANES ? (uint8_t)(count - i) : LANES;
+		for (lane = 0; lane < LANES; lane++)
+			ptr[lane] = frames[i + (lane < lanes ? lane : 0)].payload + offsetByte;
+		if (width == BCH32_WIDTH)
+			vCalcLanes(ptr, lengthBit, c, BCH32_WIDTH, remainder);
+		else
+			vCalcLanes(ptr, lengthBit, c, CRC16_WIDTH, remainder);
+		for (lane = 0; lane < lanes; lane++) {
+			if (out32 != NULL)
+				out32[i + lane] = remainder[lane];
+			else
+				out16[i + lane] = (uint16_t)remainder[lane];
+		}
+	}
+}
+
+/* CRC16 and BCH32 remainders of LANES frames, see u32MSG_KINEIS_CLMUL_verifyFrames */
+__attribute__((target("pclmul,sse2")))
+static void vVerifyLanesClmul(
+		const uint8_t *crcPtr[LANES],
+		const uint8_t *framePtr[LANES],
+		uint32_t crcRemainder[LANES],
+		uint32_t bchRemainder[LANES])
+{
+	vCalcLanes(crcPtr, CRC16_LENGTH_BIT, &crc16Const, CRC16_WIDTH, crcRemainder);
+	vCalcLanes(framePtr, ARGOS_FRAME_LENGTH_BIT, &bch32Const, BCH32_WIDTH, bchRemainder);
+}
+
+#endif /* CLMUL_AVAILABLE */
+
+static bool bUseClmul(void)
+{
+#if CLMUL_AVAILABLE
+	if (bDisabled || !__builtin_cpu_supports("pclmul"))
+		return false;
+	vInitConsts();
+	return true;
+#else
+	return false;
+#endif
+}
+
+static inline uint16_t u16StoredCrc(const uint8_t *payload)
+{
+	return (uint16_t)(((payload[0] & 0x0f) << 12) | (payload[1] << 4) | (payload[2] >> 4));
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+bool bMSG_KINEIS_CLMUL_isSupported(void)
+{
+	return bUseClmul();
+}
+
+void vMSG_KINEIS_CLMUL_disable(bool disable)
+{
+	bDisabled = disable;
+}
+
+void vMSG_KINEIS_CLMUL_calcBch32Frames(
+		const ArgosMsgTypeDef_t *frames,
+		uint32_t count,
+		int16_t lengthBit,
+		uint32_t *bch)
+{
+	uint32_t i;
+
+#if CLMUL_AVAILABLE
+	if (bUseClmul() && lengthBit > 0) {
+		vCalcFramesClmul(frames, count, 0, lengthBit, BCH32_WIDTH, bch, NULL);
+		return;
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+		bch[i] = u32MSG_KINEIS_UTILS_calcBCH32(frames[i].payload, lengthBit);
+}
+
+void vMSG_KINEIS_CLMUL_calcCrc16Frames(
+		const ArgosMsgTypeDef_t *frames,
+		uint32_t count,
+		uint8_t offsetByte,
+		int16_t lengthBit,
+		uint16_t *crc)
+{
+	uint32_t i;
+
+#if CLMUL_AVAILABLE
+	if (bUseClmul() && lengthBit > 0) {
+		vCalcFramesClmul(frames, count, offsetByte, lengthBit, CRC16_WIDTH, NULL, crc);
+		return;
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+		crc[i] = u16MSG_KINEIS_UTILS_calcCRC16(frames[i].payload + offsetByte, lengthBit);
+}
+
+uint32_t u32MSG_KINEIS_CLMUL_verifyFrames(
+		const ArgosMsgTypeDef_t *frames,
+		uint32_t count,
+		uint8_t *status)
+{
+	uint8_t crcBuf[LANES][CRC16_LENGTH_BYTE];
+	uint32_t crcRemainder[LANES];
+	uint32_t bchRemainder[LANES];
+	uint32_t valid = 0;
+	uint32_t i;
+	uint8_t lanes;
+	uint8_t lane;
+	uint8_t flags;
+	bool clmul = bUseClmul();
+
+	for (i = 0; i < count; i += lanes) {
+		lanes = count - i < LANES ? (uint8_t)(count - i) : LANES;
+
+		//!< The low nibble of the CRC16 field was still clear when the CRC16 was computed
+		for (lane = 0; lane < lanes; lane++) {
+			memcpy(crcBuf[lane], frames[i + lane].payload + CRC16_OFFSET_BYTE,
+				CRC16_LENGTH_BYTE);
+			crcBuf[lane][0] &= 0x0f;
+		}
+
+#if CLMUL_AVAILABLE
+		if (clmul) {
+			const uint8_t *crcPtr[LANES];
+			const uint8_t *framePtr[LANES];
+
+			for (lane = 0; lane < LANES; lane++) {
+				crcPtr[lane] = crcBuf[lane < lanes ? lane : 0];
+				framePtr[lane] = frames[i + (lane < lanes ? lane : 0)].payload;
+			}
+			vVerifyLanesClmul(crcPtr, framePtr, crcRemainder, bchRemainder);
+		} else
+#endif
+		{
+			(void)clmul;
+			for (lane = 0; lane < lanes; lane++) {
+				crcRemainder[lane] = u16MSG_KINEIS_UTILS_calcCRC16(crcBuf[lane],
+					CRC16_LENGTH_BIT);
+				bchRemainder[lane] = u32MSG_KINEIS_UTILS_calcBCH32(
+					frames[i + lane].payload, ARGOS_FRAME_LENGTH_BIT);
+			}
+		}
+
+		for (lane = 0; lane < lanes; lane++) {
+			flags = 0;
+			if (crcRemainder[lane] == u16StoredCrc(frames[i + lane].payload))
+				flags |= MSG_KINEIS_CLMUL_CRC_OK;
+			if (bchRemainder[lane] == 0)
+				flags |= MSG_KINEIS_CLMUL_BCH_OK;
+			if (flags == (MSG_KINEIS_CLMUL_CRC_OK | MSG_KINEIS_CLMUL_BCH_OK))
+				valid++;
+			if (status != NULL)
+				status[i + lane] = flags;
+		}
+	}
+	return valid;
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,108 @@
+/**
+ * @file    msg_kineis_clmul.h
+ * @brief   Bulk CRC16/BCH32 calculation and frame verification with carry-less multiply.
+ *
+ * Host-side companion of msg_kineis_utils for re-verifying large frame archives. On x86 CPUs
+ * with PCLMULQDQ, 64 bits of each frame are folded per step with a Barrett reduction and four
+ * frames are interleaved so the multiplier pipeline stays busy. Other CPUs fall back to the
+ * table engines of msg_kineis_utils, giving the same results.
+ */
+#ifdef __cplusplus
+ extern "C" {
+#endif
+#ifndef MSG_KINEIS_CLMUL_H
+#define MSG_KINEIS_CLMUL_H
+
+/**
+ * @addtogroup MSG_KINEIS_CLMUL
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "msg_kineis_std.h"
+
+/* Defines -------------------------------------------------------------------*/
+
+/** Frame status bits returned by u32MSG_KINEIS_CLMUL_verifyFrames */
+#define MSG_KINEIS_CLMUL_CRC_OK		0x01
+#define MSG_KINEIS_CLMUL_BCH_OK		0x02
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Tell if the carry-less multiply kernel is used on this CPU.
+ *
+ * @return true when PCLMULQDQ is available, false when the table engines are used
+ */
+bool bMSG_KINEIS_CLMUL_isSupported(void);
+
+/**
+ * @brief Force the table engines, e.g. to compare both paths.
+ *
+ * @param[in] disable: true to never use the carry-less multiply kernel
+ */
+void vMSG_KINEIS_CLMUL_disable(bool disable);
+
+/**
+ * @brief Calculate the BCH32 of many frames.
+ *
+ * Same result as u32MSG_KINEIS_UTILS_calcBCH32(frames[i].payload, lengthBit) for each frame.
+ *
+ * @param[in] frames: Frames to process
+ * @param[in] count: Number of frames
+ * @param[in] lengthBit: Length in bit taken from the start of each payload
+ * @param[out] bch: One BCH32 per frame
+ */
+void vMSG_KINEIS_CLMUL_calcBch32Frames(
+		const ArgosMsgTypeDef_t *frames,
+		uint32_t count,
+		int16_t lengthBit,
+		uint32_t *bch);
+
+/**
+ * @brief Calculate the CRC16 of many frames.
+ *
+ * Same result as u16MSG_KINEIS_UTILS_calcCRC16(frames[i].payload + offsetByte, lengthBit)
+ * for each frame.
+ *
+ * @param[in] frames: Frames to process
+ * @param[in] count: Number of frames
+ * @param[in] offsetByte: First byte of each payload taken into account
+ * @param[in] lengthBit: Length in bit
+ * @param[out] crc: One CRC16 per frame
+ */
+void vMSG_KINEIS_CLMUL_calcCrc16Frames(
+		const ArgosMsgTypeDef_t *frames,
+		uint32_t count,
+		uint8_t offsetByte,
+		int16_t lengthBit,
+		uint16_t *crc);
+
+/**
+ * @brief Verify the CRC16 and BCH32 of many frames built by vMSGKINEIS_STDV1_setCRC16andBCH32.
+ *
+ * The CRC16 is recomputed with its own field cleared, as it was when the frame was encoded.
+ * The BCH32 is checked through the remainder of the whole frame, which is null for a valid
+ * frame.
+ *
+ * @param[in] frames: Frames to verify
+ * @param[in] count: Number of frames
+ * @param[out] status: One MSG_KINEIS_CLMUL_* bit set per frame, may be NULL
+ *
+ * @return Number of frames with both checks passed
+ */
+uint32_t u32MSG_KINEIS_CLMUL_verifyFrames(
+		const ArgosMsgTypeDef_t *frames,
+		uint32_t count,
+		uint8_t *status);
+
+/**
+ * @}
+ */
+
+#endif /* end MSG_KINEIS_CLMUL_H */
+#ifdef __cplusplus
+}
+#endif
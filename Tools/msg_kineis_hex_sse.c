@@ -0,0 +1,125 @@
+/**
+ * @file    msg_kineis_hex_sse.c
+ * @brief   Hexadecimal decoding of Argos payloads with SSE2.
+ */
+
+/**
+ * @addtogroup MSG_KINEIS_HEX_SSE
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "msg_kineis_hex_sse.h"
+#include "msg_kineis_std_decode.h"
+
+#if (defined(__x86_64__) || defined(__SSE2__)) && (defined(__GNUC__) || defined(__clang__))
+#define SSE2_AVAILABLE		1
+#include <emmintrin.h>
+#else
+#define SSE2_AVAILABLE		0
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define BLOCK_CHARS			16
+
+/* Private variables ---------------------------------------------------------*/
+static bool bDisabled = false;
+
+#if SSE2_AVAILABLE
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * Convert 16 characters to 8 bytes, false if one of them is not a digit.
+ * The digits are mapped with unsigned range checks: c - '0' within 0..9, or the lower case of c
+ * minus 'a' within 0..5.
+ */
+static inline bool bDecodeBlock(const char *hex, uint8_t *bytes)
+{
+	const __m128i text = _mm_loadu_si128((const __m128i *)hex);
+	const __m128i digit = _mm_sub_epi8(text, _mm_set1_epi8('0'));
+	const __m128i letter = _mm_sub_epi8(_mm_or_si128(text, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+	const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+	__m128i nibbles;
+	__m128i pairs;
+
+	if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF)
+		return false;
+
+	nibbles = _mm_or_si128(_mm_and_si128(isDigit, digit),
+		_mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+	//!< Each 16-bit lane holds the high nibble in its low byte and the low nibble above it
+	pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+		_mm_srli_epi16(nibbles, 8));
+	_mm_storel_epi64((__m128i *)bytes, _mm_packus_epi16(pairs, pairs));
+	return true;
+}
+
+static bool bFromHexSse2(const char *hex, uint16_t len, ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	char padded[BLOCK_CHARS];
+	uint16_t i;
+
+	if (len < BLOCK_CHARS) {
+		//!< Padded with zeros, cleared below with the rest of the payload
+		memset(padded, '0', sizeof(padded));
+		memcpy(padded, hex, len);
+		if (!bDecodeBlock(padded, ArgosMsgHandle->payload))
+			return false;
+	} else {
+		for (i = 0; i + BLOCK_CHARS <= len; i += BLOCK_CHARS) {
+			if (!bDecodeBlock(hex + i, ArgosMsgHandle->payload + i / 2))
+				return false;
+		}
+		//!< The last block overlaps the one before, its bytes are written twice
+		if (i < len && !bDecodeBlock(hex + len - BLOCK_CHARS, ArgosMsgHandle->payload + (len - BLOCK_CHARS) / 2))
+			return false;
+	}
+
+	memset(ArgosMsgHandle->payload + len / 2, 0, ARGOS_FRAME_LENGTH - len / 2);
+	return true;
+}
+
+#endif /* SSE2_AVAILABLE */
+
+static bool bUseSse2(void)
+{
+#if SSE2_AVAILABLE
+	return !bDisabled;
+#else
+	return false;
+#endif
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+bool bMSG_KINEIS_HEX_isSupported(void)
+{
+	return bUseSse2();
+}
+
+void vMSG_KINEIS_HEX_disable(bool disable)
+{
+	bDisabled = disable;
+}
+
+bool bMSG_KINEIS_HEX_fromHex(
+		const char *hex,
+		uint16_t len,
+		ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	if (ArgosMsgHandle == NULL || hex == NULL || len % 2 || len > ARGOS_FRAME_HEX_LENGTH)
+		return false;
+
+#if SSE2_AVAILABLE
+	if (bUseSse2())
+		return bFromHexSse2(hex, len, ArgosMsgHandle);
+#endif
+	return bMSGKINEIS_STDV1_fromHex(hex, len, ArgosMsgHandle);
+}
+
+/**
+ * @}
+ */
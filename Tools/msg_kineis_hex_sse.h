@@ -0,0 +1,65 @@
+/**
+ * @file    msg_kineis_hex_sse.h
+ * @brief   Hexadecimal decoding of Argos payloads with SSE2.
+ *
+ * Host-side companion of msg_kineis_std_decode for ground ingest of exported frames. On x86 CPUs
+ * 16 characters are checked and converted at a time, the last block overlapping the one before
+ * it. Other CPUs fall back to bMSGKINEIS_STDV1_fromHex, giving the same results.
+ */
+#ifdef __cplusplus
+ extern "C" {
+#endif
+#ifndef MSG_KINEIS_HEX_SSE_H
+#define MSG_KINEIS_HEX_SSE_H
+
+/**
+ * @addtogroup MSG_KINEIS_HEX_SSE
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "msg_kineis_std.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Tell if the SSE2 kernel is used on this CPU.
+ *
+ * @return true on x86 CPUs, false when bMSGKINEIS_STDV1_fromHex is used
+ */
+bool bMSG_KINEIS_HEX_isSupported(void);
+
+/**
+ * @brief Force the scalar decoder, e.g. to compare both paths.
+ *
+ * @param[in] disable: true to never use the SSE2 kernel
+ */
+void vMSG_KINEIS_HEX_disable(bool disable);
+
+/**
+ * @brief Convert the hexadecimal text of a payload.
+ *
+ * Same result as bMSGKINEIS_STDV1_fromHex(hex, len, ArgosMsgHandle): upper or lower case
+ * digits, an even length up to ARGOS_FRAME_HEX_LENGTH, the end of a shorter payload cleared.
+ *
+ * @param[in] hex: Hexadecimal characters
+ * @param[in] len: Number of characters
+ * @param[out] ArgosMsgHandle: Argos message, undefined when false is returned
+ *
+ * @return false if the text is not a payload
+ */
+bool bMSG_KINEIS_HEX_fromHex(
+		const char *hex,
+		uint16_t len,
+		ArgosMsgTypeDef_t *ArgosMsgHandle);
+
+/**
+ * @}
+ */
+
+#endif /* end MSG_KINEIS_HEX_SSE_H */
+#ifdef __cplusplus
+}
+#endif
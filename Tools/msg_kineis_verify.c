@@ -0,0 +1,254 @@
+/**
+ * @file    msg_kineis_verify.c
+ * @brief   Parallel verification and repair of frame archives.
+ */
+
+/**
+ * @addtogroup MSG_KINEIS_VERIFY
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "msg_kineis_utils.h"
+#include "msg_kineis_verify.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STATUS_CHECKS	(MSG_KINEIS_VERIFY_CRC_OK | MSG_KINEIS_VERIFY_BCH_OK)
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct VerifyJobTypeDef_t VerifyJobTypeDef_t;
+
+/** A thread and the blocks left to it, [next, end) */
+typedef struct {
+	pthread_mutex_t lock;
+	uint64_t next;
+	uint64_t end;
+	pthread_t thread;
+	VerifyJobTypeDef_t *job;
+	uint16_t index;
+	MsgKineisVerifyStatsTypeDef_t stats;
+} VerifyWorkerTypeDef_t;
+
+struct VerifyJobTypeDef_t {
+	ArgosMsgTypeDef_t *frames;
+	uint64_t count;
+	bool repair;
+	uint8_t *status;
+	uint16_t workerCount;
+	VerifyWorkerTypeDef_t *workers;
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/** Repair a frame failing its BCH32, kept only when its CRC16 then matches too */
+static uint8_t u8Repair(ArgosMsgTypeDef_t *frame, uint8_t status, MsgKineisVerifyStatsTypeDef_t *stats)
+{
+	int16_t errorBit[2];
+	int8_t corrected;
+	uint8_t repaired;
+	uint8_t i;
+
+	corrected = s8MSG_KINEIS_UTILS_correctBch32(frame->payload, ARGOS_FRAME_LENGTH_BIT, errorBit);
+	if (corrected <= 0)
+		return status | MSG_KINEIS_VERIFY_UNCORRECTABLE;
+
+	u32MSG_KINEIS_CLMUL_verifyFrames(frame, 1, &repaired);
+	if (!(repaired & MSG_KINEIS_VERIFY_CRC_OK)) {
+		//!< More errors than the BCH32 can correct, undo the wrong correction
+		for (i = 0; i < corrected; i++)
+			frame->payload[errorBit[i] >> 3] ^= (uint8_t)(0x80 >> (errorBit[i] & 0x7));
+		return status | MSG_KINEIS_VERIFY_UNCORRECTABLE;
+	}
+
+	for (i = 0; i < corrected; i++)
+		stats->errorBits[errorBit[i]]++;
+	stats->corrected[corrected - 1]++;
+	return repaired | (corrected == 1 ? MSG_KINEIS_VERIFY_CORRECTED_1 : MSG_KINEIS_VERIFY_CORRECTED_2);
+}
+
+static void vVerifyBlock(VerifyJobTypeDef_t *job, uint64_t block, MsgKineisVerifyStatsTypeDef_t *stats)
+{
+	uint8_t status[MSG_KINEIS_VERIFY_BLOCK_FRAMES];
+	uint64_t first = block * MSG_KINEIS_VERIFY_BLOCK_FRAMES;
+	uint32_t count = job->count - first < MSG_KINEIS_VERIFY_BLOCK_FRAMES ?
+		(uint32_t)(job->count - first) : MSG_KINEIS_VERIFY_BLOCK_FRAMES;
+	uint32_t i;
+
+	u32MSG_KINEIS_CLMUL_verifyFrames(job->frames + first, count, status);
+	for (i = 0; i < count; i++) {
+		if (!(status[i] & MSG_KINEIS_VERIFY_BCH_OK)) {
+			if (job->repair)
+				status[i] = u8Repair(&job->frames[first + i], status[i], stats);
+			else
+				status[i] |= MSG_KINEIS_VERIFY_UNCORRECTABLE;
+		}
+		if (status[i] & MSG_KINEIS_VERIFY_CRC_OK)
+			stats->crcOk++;
+		if (status[i] & MSG_KINEIS_VERIFY_BCH_OK)
+			stats->bchOk++;
+		if ((status[i] & STATUS_CHECKS) == STATUS_CHECKS)
+			stats->valid++;
+		if (status[i] & MSG_KINEIS_VERIFY_UNCORRECTABLE)
+			stats->uncorrectable++;
+	}
+	stats->frames += count;
+	stats->blocks++;
+	if (job->status != NULL)
+		memcpy(job->status + first, status, count);
+}
+
+/** Next block of the worker, false when it has none left */
+static bool bTakeBlock(VerifyWorkerTypeDef_t *worker, uint64_t *block)
+{
+	bool taken;
+
+	pthread_mutex_lock(&worker->lock);
+	taken = worker->next < worker->end;
+	if (taken)
+		*block = worker->next++;
+	pthread_mutex_unlock(&worker->lock);
+	return taken;
+}
+
+/** Take the second half of the blocks left to another worker, false when none has any */
+static bool bSteal(VerifyWorkerTypeDef_t *worker)
+{
+	VerifyJobTypeDef_t *job = worker->job;
+	VerifyWorkerTypeDef_t *victim;
+	uint64_t left;
+	uint64_t end;
+	uint16_t i;
+
+	for (i = 1; i < job->workerCount; i++) {
+		victim = &job->workers[(worker->index + i) % job->workerCount];
+		pthread_mutex_lock(&victim->lock);
+		left = victim->end - victim->next;
+		end = victim->end;
+		victim->end -= (left + 1) / 2;
+		pthread_mutex_unlock(&victim->lock);
+		if (left == 0)
+			continue;
+		pthread_mutex_lock(&worker->lock);
+		worker->next = end - (left + 1) / 2;
+		worker->end = end;
+		pthread_mutex_unlock(&worker->lock);
+		worker->stats.steals++;
+		return true;
+	}
+	return false;
+}
+
+static void *pvWorker(void *argument)
+{
+	VerifyWorkerTypeDef_t *worker = (VerifyWorkerTypeDef_t *)argument;
+	uint64_t block;
+
+	do {
+		while (bTakeBlock(worker, &block))
+			vVerifyBlock(worker->job, block, &worker->stats);
+	} while (bSteal(worker));
+	return NULL;
+}
+
+static void vAddStats(MsgKineisVerifyStatsTypeDef_t *total, const MsgKineisVerifyStatsTypeDef_t *stats)
+{
+	uint16_t i;
+
+	total->frames += stats->frames;
+	total->crcOk += stats->crcOk;
+	total->bchOk += stats->bchOk;
+	total->valid += stats->valid;
+	total->corrected[0] += stats->corrected[0];
+	total->corrected[1] += stats->corrected[1];
+	total->uncorrectable += stats->uncorrectable;
+	for (i = 0; i < ARGOS_FRAME_LENGTH_BIT; i++)
+		total->errorBits[i] += stats->errorBits[i];
+	total->blocks += stats->blocks;
+	total->steals += stats->steals;
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+uint16_t u16MSG_KINEIS_VERIFY_defaultThreads(void)
+{
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return cores < 1 ? 1 : cores > UINT16_MAX ? UINT16_MAX : (uint16_t)cores;
+}
+
+uint64_t u64MSG_KINEIS_VERIFY_frames(
+		ArgosMsgTypeDef_t *frames,
+		uint64_t count,
+		bool repair,
+		uint16_t threads,
+		uint8_t *status,
+		MsgKineisVerifyStatsTypeDef_t *stats)
+{
+	VerifyJobTypeDef_t job;
+	MsgKineisVerifyStatsTypeDef_t total;
+	uint64_t blocks = (count + MSG_KINEIS_VERIFY_BLOCK_FRAMES - 1) / MSG_KINEIS_VERIFY_BLOCK_FRAMES;
+	uint16_t started;
+	uint16_t i;
+
+	if (threads == 0)
+		threads = u16MSG_KINEIS_VERIFY_defaultThreads();
+	if (threads > blocks)
+		threads = blocks > 0 ? (uint16_t)blocks : 1;
+
+	//!< Tables built on first use, before the threads share them
+	bMSG_KINEIS_CLMUL_isSupported();
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	vMSG_KINEIS_UTILS_initSlice8();
+#endif
+	if (repair)
+		vMSG_KINEIS_UTILS_initBch32Correct();
+
+	job.frames = frames;
+	job.count = count;
+	job.repair = repair;
+	job.status = status;
+	job.workerCount = threads;
+	job.workers = (VerifyWorkerTypeDef_t *)calloc(threads, sizeof(VerifyWorkerTypeDef_t));
+	memset(&total, 0, sizeof(total));
+	if (job.workers == NULL)
+		threads = 0;
+
+	//!< Blocks shared out evenly to start with
+	for (i = 0; i < threads; i++) {
+		pthread_mutex_init(&job.workers[i].lock, NULL);
+		job.workers[i].next = blocks * i / threads;
+		job.workers[i].end = blocks * (i + 1) / threads;
+		job.workers[i].job = &job;
+		job.workers[i].index = i;
+	}
+	//!< The calling thread is the first worker
+	for (started = 1; started < threads; started++) {
+		if (pthread_create(&job.workers[started].thread, NULL, pvWorker, &job.workers[started]) != 0)
+			break;
+	}
+	//!< Workers which could not be started have their blocks stolen
+	if (threads > 0)
+		pvWorker(&job.workers[0]);
+	for (i = 1; i < started; i++)
+		pthread_join(job.workers[i].thread, NULL);
+
+	for (i = 0; i < threads; i++) {
+		vAddStats(&total, &job.workers[i].stats);
+		pthread_mutex_destroy(&job.workers[i].lock);
+	}
+	total.threads = started;
+	free(job.workers);
+
+	if (stats != NULL)
+		*stats = total;
+	return total.valid;
+}
+
+/**
+ * @}
+ */
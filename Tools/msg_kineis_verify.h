@@ -0,0 +1,96 @@
+/**
+ * @file    msg_kineis_verify.h
+ * @brief   Parallel verification and repair of frame archives.
+ *
+ * Host-side companion of msg_kineis_clmul for re-verifying whole archives, e.g. after a layout or
+ * firmware change. Frames are cut into blocks shared out between threads, one per core by
+ * default. A thread which runs out of blocks steals half of the blocks left to another, so all
+ * threads stay busy to the end. Each block is verified with u32MSG_KINEIS_CLMUL_verifyFrames and
+ * frames failing their BCH32 may be repaired with s8MSG_KINEIS_UTILS_correctBch32.
+ */
+#ifdef __cplusplus
+ extern "C" {
+#endif
+#ifndef MSG_KINEIS_VERIFY_H
+#define MSG_KINEIS_VERIFY_H
+
+/**
+ * @addtogroup MSG_KINEIS_VERIFY
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "msg_kineis_clmul.h"
+#include "msg_kineis_std.h"
+
+/* Defines -------------------------------------------------------------------*/
+
+/** Frame status bits of u64MSG_KINEIS_VERIFY_frames, the checks are those of the frame as left */
+#define MSG_KINEIS_VERIFY_CRC_OK		MSG_KINEIS_CLMUL_CRC_OK
+#define MSG_KINEIS_VERIFY_BCH_OK		MSG_KINEIS_CLMUL_BCH_OK
+#define MSG_KINEIS_VERIFY_CORRECTED_1	0x04	//!< 1 bit repaired
+#define MSG_KINEIS_VERIFY_CORRECTED_2	0x08	//!< 2 bits repaired
+#define MSG_KINEIS_VERIFY_UNCORRECTABLE	0x10	//!< BCH32 failed and could not be repaired
+
+/** Frames per block shared out between the threads */
+#define MSG_KINEIS_VERIFY_BLOCK_FRAMES	1024
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Aggregate statistics of a verification */
+typedef struct {
+	uint64_t frames;
+	uint64_t crcOk;				//!< CRC16 matches, after any repair
+	uint64_t bchOk;				//!< BCH32 matches, after any repair
+	uint64_t valid;				//!< Both match
+	uint64_t corrected[2];		//!< Frames repaired with 1 and 2 bits
+	uint64_t uncorrectable;		//!< Frames whose BCH32 failed and were not repaired
+	uint64_t errorBits[ARGOS_FRAME_LENGTH_BIT];	//!< Repaired bits by position in the frame
+	uint32_t threads;
+	uint32_t blocks;
+	uint32_t steals;			//!< Ranges of blocks taken from another thread
+} MsgKineisVerifyStatsTypeDef_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Threads used by default: one per online core.
+ *
+ * @return Number of threads, at least 1
+ */
+uint16_t u16MSG_KINEIS_VERIFY_defaultThreads(void);
+
+/**
+ * @brief Verify, and repair if asked, the CRC16 and BCH32 of many frames.
+ *
+ * The CRC16 and BCH32 are checked as by u32MSG_KINEIS_CLMUL_verifyFrames. With repair, frames
+ * failing their BCH32 are corrected in place when 1 or 2 bits are wrong and the CRC16 then
+ * matches, else they are left as they were and marked uncorrectable.
+ *
+ * @param[in,out] frames: Frames to verify, only changed when repair is true
+ * @param[in] count: Number of frames
+ * @param[in] repair: true to repair the frames failing their BCH32
+ * @param[in] threads: Threads to use, 0 for u16MSG_KINEIS_VERIFY_defaultThreads()
+ * @param[out] status: One MSG_KINEIS_VERIFY_* bit set per frame, may be NULL
+ * @param[out] stats: Aggregate statistics, may be NULL
+ *
+ * @return Number of frames with both checks passed, after any repair
+ */
+uint64_t u64MSG_KINEIS_VERIFY_frames(
+		ArgosMsgTypeDef_t *frames,
+		uint64_t count,
+		bool repair,
+		uint16_t threads,
+		uint8_t *status,
+		MsgKineisVerifyStatsTypeDef_t *stats);
+
+/**
+ * @}
+ */
+
+#endif /* end MSG_KINEIS_VERIFY_H */
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+/*
+  Convert a Prepas satellite pass prediction to the binary schedule read by SdPassSchedule.
+
+  The input is the text output of Prepas, or a copy of the pass list of the Argos web site,
+  with one pass per line:
+    <satellite> <date> <start time> <duration or end time> [other columns]
+  for example
+    MA 2022/02/28 02:59:01 122 ...
+    NP 2022-02-28 03:40:33 03:42:31 ...
+  The date is year/month/day (or year-month-day) and times are UTC. A duration is in seconds and
+  may be followed by "s". An end time before the start time is taken on the next day. Other lines
+  (headers, blank lines) are skipped. See Transmit/pass_file_format.h for the output format.
+
+  Build (from the repository root):
+    cc -O2 -ITransmit -o prepas2bin Tools/prepas2bin.c
+  Run:
+    ./prepas2bin Prepas.txt PASSES.BIN
+  then copy PASSES.BIN to the root of the SD card.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pass_file_format.h"
+
+#define SECONDS_PER_DAY 86400L
+
+typedef struct {
+  uint32_t start;
+  uint16_t duration;
+  uint8_t satellite;
+} PassRecord;
+
+static const char *satelliteCodes[] = PASS_FILE_SATELLITES;
+
+// Days since 1970-01-01 of a date of the Gregorian calendar
+static long daysFromCivil(int year, int month, int day) {
+  year -= month <= 2;
+  long era = (year >= 0 ? year : year - 399) / 400;
+  long yearOfEra = year - era * 400;
+  long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+static uint8_t satelliteId(const char *code) {
+  for (size_t i = 0; i < sizeof(satelliteCodes) / sizeof(satelliteCodes[0]); i++) {
+    if (strcmp(code, satelliteCodes[i]) == 0) {
+      return (uint8_t)i;
+    }
+  }
+  return PASS_FILE_UNKNOWN_SATELLITE;
+}
+
+static int parseLine(const char *line, PassRecord *record) {
+  char code[8], last[16];
+  int year, month, day, hour, minute, second;
+  char separator1, separator2;
+
+  if (sscanf(line, "%7s %d%c%d%c%d %d:%d:%d %15s", code, &year, &separator1, &month, &separator2,
+      &day, &hour, &minute, &second, last) != 10 ||
+      separator1 != separator2 || (separator1 != '/' && separator1 != '-') ||
+      month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+    return 0;
+  }
+
+  long start = daysFromCivil(year, month, day) * SECONDS_PER_DAY + hour * 3600L + minute * 60L + second;
+  long duration;
+  int endHour, endMinute, endSecond;
+  if (sscanf(last, "%d:%d:%d", &endHour, &endMinute, &endSecond) == 3) {
+    duration = (endHour * 3600L + endMinute * 60L + endSecond) - (hour * 3600L + minute * 60L + second);
+    if (duration < 0) {
+      duration += SECONDS_PER_DAY;
+    }
+  } else {
+    char *end;
+    duration = strtol(last, &end, 10);
+    if (end == last || (*end != '\0' && strcmp(end, "s") != 0)) {
+      return 0;
+    }
+  }
+  if (start < 0 || start > 0xFFFFFFFFL || duration < 0 || duration > (long)PASS_FILE_MAX_DURATION) {
+    return 0;
+  }
+
+  record->start = (uint32_t)start;
+  record->duration = (uint16_t)duration;
+  record->satellite = satelliteId(code);
+  return 1;
+}
+
+static int compareRecords(const void *a, const void *b) {
+  const PassRecord *first = a, *second = b;
+  if (first->start != second->start) {
+    return first->start < second->start ? -1 : 1;
+  }
+  return (int)first->duration - (int)second->duration;
+}
+
+static void putLittleEndian(uint8_t *bytes, uint32_t value, int length) {
+  for (int i = 0; i < length; i++) {
+    bytes[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <prepas text> <binary schedule>\n", argv[0]);
+    return 2;
+  }
+  FILE *input = fopen(argv[1], "r");
+  if (input == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  PassRecord *records = NULL;
+  size_t count = 0, capacity = 0, skipped = 0;
+  char line[512];
+  while (fgets(line, sizeof(line), input) != NULL) {
+    PassRecord record;
+    if (!parseLine(line, &record)) {
+      skipped++;
+      continue;
+    }
+    if (count == capacity) {
+      capacity = capacity ? capacity * 2 : 256;
+      records = realloc(records, capacity * sizeof(PassRecord));
+      if (records == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+      }
+    }
+    records[count++] = record;
+  }
+  fclose(input);
+  qsort(records, count, sizeof(PassRecord), compareRecords);
+
+  FILE *output = fopen(argv[2], "wb");
+  if (output == NULL) {
+    perror(argv[2]);
+    return 1;
+  }
+  uint8_t header[PASS_FILE_HEADER_SIZE] = { 0 };
+  memcpy(header, PASS_FILE_MAGIC, 4);
+  header[4] = PASS_FILE_VERSION;
+  header[5] = PASS_FILE_RECORD_SIZE;
+  putLittleEndian(&header[8], (uint32_t)count, 4);
+  fwrite(header, sizeof(header), 1, output);
+  for (size_t i = 0; i < count; i++) {
+    uint8_t bytes[PASS_FILE_RECORD_SIZE];
+    putLittleEndian(&bytes[0], records[i].start, 4);
+    putLittleEndian(&bytes[4], records[i].duration, 2);
+    bytes[6] = records[i].satellite;
+    fwrite(bytes, sizeof(bytes), 1, output);
+  }
+  if (fclose(output) != 0) {
+    perror(argv[2]);
+    return 1;
+  }
+  printf("%zu passes written, %zu lines skipped\n", count, skipped);
+  free(records);
+  return 0;
+}
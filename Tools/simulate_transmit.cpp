@@ -0,0 +1,298 @@
+/*
+  Host simulation of the transmitter sketch, Transmit/transmit.ino.
+
+  The sketch is built as it is against the stand-ins of Tools/host for the RTC, the SD card, the
+  KIM1 module and the Arduino core. Time runs on a virtual clock moved on by delay(), by the sleeps
+  on the RTC countdown timer and by each transmission, so days of operation run in milliseconds. The
+  temperature follows a daily cycle.
+  Reports the readings taken, the frames queued and sent, the frames sent inside and outside the
+  pass windows of the schedule the sketch uses, the largest backlog and the frames dropped, the
+  charge drawn while awake, asleep and transmitting, and the use of the SD card.
+  The built in passes cover 2022-02-28 and 2022-03-01: copy a PASSES.BIN (see Tools/prepas2bin.c) or
+  an ELEMENTS.TXT to the simulated card for longer runs.
+  The reading interval can be set for the build, e.g. -DreadingIntervalMinutes=30, as can the longest
+  wait of packed readings for a pass, e.g. -DmaxReadingDelayHours=3.
+
+  Build (from the repository root):
+    make -C Tools simulate_transmit
+  Run:
+    Tools/build/simulate_transmit [-d days] [-s start time] [-k transmission ms] [-m awake,asleep,transmitting mA]
+      [-l log file] [-f] [-v] [files for the SD card]
+  -d: days to run, by default until the last built in pass
+  -s: start, in seconds since 1970-01-01, by default the day of the first built in pass
+  -k: time the KIM1 module takes to send a frame, 1000 ms by default
+  -m: current drawn by the board, 20,0.5,500 mA by default
+  -l: copy of the binary log of the sketch (DATALOG.BIN) at the end, see Tools/log2text.c
+  -f: SD card writes fail, the frames are then kept in memory
+  -v: show the serial output of the sketch
+*/
+
+#include <Arduino.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "RTClib.h"
+#include "KIM.h"
+#include "SD.h"
+#include "msg_kineis_fec.h"
+#include "msg_kineis_packed.h"
+#include "msg_kineis_std.h"
+#include "msg_kineis_std_decode.h"
+#include "satellite_pass.h"
+
+// Prototypes of the functions of the sketch, as the Arduino builder generates them
+uint32_t pendingMessages();
+bool peekMessage(uint8_t offset, ArgosMsgTypeDef_t &message);
+void removeSentMessages(uint8_t count);
+bool currentPass(SatellitePass &pass);
+bool canTransmit();
+bool canWaitForNextPass(uint32_t firstTime, uint8_t maxDelayHours);
+void createSatelliteMessage(ArgosMsgTypeDef_t &message, uint8_t day, uint8_t hour, uint8_t min, const uint8_t userdata[USER_DATA_LENGTH]);
+void createPackedMessage(ArgosMsgTypeDef_t &message);
+bool addPackedReading(ArgosMsgTypeDef_t &message, const DateTime &now, int16_t temperature);
+void protectMessage(const ArgosMsgTypeDef_t &message);
+void closeParityGroup();
+void queueRecord(const uint8_t *data, uint16_t length);
+void queueMessage(const ArgosMsgTypeDef_t &message);
+bool loadOrbitalElements(const char *filename);
+void initialiseSdCard();
+void initialiseHardware();
+void initialiseSatellite();
+
+#include "../Transmit/transmit.ino"
+
+#define MEAN_TEMPERATURE 8.0
+#define DAILY_SWING 6.0
+#define WARMEST_HOUR 15
+// Current drawn by the board and the KIM1 module, in mA
+#define AWAKE_MA 20.0
+#define ASLEEP_MA 0.5
+#define TRANSMITTING_MA 500.0
+
+struct Transmission {
+  uint32_t time;
+  std::string frame;
+  bool inPass;
+};
+
+static PassSchedule *reference;
+static std::vector<Transmission> transmissions;
+static std::vector<uint32_t> readingTimes;
+
+// Daily temperature cycle, read through the thermistor of the sketch
+static int temperatureReading(uint8_t) {
+  uint32_t now = hostClockNow();
+  // The sketch takes THERMISTOR_SAMPLES samples per reading
+  if (readingTimes.empty() || readingTimes.back() != now) {
+    readingTimes.push_back(now);
+  }
+  double temperature = MEAN_TEMPERATURE + DAILY_SWING * cos(2 * M_PI * ((now % 86400) / 3600.0 - WARMEST_HOUR) / 24);
+  // The value closest to the temperature, which rises with the analogue value
+  int low = 1;
+  int high = 1023;
+  while (low < high) {
+    int middle = (low + high) / 2;
+    if (Thermistor::centiDegrees(middle << THERMISTOR_EXTRA_BITS) < temperature * 100) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// The RTC pulls its INT/SQW output low when the countdown timer runs out
+static int pinLevel(uint8_t pin) {
+  return pin == rtcInterruptPin && hostRtcInterrupt() ? LOW : HIGH;
+}
+
+// Readings a frame carries: those packed in it, one for a text message, none for the other
+// frames (parity, fragments)
+static uint32_t frameReadings(const std::string &frame) {
+  ArgosMsgTypeDef_t message;
+  ArgosDecodedMsgTypeDef_t decoded;
+  ArgosPackedReadingsTypeDef_t readings;
+  if (!bMSGKINEIS_STDV1_fromHex(frame.c_str(), frame.length(), &message) || !bMSGKINEIS_STDV1_decode(&message, &decoded)) {
+    return 0;
+  }
+  if (decoded.acqPeriod != USER_MSG) {
+    return 0;
+  }
+  if (bMSGKINEIS_PACKED_isPacked(decoded.userData)) {
+    return bMSGKINEIS_PACKED_fromUserData(decoded.userData, &readings) ? readings.count : 0;
+  }
+  return 1;
+}
+
+// Parity frames carry FEC_TAG in place of the AcqPeriod, see msg_kineis_fec.h
+static bool isParityFrame(const std::string &frame) {
+  ArgosMsgTypeDef_t message;
+  return bMSGKINEIS_STDV1_fromHex(frame.c_str(), frame.length(), &message) && (message.payload[2] & 0x0F) == FEC_TAG;
+}
+
+// A transmission is inside a pass when it starts and ends inside it
+static void transmission(const char *data, uint8_t length) {
+  uint32_t start = hostClockNow();
+  uint32_t end = start + (hostKimSendMillis + 999) / 1000;
+  SatellitePass pass;
+  bool inPass = reference->findPass(start, pass) && pass.isInRange(start) && pass.isInRange(end);
+  transmissions.push_back(Transmission { start, std::string(data, length), inPass });
+}
+
+static bool saveSdFile(const char *name, const char *path) {
+  const std::vector<uint8_t> *data = SD.hostFile(name);
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  bool saved = data == NULL || fwrite(data->data(), 1, data->size(), file) == data->size();
+  return fclose(file) == 0 && saved;
+}
+
+static bool loadSdFile(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + length);
+  }
+  fclose(file);
+  const char *name = strrchr(path, '/');
+  SD.hostAddFile(name != NULL ? name + 1 : path, data);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  uint32_t start = satellitePassTimes[0] - satellitePassTimes[0] % 86400;
+  uint32_t end = satellitePassTimes[SATELLITE_PASS_COUNT * 2 - 1] + 1;
+  double days = 0;
+  const char *logPath = NULL;
+  double awakeMa = AWAKE_MA;
+  double asleepMa = ASLEEP_MA;
+  double transmittingMa = TRANSMITTING_MA;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      days = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      start = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+      hostKimSendMillis = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+      if (sscanf(argv[++i], "%lf,%lf,%lf", &awakeMa, &asleepMa, &transmittingMa) != 3) {
+        fprintf(stderr, "-m: awake, asleep and transmitting current in mA, e.g. 20,0.5,500\n");
+        return 1;
+      }
+    } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+      logPath = argv[++i];
+    } else if (strcmp(argv[i], "-f") == 0) {
+      hostSdFailWrites = true;
+    } else if (strcmp(argv[i], "-v") == 0) {
+      hostSerialEcho = true;
+    } else if (argv[i][0] == '-' || !loadSdFile(argv[i])) {
+      fprintf(stderr, "usage: %s [-d days] [-s start time] [-k transmission ms] [-m awake,asleep,transmitting mA] [-l log file] [-f] [-v] [files for the SD card]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (days > 0) {
+    end = start + (uint32_t)(days * 86400);
+  }
+
+  hostClockStart = start;
+  hostAnalogRead = temperatureReading;
+  hostKimSend = transmission;
+  hostDigitalRead = pinLevel;
+  setup();
+
+  // Passes of the schedule the sketch loaded, looked up separately as the schedules keep a cursor
+  FlashPassSchedule flashReference(satellitePassTimes, SATELLITE_PASS_COUNT);
+  SdPassSchedule sdReference("PASSES.BIN");
+  reference = passSchedule;
+  if (passSchedule == &flashPassSchedule) {
+    reference = &flashReference;
+  } else if (passSchedule == &sdPassSchedule && sdReference.begin()) {
+    reference = &sdReference;
+  }
+
+  uint32_t mostPending = 0;
+  uint32_t loops = 0;
+  while (hostClockNow() < end) {
+    loop();
+    loops++;
+    if (pendingMessages() > mostPending) {
+      mostPending = pendingMessages();
+    }
+  }
+  uint32_t simulated = hostClockNow() - start;
+
+  std::set<std::string> framesSent;
+  std::set<std::string> framesSentInPass;
+  std::set<uint32_t> passesUsed;
+  uint32_t sentInPass = 0;
+  uint32_t readingsSent = 0;
+  uint32_t readingFramesSent = 0;
+  uint32_t readingTransmissions = 0;
+  uint32_t parityFramesSent = 0;
+  for (size_t i = 0; i < transmissions.size(); i++) {
+    framesSent.insert(transmissions[i].frame);
+    SatellitePass pass;
+    if (transmissions[i].inPass && reference->findPass(transmissions[i].time, pass)) {
+      sentInPass++;
+      uint32_t readings = frameReadings(transmissions[i].frame);
+      readingTransmissions += readings > 0;
+      if (framesSentInPass.insert(transmissions[i].frame).second) {
+        readingsSent += readings;
+        readingFramesSent += readings > 0;
+        parityFramesSent += isParityFrame(transmissions[i].frame);
+      }
+      passesUsed.insert(pass.startTime());
+    }
+  }
+  uint32_t passes = 0;
+  uint32_t passSeconds = 0;
+  SatellitePass pass;
+  for (bool found = reference->findPass(start, pass); found && pass.startTime() < end; found = reference->nextPass(pass.startTime(), pass)) {
+    passes++;
+    passSeconds += (pass.endTime() < end ? pass.endTime() : end) - (pass.startTime() > start ? pass.startTime() : start) + 1;
+  }
+
+  printf("Simulated: %.2f days, %u loops, %.1f s per loop\n", simulated / 86400.0, loops, loops ? (double)simulated / loops : 0);
+  printf("Passes: %u, %u s, %u used\n", passes, passSeconds, (unsigned)passesUsed.size());
+  printf("Readings: %u, every %.2f minutes\n", (unsigned)readingTimes.size(),
+    readingTimes.size() > 1 ? (readingTimes.back() - readingTimes.front()) / 60.0 / (readingTimes.size() - 1) : 0);
+#if packedPayload
+  printf("Readings not yet in a frame: %u\n", packedReadings.count);
+#endif
+  printf("Frames queued: %u\n", (unsigned)(framesSent.size() + pendingMessages() + queue.dropped()));
+  printf("Transmissions: %u, %u inside passes, %u outside\n", (unsigned)transmissions.size(), sentInPass,
+    (unsigned)transmissions.size() - sentInPass);
+  printf("Frames sent: %u, %u inside passes\n", (unsigned)framesSent.size(), (unsigned)framesSentInPass.size());
+  printf("Readings per frame sent inside passes: %.1f (%u readings in %u frames)\n",
+    readingFramesSent ? (double)readingsSent / readingFramesSent : 0, readingsSent, readingFramesSent);
+  printf("Parity frames sent inside passes: %u, %.2f per frame of readings, which were sent %.2f times each\n",
+    parityFramesSent, readingFramesSent ? (double)parityFramesSent / readingFramesSent : 0,
+    readingFramesSent ? (double)readingTransmissions / readingFramesSent : 0);
+  printf("Frames waiting at the end: %u, at most %u\n", pendingMessages(), mostPending);
+  printf("Frames dropped: %u\n", queue.dropped());
+
+  // Asleep while the countdown timer runs, transmitting while the KIM1 module sends
+  double asleep = hostRtcTimerMillis / 3600000.0;
+  double transmitting = transmissions.size() * (double)hostKimSendMillis / 3600000.0;
+  double awake = simulated / 3600.0 - asleep - transmitting;
+  double charge = awake * awakeMa + asleep * asleepMa + transmitting * transmittingMa;
+  printf("Hours: %.1f awake, %.1f asleep, %.2f transmitting\n", awake, asleep, transmitting);
+  printf("Charge: %.1f mAh, %.1f mAh a day, %.3f mAh per reading sent in a pass (%u readings)\n", charge,
+    simulated ? charge * 86400 / simulated : 0, readingsSent ? charge / readingsSent : 0, readingsSent);
+  printf("SD card: %u files opened, %u writes, %.1f per reading\n", hostSdOpens, hostSdWrites,
+    readingTimes.empty() ? 0 : (double)(hostSdOpens + hostSdWrites) / readingTimes.size());
+  if (logPath != NULL && !saveSdFile("DATALOG.BIN", logPath)) {
+    perror(logPath);
+    return 1;
+  }
+  return 0;
+}
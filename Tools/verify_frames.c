@@ -0,0 +1,145 @@
+/*
+  Verify, and repair, the CRC16 and BCH32 of an archive of frames on every core.
+
+  The archive holds frames of ARGOS_FRAME_LENGTH (31) bytes one after the other, as written by
+  kineis_ingest -f frames or kept from the transmitter. Prints the frames passing each check, those
+  repaired through their BCH32 with the repaired bits by field of the frame, and those which could
+  not be repaired. See Tools/msg_kineis_verify.h.
+    -j threads  threads, one per core by default
+    -r          repair frames failing their BCH32 when 1 or 2 bits are wrong
+    -o file     write the frames, repaired with -r, to file
+    -s file     write the status of each frame to file, one byte of MSG_KINEIS_VERIFY_* bits
+
+  Build (from the repository root):
+    make -C Tools verify_frames
+  Run:
+    Tools/build/verify_frames -r -o repaired.bin frames.bin
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "msg_kineis_std.h"
+#include "msg_kineis_verify.h"
+
+// Fields of the frame, for the repaired bits
+static const struct { const char *name; int position; } fields[] = {
+  { "ext id", POSITION_STD_EXT_ID },
+  { "crc16", POSITION_STD_CRC },
+  { "acq period", POSITION_STD_ACQ_PERIOD },
+  { "date", POSITION_STD_DATE },
+  { "location", POSITION_STD_LOC },
+  { "user data", POSITION_STD_USER_DATA },
+  { "bch32", POSITION_STD_BCH32 },
+  { NULL, ARGOS_FRAME_LENGTH_BIT }
+};
+
+static MsgKineisVerifyStatsTypeDef_t stats;
+
+static double nowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int writeFile(const char *path, const void *data, size_t size) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL || fwrite(data, 1, size, file) != size || fclose(file) != 0) {
+    perror(path);
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  int threads = 0;
+  int repair = 0;
+  const char *outputPath = NULL;
+  const char *statusPath = NULL;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0) {
+      repair = 1;
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      statusPath = argv[++i];
+    } else if (argv[i][0] != '-' && path == NULL) {
+      path = argv[i];
+    } else {
+      path = NULL;
+      break;
+    }
+  }
+  if (path == NULL || threads < 0 || threads > UINT16_MAX) {
+    fprintf(stderr, "usage: %s [-j threads] [-r] [-o repaired frames] [-s status file] frames.bin\n", argv[0]);
+    return 1;
+  }
+
+  // Mapped copy on write, so repairs only reach the file given with -o
+  int descriptor = open(path, O_RDONLY);
+  struct stat fileStatus;
+  if (descriptor < 0 || fstat(descriptor, &fileStatus) != 0) {
+    perror(path);
+    return 1;
+  }
+  uint64_t count = (uint64_t)fileStatus.st_size / ARGOS_FRAME_LENGTH;
+  if ((uint64_t)fileStatus.st_size % ARGOS_FRAME_LENGTH != 0) {
+    fprintf(stderr, "%s: %llu bytes at the end are not a whole frame, ignored\n", path,
+      (unsigned long long)((uint64_t)fileStatus.st_size % ARGOS_FRAME_LENGTH));
+  }
+  ArgosMsgTypeDef_t *frames = NULL;
+  if (count > 0) {
+    void *data = mmap(NULL, count * ARGOS_FRAME_LENGTH, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+    if (data == MAP_FAILED) {
+      perror(path);
+      return 1;
+    }
+    frames = (ArgosMsgTypeDef_t *)data;
+  }
+  close(descriptor);
+  uint8_t *status = NULL;
+  if (statusPath != NULL && (status = (uint8_t *)malloc(count > 0 ? count : 1)) == NULL) {
+    perror(statusPath);
+    return 1;
+  }
+
+  double start = nowSeconds();
+  u64MSG_KINEIS_VERIFY_frames(frames, count, repair, (uint16_t)threads, status, &stats);
+  double seconds = nowSeconds() - start;
+
+  if (outputPath != NULL && !writeFile(outputPath, frames, count * ARGOS_FRAME_LENGTH)) {
+    return 1;
+  }
+  if (statusPath != NULL && !writeFile(statusPath, status, count)) {
+    return 1;
+  }
+
+  printf("Frames: %llu\n", (unsigned long long)stats.frames);
+  printf("CRC16 ok: %llu\n", (unsigned long long)stats.crcOk);
+  printf("BCH32 ok: %llu\n", (unsigned long long)stats.bchOk);
+  printf("Valid: %llu\n", (unsigned long long)stats.valid);
+  if (repair) {
+    printf("Repaired: %llu with 1 bit, %llu with 2 bits\n", (unsigned long long)stats.corrected[0],
+      (unsigned long long)stats.corrected[1]);
+    for (int i = 0; fields[i].name != NULL; i++) {
+      uint64_t bits = 0;
+      for (int bit = fields[i].position; bit < fields[i + 1].position; bit++) {
+        bits += stats.errorBits[bit];
+      }
+      printf("  %s: %llu bits\n", fields[i].name, (unsigned long long)bits);
+    }
+  }
+  printf("Uncorrectable: %llu\n", (unsigned long long)stats.uncorrectable);
+  printf("Threads: %u, blocks: %u, steals: %u\n", stats.threads, stats.blocks, stats.steals);
+  printf("Time: %.3f s, %.0f frames/s\n", seconds, seconds > 0 ? stats.frames / seconds : 0.0);
+  return 0;
+}
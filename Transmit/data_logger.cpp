@@ -0,0 +1,137 @@
+#include "data_logger.h"
+#include <Arduino.h>
+#include <string.h>
+
+static void putShort(uint8_t *bytes, uint16_t value) {
+  bytes[0] = (uint8_t)value;
+  bytes[1] = (uint8_t)(value >> 8);
+}
+
+static void putLong(uint8_t *bytes, uint32_t value) {
+  for (uint8_t i = 0; i < 4; i++) {
+    bytes[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static uint32_t getLong(const uint8_t *bytes) {
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+DataLogger::DataLogger(const char *fileName, uint8_t syncRecords) {
+  _fileName = fileName;
+  _syncRecords = syncRecords > 0 ? syncRecords : 1;
+  _sectorIndex = 0;
+  _count = 0;
+  _unsynced = 0;
+  _sequence = 0;
+  memset(_sector, 0, sizeof(_sector));
+}
+
+// CRC-8 (polynomial 0x07) of the record, inverted so a record of zeros fails
+uint8_t DataLogger::checkByte(const uint8_t record[LOG_FILE_RECORD_SIZE]) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < LOG_FILE_CHECK_OFFSET; i++) {
+    crc ^= record[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = crc & 0x80 ? (uint8_t)(crc << 1) ^ 0x07 : (uint8_t)(crc << 1);
+    }
+  }
+  return ~crc;
+}
+
+// The last sector of the file is read back into the buffer when it is not full, the records
+// after the first one failing its check (a write cut by a power loss) are overwritten
+bool DataLogger::begin() {
+  _file = SD.open(_fileName, LOG_UPDATE);
+  if (!_file) {
+    return false;
+  }
+  uint32_t size = _file.size();
+  uint32_t lastSector = size % LOG_FILE_SECTOR_SIZE != 0 ? size / LOG_FILE_SECTOR_SIZE : (size > 0 ? size / LOG_FILE_SECTOR_SIZE - 1 : 0);
+  uint16_t length = size - lastSector * LOG_FILE_SECTOR_SIZE;
+  memset(_sector, 0, sizeof(_sector));
+  _sectorIndex = lastSector;
+  _count = 0;
+  _unsynced = 0;
+  _sequence = lastSector * LOG_FILE_RECORDS_PER_SECTOR;
+  if (length > 0 && (!_file.seek(lastSector * LOG_FILE_SECTOR_SIZE) || _file.read(_sector, length) != length)) {
+    return false;
+  }
+  while (_count < LOG_FILE_RECORDS_PER_SECTOR) {
+    const uint8_t *record = &_sector[_count * LOG_FILE_RECORD_SIZE];
+    if (record[LOG_FILE_CHECK_OFFSET] != checkByte(record)) {
+      break;
+    }
+    _sequence = getLong(&record[4]) + 1;
+    _count++;
+  }
+  memset(&_sector[_count * LOG_FILE_RECORD_SIZE], 0, sizeof(_sector) - _count * LOG_FILE_RECORD_SIZE);
+  if (_count == LOG_FILE_RECORDS_PER_SECTOR) {
+    _sectorIndex++;
+    _count = 0;
+    memset(_sector, 0, sizeof(_sector));
+  }
+  return true;
+}
+
+// Write the buffer over its sector, then start the next sector when it is full
+bool DataLogger::writeSector() {
+  bool written = _file.seek(_sectorIndex * LOG_FILE_SECTOR_SIZE) &&
+    _file.write(_sector, sizeof(_sector)) == sizeof(_sector);
+  if (written) {
+    _file.flush();
+    _unsynced = 0;
+    if (_count == LOG_FILE_RECORDS_PER_SECTOR) {
+      _sectorIndex++;
+      _count = 0;
+      memset(_sector, 0, sizeof(_sector));
+    }
+  }
+  return written;
+}
+
+bool DataLogger::append(uint8_t type, uint8_t flags, uint32_t time, uint16_t rawValue, int16_t temperature, const ArgosMsgTypeDef_t *frame) {
+  if (!_file) {
+    return false;
+  }
+  if (_count == LOG_FILE_RECORDS_PER_SECTOR && !writeSector()) {
+    // The full sector still cannot be written: its records are lost rather than logging stopping
+    _count = 0;
+    memset(_sector, 0, sizeof(_sector));
+  }
+  uint8_t *record = &_sector[_count * LOG_FILE_RECORD_SIZE];
+  memset(record, 0, LOG_FILE_RECORD_SIZE);
+  record[0] = type;
+  record[1] = flags;
+  putShort(&record[2], rawValue);
+  putLong(&record[4], _sequence);
+  putLong(&record[8], time);
+  putShort(&record[12], (uint16_t)temperature);
+  if (frame != NULL) {
+    record[1] |= LOG_FILE_FRAME;
+    memcpy(&record[LOG_FILE_FRAME_OFFSET], frame->payload, ARGOS_FRAME_LENGTH);
+  }
+  record[LOG_FILE_CHECK_OFFSET] = checkByte(record);
+  _count++;
+  _unsynced++;
+  _sequence++;
+  if (_count == LOG_FILE_RECORDS_PER_SECTOR || _unsynced >= _syncRecords) {
+    return writeSector();
+  }
+  return true;
+}
+
+bool DataLogger::logReading(uint32_t time, uint16_t rawValue, int16_t temperature, const ArgosMsgTypeDef_t *frame) {
+  return append(LOG_FILE_READING, 0, time, rawValue, temperature, frame);
+}
+
+bool DataLogger::logTransmission(uint32_t time, const ArgosMsgTypeDef_t &frame, bool sent) {
+  return append(LOG_FILE_TRANSMISSION, sent ? LOG_FILE_SENT : 0, time, 0, 0, &frame);
+}
+
+bool DataLogger::sync() {
+  if (!_file || _unsynced == 0) {
+    return true;
+  }
+  return writeSector();
+}
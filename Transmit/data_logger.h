@@ -0,0 +1,45 @@
+#ifndef DataLogger_h
+#define DataLogger_h
+#include <SD.h>
+#include "log_file_format.h"
+#include "msg_kineis_std.h"
+
+// Open for in-place writes, FILE_WRITE always appends
+#if defined(ESP8266)
+#define LOG_UPDATE (sdfat::O_READ | sdfat::O_WRITE | sdfat::O_CREAT)
+#else
+#define LOG_UPDATE (O_READ | O_WRITE | O_CREAT)
+#endif
+
+// Log of the readings and transmissions on the SD card, in the binary records of log_file_format.h.
+// Records are gathered in a sector buffer and written a whole sector at a time to a file kept
+// open, so the FAT and directory entry are only updated when a sector is written. Every
+// syncRecords records the sector is also written while partly filled, and written again in place
+// once full, so at most syncRecords - 1 records are lost to a power cut.
+class DataLogger {
+  public:
+    DataLogger(const char *fileName, uint8_t syncRecords);
+    // Open the log and carry on after the last record of the last run
+    bool begin();
+    // A reading, temperature in hundredths of a degree C, and the frame queued with it, if any
+    bool logReading(uint32_t time, uint16_t rawValue, int16_t temperature, const ArgosMsgTypeDef_t *frame);
+    // A frame handed to the KIM1 module, sent when the module accepted it
+    bool logTransmission(uint32_t time, const ArgosMsgTypeDef_t &frame, bool sent);
+    // Write the records not yet on the card
+    bool sync();
+    // Records logged, including those of earlier runs
+    uint32_t sequence() { return _sequence; }
+  private:
+    static uint8_t checkByte(const uint8_t record[LOG_FILE_RECORD_SIZE]);
+    bool append(uint8_t type, uint8_t flags, uint32_t time, uint16_t rawValue, int16_t temperature, const ArgosMsgTypeDef_t *frame);
+    bool writeSector();
+    const char *_fileName;
+    uint8_t _syncRecords;
+    File _file;
+    uint8_t _sector[LOG_FILE_SECTOR_SIZE];
+    uint32_t _sectorIndex; // sector of the file the buffer is written to
+    uint8_t _count; // records in the buffer
+    uint8_t _unsynced; // records in the buffer not yet written
+    uint32_t _sequence;
+};
+#endif
@@ -0,0 +1,30 @@
+#include "event_scheduler.h"
+
+EventScheduler::EventScheduler(uint32_t readingInterval) {
+  _readingInterval = readingInterval;
+  _nextReading = 0;
+  _missed = 0;
+}
+
+void EventScheduler::begin(uint32_t now) {
+  _nextReading = now - now % _readingInterval + _readingInterval;
+  _missed = 0;
+}
+
+bool EventScheduler::readingDue(uint32_t now) {
+  if (now < _nextReading) {
+    return false;
+  }
+  uint32_t skipped = (now - _nextReading) / _readingInterval;
+  _missed = skipped > 0xFFFF ? 0xFFFF : skipped;
+  _nextReading += (skipped + 1) * _readingInterval;
+  return true;
+}
+
+uint32_t EventScheduler::nextEvent(uint32_t now, PassSchedule &passSchedule) {
+  SatellitePass pass;
+  if (passSchedule.nextPass(now, pass) && pass.startTime() < _nextReading) {
+    return pass.startTime();
+  }
+  return _nextReading;
+}
@@ -0,0 +1,29 @@
+#ifndef EventScheduler_h
+#define EventScheduler_h
+#include <stdint.h>
+#include "pass_schedule.h"
+
+// Times at which the sketch has something to do, so it can sleep in between: the readings, every
+// readingInterval seconds on a fixed grid of the clock so the time taken by each loop does not
+// make them drift, and the start of the satellite passes.
+// Times are in seconds since 1970-01-01, as DateTime::unixtime()
+class EventScheduler {
+  public:
+    EventScheduler(uint32_t readingInterval);
+    // The first reading is at the next multiple of the interval after now
+    void begin(uint32_t now);
+    // True when a reading is due at now. The next one is then the first time of the grid after now:
+    // readings missed while the sketch was busy, e.g. sending through a long pass, are not taken late
+    bool readingDue(uint32_t now);
+    // Readings of the grid skipped before the last reading due
+    uint16_t missedReadings() { return _missed; }
+    uint32_t nextReading() { return _nextReading; }
+    // Time of the next event after now: the next reading or the start of the next pass,
+    // whichever comes first
+    uint32_t nextEvent(uint32_t now, PassSchedule &passSchedule);
+  private:
+    uint32_t _readingInterval;
+    uint32_t _nextReading;
+    uint16_t _missed;
+};
+#endif
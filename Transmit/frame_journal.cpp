@@ -0,0 +1,208 @@
+#include "frame_journal.h"
+#include <string.h>
+
+#define CHECKPOINT_MAGIC 0x4B434A53UL // "SJCK"
+
+static void putLong(uint8_t *bytes, uint32_t value) {
+  for (uint8_t i = 0; i < 4; i++) {
+    bytes[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static uint32_t getLong(const uint8_t *bytes) {
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+FrameJournal::FrameJournal(const char *journalName, const char *checkpointName) {
+  _journalName = journalName;
+  _checkpointName = checkpointName;
+  _head = 0;
+  _tail = 0;
+  _next = 0;
+  _generation = 0;
+  _windowStart = 0;
+  _windowCount = 0;
+}
+
+// CRC-8 (polynomial 0x07) of the frame, inverted so a record of zeros fails
+uint8_t FrameJournal::checkByte(const ArgosMsgTypeDef_t &frame) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < ARGOS_FRAME_LENGTH; i++) {
+    crc ^= frame.payload[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = crc & 0x80 ? (uint8_t)(crc << 1) ^ 0x07 : (uint8_t)(crc << 1);
+    }
+  }
+  return ~crc;
+}
+
+bool FrameJournal::readCheckpoint() {
+  uint8_t slots[2 * JOURNAL_CHECKPOINT_SIZE];
+  bool found = false;
+  File file = SD.open(_checkpointName, FILE_READ);
+  if (!file) {
+    return false;
+  }
+  int length = file.read(slots, sizeof(slots));
+  file.close();
+  for (uint8_t slot = 0; slot < 2; slot++) {
+    const uint8_t *record = &slots[slot * JOURNAL_CHECKPOINT_SIZE];
+    if (length < (slot + 1) * JOURNAL_CHECKPOINT_SIZE || getLong(&record[0]) != CHECKPOINT_MAGIC) {
+      continue;
+    }
+    uint32_t generation = getLong(&record[4]);
+    uint32_t head = getLong(&record[8]);
+    if (getLong(&record[12]) != (CHECKPOINT_MAGIC ^ generation ^ head ^ 0xFFFFFFFFUL)) {
+      continue;
+    }
+    if (!found || generation > _generation) {
+      _generation = generation;
+      _head = head;
+      found = true;
+    }
+  }
+  return found;
+}
+
+// Write the next generation in the slot not holding the current one. A new file is first padded
+// to both slots, as seeking past its end fails
+bool FrameJournal::writeCheckpoint() {
+  uint8_t record[JOURNAL_CHECKPOINT_SIZE];
+  _generation++;
+  putLong(&record[0], CHECKPOINT_MAGIC);
+  putLong(&record[4], _generation);
+  putLong(&record[8], _head);
+  putLong(&record[12], CHECKPOINT_MAGIC ^ _generation ^ _head ^ 0xFFFFFFFFUL);
+  File file = SD.open(_checkpointName, JOURNAL_UPDATE);
+  if (!file) {
+    return false;
+  }
+  uint32_t size = file.size();
+  bool written = true;
+  if (size < 2 * JOURNAL_CHECKPOINT_SIZE) {
+    uint8_t padding[2 * JOURNAL_CHECKPOINT_SIZE];
+    memset(padding, 0, sizeof(padding));
+    written = file.seek(size) && file.write(padding, sizeof(padding) - size) == sizeof(padding) - size;
+  }
+  written = written && file.seek((_generation & 1) * JOURNAL_CHECKPOINT_SIZE) &&
+    file.write(record, sizeof(record)) == sizeof(record);
+  file.close();
+  return written;
+}
+
+bool FrameJournal::begin() {
+  _head = 0;
+  _generation = 0;
+  _tail = 0;
+  readCheckpoint();
+  File file = SD.open(_journalName, FILE_READ);
+  if (file) {
+    uint32_t size = file.size();
+    file.close();
+    _tail = (size + JOURNAL_RECORD_SIZE - 1) / JOURNAL_RECORD_SIZE;
+    // Pad a record cut by a power loss, it fails its check and the next ones stay aligned
+    if (size % JOURNAL_RECORD_SIZE != 0) {
+      uint8_t padding[JOURNAL_RECORD_SIZE];
+      memset(padding, 0, sizeof(padding));
+      file = SD.open(_journalName, FILE_WRITE);
+      if (!file) {
+        return false;
+      }
+      file.write(padding, JOURNAL_RECORD_SIZE - size % JOURNAL_RECORD_SIZE);
+      file.close();
+    }
+  }
+  if (_head > _tail) {
+    // Journal removed after the checkpoint was written
+    _head = _tail;
+  }
+  _next = _head;
+  _windowStart = 0;
+  _windowCount = 0;
+  // Move past records failing their check at the head, e.g. the padding above
+  fill();
+  return true;
+}
+
+bool FrameJournal::push(const ArgosMsgTypeDef_t &frame) {
+  uint8_t record[JOURNAL_RECORD_SIZE];
+  memcpy(record, frame.payload, ARGOS_FRAME_LENGTH);
+  record[ARGOS_FRAME_LENGTH] = checkByte(frame);
+  File file = SD.open(_journalName, FILE_WRITE);
+  if (!file) {
+    return false;
+  }
+  bool written = file.write(record, sizeof(record)) == sizeof(record);
+  file.close();
+  if (written) {
+    _tail++;
+  }
+  return written;
+}
+
+// Read the records following the window until it is full, skipping those failing their check.
+// Records skipped while the window is empty are behind every frame waiting, they are no longer counted
+void FrameJournal::fill() {
+  if (_windowCount == JOURNAL_WINDOW || _next >= _tail) {
+    return;
+  }
+  File file = SD.open(_journalName, FILE_READ);
+  if (!file || !file.seek(_next * JOURNAL_RECORD_SIZE)) {
+    return;
+  }
+  uint8_t record[JOURNAL_RECORD_SIZE];
+  while (_windowCount < JOURNAL_WINDOW && _next < _tail) {
+    if (file.read(record, sizeof(record)) != sizeof(record)) {
+      break;
+    }
+    uint8_t index = (_windowStart + _windowCount) % JOURNAL_WINDOW;
+    memcpy(_window[index].payload, record, ARGOS_FRAME_LENGTH);
+    if (record[ARGOS_FRAME_LENGTH] == checkByte(_window[index])) {
+      _windowRecords[index] = _next;
+      _windowCount++;
+    } else if (_windowCount == 0) {
+      _head = _next + 1;
+    }
+    _next++;
+  }
+  file.close();
+}
+
+bool FrameJournal::peek(ArgosMsgTypeDef_t &frame, uint8_t offset) {
+  if (offset >= _windowCount) {
+    fill();
+    if (offset >= _windowCount) {
+      return false;
+    }
+  }
+  frame = _window[(_windowStart + offset) % JOURNAL_WINDOW];
+  return true;
+}
+
+bool FrameJournal::pop() {
+  if (_windowCount == 0) {
+    return false;
+  }
+  _head = _windowRecords[_windowStart] + 1;
+  _windowStart = (_windowStart + 1) % JOURNAL_WINDOW;
+  _windowCount--;
+  fill();
+  if (_windowCount == 0 && _next >= _tail) {
+    // Everything sent: start a new journal. A reset before the checkpoint is written sends the
+    // last frame again rather than losing it
+    SD.remove(_journalName);
+    _head = 0;
+    _tail = 0;
+    _next = 0;
+  }
+  return writeCheckpoint();
+}
+
+uint32_t FrameJournal::count() {
+  return _tail - _head;
+}
+
+bool FrameJournal::isEmpty() {
+  ArgosMsgTypeDef_t frame;
+  return !peek(frame);
+}
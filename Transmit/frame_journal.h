@@ -0,0 +1,55 @@
+#ifndef FrameJournal_h
+#define FrameJournal_h
+#include <SD.h>
+#include "msg_kineis_std.h"
+
+// Journal records: a frame and its check byte, 16 per 512 byte SD sector so no record spans two
+#define JOURNAL_RECORD_SIZE 32
+// Frames read ahead from the journal
+#define JOURNAL_WINDOW 4
+#define JOURNAL_CHECKPOINT_SIZE 16
+
+// Open for in-place writes, FILE_WRITE always appends
+#if defined(ESP8266)
+#define JOURNAL_UPDATE (sdfat::O_READ | sdfat::O_WRITE | sdfat::O_CREAT)
+#else
+#define JOURNAL_UPDATE (O_READ | O_WRITE | O_CREAT)
+#endif
+
+// Frames waiting to be sent, kept on the SD card so they survive a reset or a power cut.
+// Frames are appended to the journal file and never rewritten. The checkpoint file holds the
+// number of journal records already sent, in two alternate slots so a torn write leaves the
+// previous one valid. Records which fail their check, e.g. a write cut by a power loss, are skipped
+// and no longer counted once the frames before them are sent.
+// The journal is removed once every frame of it has been sent.
+class FrameJournal {
+  public:
+    FrameJournal(const char *journalName, const char *checkpointName);
+    // Replay the journal and checkpoint left by the last run
+    bool begin();
+    bool push(const ArgosMsgTypeDef_t &frame);
+    // Next frame to send, or the one offset places after it (offset below JOURNAL_WINDOW), left in the journal
+    bool peek(ArgosMsgTypeDef_t &frame, uint8_t offset = 0);
+    // Mark the next frame to send as sent
+    bool pop();
+    // Records waiting, including any not read yet that will fail their check
+    uint32_t count();
+    bool isEmpty();
+  private:
+    static uint8_t checkByte(const ArgosMsgTypeDef_t &frame);
+    bool readCheckpoint();
+    bool writeCheckpoint();
+    void fill();
+    const char *_journalName;
+    const char *_checkpointName;
+    uint32_t _head; // first record not sent
+    uint32_t _tail; // records in the journal
+    uint32_t _next; // first record not read into the window
+    uint32_t _generation;
+    // Next frames to send and their record in the journal, read ahead in order
+    ArgosMsgTypeDef_t _window[JOURNAL_WINDOW];
+    uint32_t _windowRecords[JOURNAL_WINDOW];
+    uint8_t _windowStart;
+    uint8_t _windowCount;
+};
+#endif
@@ -0,0 +1,69 @@
+#ifndef FrameRing_h
+#define FrameRing_h
+#include <stdint.h>
+#include "msg_kineis_std.h"
+
+// What to do when a frame is pushed into a full ring
+enum FrameRingPolicy {
+  DROP_OLDEST, // Keep the latest readings, the oldest frame waiting is lost
+  DROP_NEWEST  // Keep the backlog, the frame pushed is lost
+};
+
+// First in first out queue of at most Capacity binary frames, allocated statically
+template <uint8_t Capacity>
+class FrameRing {
+  public:
+    FrameRing(FrameRingPolicy policy = DROP_OLDEST) : _policy(policy), _head(0), _count(0), _dropped(0) {}
+
+    // Returns false when a frame had to be dropped, see FrameRingPolicy
+    bool push(const ArgosMsgTypeDef_t &frame) {
+      bool kept = true;
+      if (_count == Capacity) {
+        _dropped++;
+        kept = false;
+        if (_policy == DROP_NEWEST) {
+          return false;
+        }
+        _head = next(_head);
+        _count--;
+      }
+      _frames[index(_count)] = frame;
+      _count++;
+      return kept;
+    }
+
+    bool pop(ArgosMsgTypeDef_t &frame) {
+      if (_count == 0) {
+        return false;
+      }
+      frame = _frames[_head];
+      _head = next(_head);
+      _count--;
+      return true;
+    }
+
+    // Oldest frame, or the one offset places after it, left in the ring
+    const ArgosMsgTypeDef_t *peek(uint8_t offset = 0) const {
+      return offset >= _count ? 0 : &_frames[index(offset)];
+    }
+
+    uint8_t count() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+    bool isFull() const { return _count == Capacity; }
+    uint8_t capacity() const { return Capacity; }
+    // Frames lost since the start because the ring was full
+    uint16_t dropped() const { return _dropped; }
+
+  private:
+    static uint8_t next(uint8_t position) { return position + 1 == Capacity ? 0 : position + 1; }
+    uint8_t index(uint8_t offset) const {
+      uint16_t position = (uint16_t)_head + offset;
+      return position >= Capacity ? position - Capacity : position;
+    }
+    ArgosMsgTypeDef_t _frames[Capacity];
+    FrameRingPolicy _policy;
+    uint8_t _head;
+    uint8_t _count;
+    uint16_t _dropped;
+};
+#endif
@@ -0,0 +1,29 @@
+#ifndef LogFileFormat_h
+#define LogFileFormat_h
+// Binary log of the readings and transmissions kept on the SD card by DataLogger, read back as
+// text by Tools/log2text.c. All values are little-endian.
+//
+// The file is a run of records of LOG_FILE_RECORD_SIZE bytes, LOG_FILE_RECORDS_PER_SECTOR to a
+// 512 byte SD sector so no record spans two. The last sector may end with zeros, not yet written.
+// Records (LOG_FILE_RECORD_SIZE bytes each), in the order they were logged
+//   0  uint8    type, LOG_FILE_READING or LOG_FILE_TRANSMISSION
+//   1  uint8    flags, LOG_FILE_FRAME and LOG_FILE_SENT
+//   2  uint16   raw analogue value of the temperature sensor, 0 for a transmission
+//   4  uint32   sequence number of the record, from 0 for a new log
+//   8  uint32   time, seconds since 1970-01-01 of the real time clock
+//   12 int16    temperature in hundredths of a degree C, 0 for a transmission
+//   14 uint8[31] frame queued with the reading or sent, zeros when there is none
+//   45 uint8[18] reserved, 0
+//   63 uint8    check byte: CRC-8 (polynomial 0x07) of bytes 0 to 62, inverted
+#define LOG_FILE_SECTOR_SIZE 512
+#define LOG_FILE_RECORD_SIZE 64
+#define LOG_FILE_RECORDS_PER_SECTOR (LOG_FILE_SECTOR_SIZE / LOG_FILE_RECORD_SIZE)
+#define LOG_FILE_FRAME_OFFSET 14
+#define LOG_FILE_CHECK_OFFSET (LOG_FILE_RECORD_SIZE - 1)
+// Record types
+#define LOG_FILE_READING 1
+#define LOG_FILE_TRANSMISSION 2
+// Flags
+#define LOG_FILE_FRAME 0x01 // the record holds a frame
+#define LOG_FILE_SENT 0x02 // the KIM1 module accepted the frame
+#endif
@@ -0,0 +1,191 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_fec.c
+//! @brief	Parity messages protecting groups of packed messages
+// -------------------------------------------------------------------------- //
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+#include <string.h>
+#include "msg_kineis_fec.h"
+#include "msg_kineis_packed.h"
+#include "msg_kineis_std_decode.h"
+
+// -------------------------------------------------------------------------- //
+// Defines
+// -------------------------------------------------------------------------- //
+#define GF_POLYNOMIAL		0x1D	//!< x^8 + x^4 + x^3 + x^2 + 1, x^8 left out
+
+#define SEQ_WIDTH			12
+#define DATE_WIDTH			16
+
+//!< Packed user data after the tag and the sequence, up to the BCH32
+#define PROTECTED_POSITION	(POSITION_STD_USER_DATA + 4 + SEQ_WIDTH)
+#define PROTECTED_LENGTH	(POSITION_STD_BCH32 - PROTECTED_POSITION)
+
+//!< Parity message fields, in its user data
+#define POSITION_FIRST_SEQ	4
+#define POSITION_K			(POSITION_FIRST_SEQ + SEQ_WIDTH)
+#define POSITION_M			(POSITION_K + 4)
+#define POSITION_INDEX		(POSITION_M + 4)
+#define POSITION_PARITY		(POSITION_INDEX + 4)
+#define POSITION_DATE		(POSITION_PARITY + FEC_SYMBOL_LENGTH * 8)
+#define POSITION_CHECK		(POSITION_DATE + DATE_WIDTH)
+#define CHECK_WIDTH			16
+
+//!< Cauchy matrix points of the parity and data messages
+#define DATA_POINT(i)		(FEC_MAX_DATA + 1 + (i))
+
+
+// -------------------------------------------------------------------------- //
+//! Product in GF(2^8)
+// -------------------------------------------------------------------------- //
+
+static uint8_t u8MSGKINEIS_FEC_mul(uint8_t a, uint8_t b)
+{
+	uint8_t product = 0;
+
+	while (b) {
+		if (b & 1)
+			product ^= a;
+		a = (uint8_t)((a << 1) ^ (a & 0x80 ? GF_POLYNOMIAL : 0));
+		b >>= 1;
+	}
+
+	return product;
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Inverse in GF(2^8) : a^254
+// -------------------------------------------------------------------------- //
+
+static uint8_t u8MSGKINEIS_FEC_inv(uint8_t a)
+{
+	uint8_t square = a;
+	uint8_t inverse = 1;
+	uint8_t i;
+
+	//!< 254 = 0b11111110
+	for (i = 1; i < 8; i++) {
+		square = u8MSGKINEIS_FEC_mul(square, square);
+		inverse = u8MSGKINEIS_FEC_mul(inverse, square);
+	}
+
+	return inverse;
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Symbol of a data message
+// -------------------------------------------------------------------------- //
+
+static void vMSGKINEIS_FEC_getSymbol(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	uint8_t symbol[FEC_SYMBOL_LENGTH])
+{
+	uint16_t date = (uint16_t)u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle,
+		POSITION_STD_DATE, DATE_WIDTH);
+	uint8_t i;
+
+	symbol[0] = date >> 8;
+	symbol[1] = date & 0xff;
+
+	for (i = 0; i < PROTECTED_LENGTH / 8; i++)
+		symbol[2 + i] = (uint8_t)u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle,
+			PROTECTED_POSITION + i * 8, 8);
+
+	//!< Last bits in the high part of the last byte
+	symbol[2 + i] = (uint8_t)(u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle,
+		PROTECTED_POSITION + i * 8, PROTECTED_LENGTH % 8) << (8 - PROTECTED_LENGTH % 8));
+}
+
+
+// -------------------------------------------------------------------------- //
+// Start a new group
+// -------------------------------------------------------------------------- //
+
+void vMSGKINEIS_FEC_init(
+	ArgosFecGroupTypeDef_t *group,
+	uint8_t k,
+	uint8_t m)
+{
+	memset(group, 0, sizeof(*group));
+	vMSG_KINEIS_UTILS_initCrc16(&group->check);
+	group->k = k > FEC_MAX_DATA ? FEC_MAX_DATA : k;
+	group->m = m > FEC_MAX_PARITY ? FEC_MAX_PARITY : m;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Add a data message to a group
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_FEC_addMessage(
+	ArgosFecGroupTypeDef_t *group,
+	const ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	uint8_t symbol[FEC_SYMBOL_LENGTH];
+	uint8_t coefficient;
+	uint16_t seq;
+	uint8_t j;
+	uint8_t i;
+
+	if (group == NULL || ArgosMsgHandle == NULL || group->count >= group->k)
+		return false;
+
+	if (u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_ACQ_PERIOD, 3) != USER_MSG ||
+		u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_USER_DATA, 4) != PACKED_TAG)
+		return false;
+
+	seq = (uint16_t)u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_USER_DATA + 4, SEQ_WIDTH);
+	if (group->count == 0) {
+		group->firstSeq = seq;
+		group->firstDate = (uint16_t)u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_DATE, DATE_WIDTH);
+	} else if (seq != ((group->firstSeq + group->count) & ((1U << SEQ_WIDTH) - 1)))
+		return false;
+
+	vMSGKINEIS_FEC_getSymbol(ArgosMsgHandle, symbol);
+	vMSG_KINEIS_UTILS_updateCrc16(&group->check, symbol, FEC_SYMBOL_LENGTH * 8);
+
+	for (j = 0; j < group->m; j++) {
+		coefficient = u8MSGKINEIS_FEC_inv(j ^ DATA_POINT(group->count));
+		for (i = 0; i < FEC_SYMBOL_LENGTH; i++)
+			group->parity[j][i] ^= u8MSGKINEIS_FEC_mul(coefficient, symbol[i]);
+	}
+
+	group->count++;
+
+	return true;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Build a parity message of a group
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_FEC_getParity(
+	const ArgosFecGroupTypeDef_t *group,
+	uint8_t index,
+	ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	ArgosFrameWriterTypeDef_t writer;
+
+	if (group == NULL || ArgosMsgHandle == NULL || group->count == 0 || index >= group->m)
+		return false;
+
+	//!< The fields are the user data of a "user data only" message
+	vMSGKINEIS_STDV1_initFrameWriter(&writer, ArgosMsgHandle);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, FEC_TAG, POSITION_FIRST_SEQ);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, group->firstSeq, SEQ_WIDTH);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, group->count, POSITION_M - POSITION_K);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, group->m, POSITION_INDEX - POSITION_M);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, index, POSITION_PARITY - POSITION_INDEX);
+	vMSGKINEIS_STDV1_writeFrameBytes(&writer, group->parity[index], FEC_SYMBOL_LENGTH);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, group->firstDate, POSITION_CHECK - POSITION_DATE);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, u16MSG_KINEIS_UTILS_finalCrc16(&group->check), CHECK_WIDTH);
+	vMSGKINEIS_STDV1_closeFrameWriter(&writer);
+
+	return true;
+}
@@ -0,0 +1,148 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_fec.h
+//! @brief	Parity messages protecting groups of packed messages
+//!			k consecutive messages of packed readings (msg_kineis_packed.h)
+//!			are followed by m parity messages. Any k of the k + m messages
+//!			are enough to rebuild the readings of the group, instead of
+//!			sending every message several times.
+//! @note	The code is a Reed-Solomon code over GF(2^8) built on a Cauchy
+//!			matrix : parity message j is the sum of the symbols of the data
+//!			messages i times 1 / (j xor (16 + i)), with the polynomial 0x11D.
+// -------------------------------------------------------------------------- //
+
+
+// -------------------------------------------------------------------------- //
+//! * Symbol of a data message (16 bytes), what a parity message protects :
+//! | Day | Hour | Minute | Packed user data after Tag and Sequence | 0 |
+//! |     |      |        |                                         |   |
+//! |  5  |   5  |    6   |                   108                   | 4 |
+//!
+//! The Tag and Sequence of a data message follow from its place in the group.
+//!
+//! * Parity message, in the "user data only" format :
+//! | Tag | First sequence |  k  |  m  | Index | Parity symbol | Date | Check | Spare |
+//! |     |                |     |     |       |               |      |       |       |
+//! |  4  |       12       |  4  |  4  |   4   |      128      |  16  |   16  |   8   |
+//!
+//! Tag : FEC_TAG. Its first 3 bits take the place of the AcqPeriod of a
+//! "position and user data" message, USER_MSG for the packed messages, so
+//! both kinds of message cannot be confused.
+//! Date : Day, Hour and Minute of the first data message. The sequences
+//! restart at each reset, the date tells groups of the same sequences apart.
+//! Check : CRC16 of the symbols of the data messages, in order, to check the
+//! messages rebuilt.
+// -------------------------------------------------------------------------- //
+
+#ifndef MSG_KINEIS_FEC_H
+
+#define MSG_KINEIS_FEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "msg_kineis_std.h"
+
+#pragma GCC visibility push(default)
+
+// -------------------------------------------------------------------------- //
+// Defines values
+// -------------------------------------------------------------------------- //
+
+#define FEC_TAG				0xC
+#define FEC_SYMBOL_LENGTH	16
+
+//!< Data messages per group (4 bit field)
+#define FEC_MAX_DATA		15
+//!< Parity messages per group, the parity is kept in RAM while the group is built
+#define FEC_MAX_PARITY		4
+
+
+// -------------------------------------------------------------------------- //
+//! Group of data messages being protected
+// -------------------------------------------------------------------------- //
+
+typedef struct ArgosFecGroupTypeDef_t {
+	uint16_t firstSeq;	//!< Sequence of the first data message
+	uint16_t firstDate;	//!< Day, Hour and Minute of the first data message
+	uint8_t k;			//!< Data messages per group
+	uint8_t m;			//!< Parity messages per group
+	uint8_t count;		//!< Data messages added
+	uint8_t parity[FEC_MAX_PARITY][FEC_SYMBOL_LENGTH];
+	MsgKineisCrc16CtxTypeDef_t check;	//!< CRC16 of the data symbols
+} ArgosFecGroupTypeDef_t;
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Start a new group
+//!
+//! \param[out] group Group to clear
+//! \param[in] k Data messages per group (1 to FEC_MAX_DATA)
+//! \param[in] m Parity messages per group (1 to FEC_MAX_PARITY)
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_FEC_init
+(
+	ArgosFecGroupTypeDef_t *group,
+	uint8_t k,
+	uint8_t m
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Add a data message to a group
+//!
+//! \param[in,out] group Group
+//! \param[in] ArgosMsgHandle "position and user data" message of packed
+//!		readings, with the sequence following the previous one of the group
+//!
+//! \return false if the message cannot be added : the group is full, the
+//!		message does not hold packed readings or does not follow the previous
+//!		one. Send the parity of the group and start a new one.
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_FEC_addMessage
+(
+	ArgosFecGroupTypeDef_t *group,
+	const ArgosMsgTypeDef_t *ArgosMsgHandle
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Build a parity message of a group
+//!
+//! A group may be closed before it holds k data messages : the parity then
+//! protects the messages added.
+//!
+//! \param[in] group Group, with at least one data message
+//! \param[in] index Parity message (0 to m - 1)
+//! \param[out] ArgosMsgHandle Parity message, with its CRC16 and BCH32
+//!
+//! \return false if the group is empty or the index out of range
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_FEC_getParity
+(
+	const ArgosFecGroupTypeDef_t *group,
+	uint8_t index,
+	ArgosMsgTypeDef_t *ArgosMsgHandle
+);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // end MSG_KINEIS_FEC_H
@@ -0,0 +1,71 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_frag.c
+//! @brief	Records longer than the user data of one message
+// -------------------------------------------------------------------------- //
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+#include <string.h>
+#include "msg_kineis_frag.h"
+
+// -------------------------------------------------------------------------- //
+// Defines
+// -------------------------------------------------------------------------- //
+
+//!< Fragment fields, in its user data
+#define POSITION_RECORD		4
+#define POSITION_INDEX		(POSITION_RECORD + 8)
+#define POSITION_LAST		(POSITION_INDEX + 4)
+#define POSITION_LENGTH		(POSITION_LAST + 4)
+#define POSITION_DATA		(POSITION_LENGTH + 5 + 3)
+
+
+// -------------------------------------------------------------------------- //
+// Number of fragments of a record
+// -------------------------------------------------------------------------- //
+
+uint8_t u8MSGKINEIS_FRAG_count(
+	uint16_t len)
+{
+	if (len == 0 || len > FRAG_MAX_LENGTH)
+		return 0;
+
+	return (uint8_t)((len + FRAG_DATA_LENGTH - 1) / FRAG_DATA_LENGTH);
+}
+
+
+// -------------------------------------------------------------------------- //
+// Build a fragment of a record
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_FRAG_getFragment(
+	const uint8_t data[],
+	uint16_t len,
+	uint8_t record,
+	uint8_t index,
+	ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	ArgosFrameWriterTypeDef_t writer;
+	uint8_t count = u8MSGKINEIS_FRAG_count(len);
+	uint16_t offset = (uint16_t)index * FRAG_DATA_LENGTH;
+	uint8_t length;
+
+	if (data == NULL || ArgosMsgHandle == NULL || index >= count)
+		return false;
+
+	length = len - offset < FRAG_DATA_LENGTH ? (uint8_t)(len - offset) : FRAG_DATA_LENGTH;
+
+	//!< The fields are the user data of a "user data only" message
+	vMSGKINEIS_STDV1_initFrameWriter(&writer, ArgosMsgHandle);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, FRAG_TAG, POSITION_RECORD);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, record, POSITION_INDEX - POSITION_RECORD);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, index, POSITION_LAST - POSITION_INDEX);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, count - 1, POSITION_LENGTH - POSITION_LAST);
+	vMSGKINEIS_STDV1_writeFrameValue(&writer, (uint32_t)length << 3, POSITION_DATA - POSITION_LENGTH);
+	vMSGKINEIS_STDV1_writeFrameBytes(&writer, data + offset, length);
+	vMSGKINEIS_STDV1_closeFrameWriter(&writer);
+
+	return true;
+}
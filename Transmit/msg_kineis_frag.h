@@ -0,0 +1,97 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_frag.h
+//! @brief	Records longer than the user data of one message
+//!			A record is split into fragments, each sent in a "user data
+//!			only" message, which the receiver puts back together.
+// -------------------------------------------------------------------------- //
+
+
+// -------------------------------------------------------------------------- //
+//! * Fragment, in the "user data only" format :
+//! | Tag | Record | Index | Last | Length | Spare |   Data   |
+//! |     |        |       |      |        |       |          |
+//! |  4  |    8   |   4   |   4  |    5   |   3   | 21 bytes |
+//!
+//! Tag : FRAG_TAG. Its first 3 bits take the place of the AcqPeriod of a
+//! "position and user data" message, which is USER_MSG for this device.
+//! Record : record number, modulo 256, the same for all its fragments
+//! Index : fragment number in the record, from 0
+//! Last : index of the last fragment of the record
+//! Length : bytes of data in the fragment, the following ones are 0
+// -------------------------------------------------------------------------- //
+
+#ifndef MSG_KINEIS_FRAG_H
+
+#define MSG_KINEIS_FRAG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "msg_kineis_std.h"
+
+#pragma GCC visibility push(default)
+
+// -------------------------------------------------------------------------- //
+// Defines values
+// -------------------------------------------------------------------------- //
+
+#define FRAG_TAG			0xD
+#define FRAG_DATA_LENGTH	21
+#define FRAG_MAX_FRAGMENTS	16
+#define FRAG_MAX_LENGTH		(FRAG_DATA_LENGTH * FRAG_MAX_FRAGMENTS)
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Number of fragments of a record
+//!
+//! \param[in] len Length of the record
+//!
+//! \return Number of fragments, 0 if the record is empty or longer than
+//!		FRAG_MAX_LENGTH
+// -------------------------------------------------------------------------- //
+
+uint8_t
+u8MSGKINEIS_FRAG_count
+(
+	uint16_t len
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Build a fragment of a record
+//!
+//! \param[in] data Record
+//! \param[in] len Length of the record
+//! \param[in] record Record number
+//! \param[in] index Fragment (0 to u8MSGKINEIS_FRAG_count(len) - 1)
+//! \param[out] ArgosMsgHandle Fragment message, with its CRC16 and BCH32
+//!
+//! \return false if the record cannot be sent or the index is out of range
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_FRAG_getFragment
+(
+	const uint8_t data[],
+	uint16_t len,
+	uint8_t record,
+	uint8_t index,
+	ArgosMsgTypeDef_t *ArgosMsgHandle
+);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // end MSG_KINEIS_FRAG_H
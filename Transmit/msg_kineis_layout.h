@@ -0,0 +1,361 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_layout.h
+//! @brief	Compile-time layout of the Kineis message MSGKINEIS_STDV1
+//!			A layout is a list of fields with a position and a width known at
+//!			compile time. Packing and unpacking a layout expands into constant
+//!			shifts and masks on each byte of the payload, with no loop, no
+//!			branch and no position arithmetic at run time. The results are
+//!			the same, bit for bit, as the msg_kineis_std setters.
+//!			C++11, no standard library : builds for the MCU as well as on host.
+// -------------------------------------------------------------------------- //
+
+#ifndef MSG_KINEIS_LAYOUT_H
+
+#define MSG_KINEIS_LAYOUT_H
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+
+#include <stdint.h>
+#include <string.h>
+
+#include "msg_kineis_std.h"
+
+
+// -------------------------------------------------------------------------- //
+//! Shift of a byte of the payload against the value of a field. A positive
+//! shift is to the right when packing.
+// -------------------------------------------------------------------------- //
+
+template <int Shift, bool Right = (Shift >= 0)>
+struct ArgosShift {
+	static inline uint32_t toByte(uint32_t value) { return value >> Shift; }
+	static inline uint32_t fromByte(uint32_t byte) { return byte << Shift; }
+};
+
+template <int Shift>
+struct ArgosShift<Shift, false> {
+	static inline uint32_t toByte(uint32_t value) { return value << -Shift; }
+	static inline uint32_t fromByte(uint32_t byte) { return byte >> -Shift; }
+};
+
+
+// -------------------------------------------------------------------------- //
+//! Bits [Position, Position + Width) of the payload, from byte 'Byte' to the
+//! last byte they cover
+// -------------------------------------------------------------------------- //
+
+template <uint16_t Position, uint8_t Width, uint16_t Byte,
+	bool InField = (Byte <= (Position + Width - 1) / 8)>
+struct ArgosBitSpan {
+	static constexpr uint16_t first = Position > Byte * 8 ? Position : Byte * 8;
+	static constexpr uint16_t end = Position + Width < Byte * 8 + 8 ? Position + Width : Byte * 8 + 8;
+	static constexpr uint8_t mask = (uint8_t)((0xff >> (first - Byte * 8)) & (0xff << (Byte * 8 + 8 - end)));
+
+	typedef ArgosShift<(int)(Position + Width) - (int)(Byte * 8 + 8)> Shift;
+	typedef ArgosBitSpan<Position, Width, Byte + 1> Next;
+
+	static inline void put(uint8_t payload[], uint32_t value)
+	{
+		payload[Byte] = (uint8_t)((payload[Byte] & ~mask) | (Shift::toByte(value) & mask));
+		Next::put(payload, value);
+	}
+
+	static inline uint32_t get(const uint8_t payload[])
+	{
+		return Shift::fromByte(payload[Byte] & mask) | Next::get(payload);
+	}
+};
+
+template <uint16_t Position, uint8_t Width, uint16_t Byte>
+struct ArgosBitSpan<Position, Width, Byte, false> {
+	static inline void put(uint8_t [], uint32_t) {}
+	static inline uint32_t get(const uint8_t []) { return 0; }
+};
+
+
+// -------------------------------------------------------------------------- //
+//! Unsigned field, up to 32 bits. Higher bits of the value are dropped.
+// -------------------------------------------------------------------------- //
+
+template <uint16_t Position, uint8_t Width, typename T = uint32_t>
+struct ArgosField {
+	static_assert(Width > 0 && Width <= 32, "A field holds 1 to 32 bits");
+
+	static constexpr uint16_t position = Position;
+	static constexpr uint16_t end = Position + Width;
+
+	typedef T PackType;
+	typedef T &UnpackType;
+	typedef ArgosBitSpan<Position, Width, Position / 8> Span;
+
+	static inline void pack(uint8_t payload[], T value)
+	{
+		Span::put(payload, (uint32_t)value);
+	}
+
+	static inline void unpack(const uint8_t payload[], T &value)
+	{
+		value = (T)Span::get(payload);
+	}
+};
+
+
+// -------------------------------------------------------------------------- //
+//! Signed field : sign bit followed by the magnitude, as
+//! u16MSGKINEIS_STDV1_setLocation stores the longitude and the latitude
+// -------------------------------------------------------------------------- //
+
+template <uint16_t Position, uint8_t Width>
+struct ArgosSignedField {
+	static constexpr uint16_t position = Position;
+	static constexpr uint16_t end = Position + Width;
+	static constexpr uint32_t sign = 1UL << (Width - 1);
+
+	typedef int32_t PackType;
+	typedef int32_t &UnpackType;
+	typedef ArgosField<Position, Width> Raw;
+
+	static inline void pack(uint8_t payload[], int32_t value)
+	{
+		Raw::pack(payload, value < 0 ? (uint32_t)-value | sign : (uint32_t)value);
+	}
+
+	static inline void unpack(const uint8_t payload[], int32_t &value)
+	{
+		uint32_t raw;
+
+		Raw::unpack(payload, raw);
+		value = raw & sign ? -(int32_t)(raw & (sign - 1)) : (int32_t)raw;
+	}
+};
+
+
+// -------------------------------------------------------------------------- //
+//! Scaled field : ABS((value + Offset) / Divisor), as
+//! u16MSGKINEIS_STDV1_setLocation stores the altitude
+// -------------------------------------------------------------------------- //
+
+template <uint16_t Position, uint8_t Width, int16_t Offset, int16_t Divisor>
+struct ArgosScaledField {
+	static constexpr uint16_t position = Position;
+	static constexpr uint16_t end = Position + Width;
+
+	typedef int16_t PackType;
+	typedef int16_t &UnpackType;
+	typedef ArgosField<Position, Width> Raw;
+
+	static inline void pack(uint8_t payload[], int16_t value)
+	{
+		int16_t scaled = (int16_t)((value + Offset) / Divisor);
+
+		Raw::pack(payload, (uint32_t)ABS(scaled));
+	}
+
+	static inline void unpack(const uint8_t payload[], int16_t &value)
+	{
+		uint32_t raw;
+
+		Raw::unpack(payload, raw);
+		value = (int16_t)((int16_t)raw * Divisor - Offset);
+	}
+};
+
+
+// -------------------------------------------------------------------------- //
+//! Bytes field of 'Bits' bits : whole bytes, then the high bits of the last
+//! one, as u16MSGKINEIS_STDV1_setUserData stores the user data
+// -------------------------------------------------------------------------- //
+
+template <uint16_t Position, uint16_t Bits, uint8_t Index = 0,
+	bool InField = (Index * 8 < Bits)>
+struct ArgosBytesSpan {
+	static constexpr uint8_t width = Bits - Index * 8 < 8 ? Bits - Index * 8 : 8;
+
+	typedef ArgosField<Position + Index * 8, width> Byte;
+	typedef ArgosBytesSpan<Position, Bits, Index + 1> Next;
+
+	static inline void put(uint8_t payload[], const uint8_t data[])
+	{
+		Byte::Span::put(payload, data[Index] >> (8 - width));
+		Next::put(payload, data);
+	}
+
+	static inline void get(const uint8_t payload[], uint8_t data[])
+	{
+		data[Index] = (uint8_t)(Byte::Span::get(payload) << (8 - width));
+		Next::get(payload, data);
+	}
+};
+
+template <uint16_t Position, uint16_t Bits, uint8_t Index>
+struct ArgosBytesSpan<Position, Bits, Index, false> {
+	static inline void put(uint8_t [], const uint8_t []) {}
+	static inline void get(const uint8_t [], uint8_t []) {}
+};
+
+template <uint16_t Position, uint16_t Bits>
+struct ArgosBytesField {
+	static constexpr uint16_t position = Position;
+	static constexpr uint16_t end = Position + Bits;
+	//!< Bytes of the data, the last one may be partly stored
+	static constexpr uint8_t length = (Bits + 7) / 8;
+
+	typedef const uint8_t *PackType;
+	typedef uint8_t *UnpackType;
+
+	//! 'data' holds 'length' bytes, padded with 0 as the setters do
+	static inline void pack(uint8_t payload[], const uint8_t data[])
+	{
+		ArgosBytesSpan<Position, Bits>::put(payload, data);
+	}
+
+	//! The low bits of a partly stored last byte are cleared
+	static inline void unpack(const uint8_t payload[], uint8_t data[])
+	{
+		ArgosBytesSpan<Position, Bits>::get(payload, data);
+	}
+};
+
+
+// -------------------------------------------------------------------------- //
+//! Layout : fields in increasing positions, packed and unpacked in one call
+//! with one value per field
+// -------------------------------------------------------------------------- //
+
+template <typename... Fields>
+struct ArgosLayout;
+
+template <>
+struct ArgosLayout<> {
+	static inline void pack(uint8_t []) {}
+	static inline void unpack(const uint8_t []) {}
+};
+
+template <typename Field, typename... Others>
+struct ArgosLayout<Field, Others...> {
+	static_assert(Field::end <= ARGOS_FRAME_LENGTH_BIT, "Field past the end of the payload");
+
+	static inline void pack(uint8_t payload[], typename Field::PackType value,
+		typename Others::PackType... others)
+	{
+		Field::pack(payload, value);
+		ArgosLayout<Others...>::pack(payload, others...);
+	}
+
+	static inline void unpack(const uint8_t payload[], typename Field::UnpackType value,
+		typename Others::UnpackType... others)
+	{
+		Field::unpack(payload, value);
+		ArgosLayout<Others...>::unpack(payload, others...);
+	}
+};
+
+
+// -------------------------------------------------------------------------- //
+// MSGKINEIS_STDV1 fields
+// -------------------------------------------------------------------------- //
+
+typedef ArgosField<POSITION_STD_EXT_ID, 4, uint8_t> ArgosStdv1ExtId;
+typedef ArgosField<POSITION_STD_CRC, 16, uint16_t> ArgosStdv1Crc16;
+typedef ArgosField<POSITION_STD_ACQ_PERIOD, 3, enum PeriodAcqGPS_t> ArgosStdv1AcqPeriod;
+typedef ArgosField<POSITION_STD_DATE, 5, uint8_t> ArgosStdv1Day;
+typedef ArgosField<POSITION_STD_DATE + 5, 5, uint8_t> ArgosStdv1Hour;
+typedef ArgosField<POSITION_STD_DATE + 10, 6, uint8_t> ArgosStdv1Min;
+typedef ArgosSignedField<POSITION_STD_LOC, 22> ArgosStdv1Lon;
+typedef ArgosSignedField<POSITION_STD_LOC + 22, 21> ArgosStdv1Lat;
+typedef ArgosScaledField<POSITION_STD_LOC + 43, 10, 500, 10> ArgosStdv1Alt;
+typedef ArgosField<POSITION_STD_BCH32, 32> ArgosStdv1Bch32;
+
+//!< User data up to the end of the payload : the BCH32 is written over its end
+typedef ArgosBytesField<POSITION_STD_USER_DATA,
+	ARGOS_FRAME_LENGTH_BIT - POSITION_STD_USER_DATA> ArgosStdv1UserData;
+typedef ArgosBytesField<POSITION_STD_USER_DATA_ONLY,
+	ARGOS_FRAME_LENGTH_BIT - POSITION_STD_USER_DATA_ONLY> ArgosStdv1UserDataOnly;
+
+static_assert(ArgosStdv1UserData::length == USER_DATA_LENGTH, "User data length mismatch");
+static_assert(ArgosStdv1UserDataOnly::length == USER_DATA_ONLY_LENGTH,
+	"User data only length mismatch");
+
+
+// -------------------------------------------------------------------------- //
+// MSGKINEIS_STDV1 layouts
+// -------------------------------------------------------------------------- //
+
+//! "Position and user data" message
+typedef ArgosLayout<ArgosStdv1AcqPeriod, ArgosStdv1Day, ArgosStdv1Hour, ArgosStdv1Min,
+	ArgosStdv1Lon, ArgosStdv1Lat, ArgosStdv1Alt, ArgosStdv1UserData> ArgosStdv1PositionLayout;
+
+//! "User data only" message
+typedef ArgosLayout<ArgosStdv1UserDataOnly> ArgosStdv1UserDataOnlyLayout;
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Encode a "position and user data" message
+//!
+//! Same payload as vMSGKINEIS_STDV1_cleanPayload, the position setters,
+//! u16MSGKINEIS_STDV1_setUserData and vMSGKINEIS_STDV1_setCRC16andBCH32.
+//!
+//! \param[out] ArgosMsgHandle Argos message
+//! \param[in] userData USER_DATA_LENGTH bytes, padded with 0
+// -------------------------------------------------------------------------- //
+
+static inline void vArgosStdv1_encodePosition(
+	ArgosMsgTypeDef_t *ArgosMsgHandle,
+	enum PeriodAcqGPS_t acqPeriod,
+	uint8_t day,
+	uint8_t hour,
+	uint8_t min,
+	int32_t lon,
+	int32_t lat,
+	int16_t alt,
+	const uint8_t userData[USER_DATA_LENGTH])
+{
+	memset(ArgosMsgHandle->payload, 0, ARGOS_FRAME_LENGTH);
+	ArgosStdv1PositionLayout::pack(ArgosMsgHandle->payload, acqPeriod, day, hour, min,
+		lon, lat, alt, userData);
+	vMSGKINEIS_STDV1_setCRC16andBCH32(ArgosMsgHandle, POSITION_STD_BCH32);
+}
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Encode a "user data only" message
+//!
+//! \param[out] ArgosMsgHandle Argos message
+//! \param[in] userData USER_DATA_ONLY_LENGTH bytes, padded with 0
+// -------------------------------------------------------------------------- //
+
+static inline void vArgosStdv1_encodeUserDataOnly(
+	ArgosMsgTypeDef_t *ArgosMsgHandle,
+	const uint8_t userData[USER_DATA_ONLY_LENGTH])
+{
+	memset(ArgosMsgHandle->payload, 0, ARGOS_FRAME_LENGTH);
+	ArgosStdv1UserDataOnlyLayout::pack(ArgosMsgHandle->payload, userData);
+	vMSGKINEIS_STDV1_setCRC16andBCH32(ArgosMsgHandle, POSITION_STD_BCH32);
+}
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Decode a "position and user data" message
+//!
+//! \param[in] ArgosMsgHandle Argos message
+//! \param[out] userData USER_DATA_LENGTH bytes, the end holds the BCH32
+// -------------------------------------------------------------------------- //
+
+static inline void vArgosStdv1_decodePosition(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	enum PeriodAcqGPS_t &acqPeriod,
+	uint8_t &day,
+	uint8_t &hour,
+	uint8_t &min,
+	int32_t &lon,
+	int32_t &lat,
+	int16_t &alt,
+	uint8_t userData[USER_DATA_LENGTH])
+{
+	ArgosStdv1PositionLayout::unpack(ArgosMsgHandle->payload, acqPeriod, day, hour, min,
+		lon, lat, alt, userData);
+}
+
+#endif // end MSG_KINEIS_LAYOUT_H
@@ -0,0 +1,218 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_packed.c
+//! @brief	Packed temperature readings in the MSGKINEIS_STDV1 user data
+// -------------------------------------------------------------------------- //
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+#include <string.h>
+#include "msg_kineis_packed.h"
+
+// -------------------------------------------------------------------------- //
+// Defines
+// -------------------------------------------------------------------------- //
+#define TAG_WIDTH			4
+#define SEQ_WIDTH			12
+#define INTERVAL_WIDTH		6
+#define COUNT_WIDTH			4
+#define FIRST_WIDTH			12
+#define DELTA_WIDTH			6
+
+#define POSITION_TAG		0
+#define POSITION_SEQ		(POSITION_TAG + TAG_WIDTH)
+#define POSITION_INTERVAL	(POSITION_SEQ + SEQ_WIDTH)
+#define POSITION_COUNT		(POSITION_INTERVAL + INTERVAL_WIDTH)
+#define POSITION_FIRST		(POSITION_COUNT + COUNT_WIDTH)
+#define POSITION_DELTA		(POSITION_FIRST + FIRST_WIDTH)
+
+
+// -------------------------------------------------------------------------- //
+//! Write a value, most significant bit first, in cleared user data
+// -------------------------------------------------------------------------- //
+
+static void vMSGKINEIS_PACKED_putBits(
+	uint8_t data[],
+	uint8_t position,
+	uint8_t length,
+	uint16_t value)
+{
+	while (length--) {
+		if ((value >> length) & 1)
+			data[position >> 3] |= 0x80 >> (position & 0x7);
+		position++;
+	}
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Read a value, most significant bit first
+// -------------------------------------------------------------------------- //
+
+static uint16_t u16MSGKINEIS_PACKED_getBits(
+	const uint8_t data[],
+	uint8_t position,
+	uint8_t length)
+{
+	uint16_t value = 0;
+
+	while (length--) {
+		value = (value << 1) | ((data[position >> 3] >> (7 - (position & 0x7))) & 1);
+		position++;
+	}
+
+	return value;
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Sign extend a two's complement value
+// -------------------------------------------------------------------------- //
+
+static inline int16_t s16MSGKINEIS_PACKED_signed(uint16_t value, uint8_t length)
+{
+	if (value & (1U << (length - 1)))
+		return (int16_t)(value - (1U << length));
+
+	return (int16_t)value;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Start a new set of readings
+// -------------------------------------------------------------------------- //
+
+void vMSGKINEIS_PACKED_init(
+	ArgosPackedReadingsTypeDef_t *readings,
+	uint16_t seq,
+	uint8_t interval)
+{
+	memset(readings, 0, sizeof(*readings));
+	readings->seq = seq & ((1U << SEQ_WIDTH) - 1);
+	readings->interval = interval;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Add a reading
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_PACKED_append(
+	ArgosPackedReadingsTypeDef_t *readings,
+	int16_t temperature)
+{
+	int16_t delta;
+
+	if (readings->count >= PACKED_MAX_READINGS)
+		return false;
+
+	if (temperature < PACKED_TEMPERATURE_MIN || temperature > PACKED_TEMPERATURE_MAX)
+		return false;
+
+	if (readings->count > 0) {
+		delta = temperature - readings->temperature[readings->count - 1];
+		if (delta < PACKED_DELTA_MIN || delta > PACKED_DELTA_MAX)
+			return false;
+	}
+
+	readings->temperature[readings->count++] = temperature;
+
+	return true;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Pack readings into user data
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_PACKED_toUserData(
+	const ArgosPackedReadingsTypeDef_t *readings,
+	uint8_t data[USER_DATA_LENGTH])
+{
+	int16_t delta;
+	uint8_t i;
+
+	if (readings == NULL || readings->count == 0 || readings->count > PACKED_MAX_READINGS ||
+		readings->interval == 0 || readings->interval > PACKED_MAX_INTERVAL)
+		return false;
+
+	memset(data, 0, USER_DATA_LENGTH);
+	vMSGKINEIS_PACKED_putBits(data, POSITION_TAG, TAG_WIDTH, PACKED_TAG);
+	vMSGKINEIS_PACKED_putBits(data, POSITION_SEQ, SEQ_WIDTH, readings->seq);
+	vMSGKINEIS_PACKED_putBits(data, POSITION_INTERVAL, INTERVAL_WIDTH, readings->interval);
+	vMSGKINEIS_PACKED_putBits(data, POSITION_COUNT, COUNT_WIDTH, readings->count);
+	vMSGKINEIS_PACKED_putBits(data, POSITION_FIRST, FIRST_WIDTH,
+		(uint16_t)readings->temperature[0] & ((1U << FIRST_WIDTH) - 1));
+
+	for (i = 1; i < readings->count; i++) {
+		delta = readings->temperature[i] - readings->temperature[i - 1];
+		if (delta < PACKED_DELTA_MIN || delta > PACKED_DELTA_MAX)
+			return false;
+		vMSGKINEIS_PACKED_putBits(data, POSITION_DELTA + (i - 1) * DELTA_WIDTH, DELTA_WIDTH,
+			(uint16_t)delta & ((1U << DELTA_WIDTH) - 1));
+	}
+
+	return true;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Add packed readings to Argos message
+// -------------------------------------------------------------------------- //
+
+uint16_t u16MSGKINEIS_PACKED_setUserData(
+	ArgosMsgTypeDef_t *ArgosMsgHandle,
+	const ArgosPackedReadingsTypeDef_t *readings,
+	uint16_t position)
+{
+	uint8_t data[USER_DATA_LENGTH];
+
+	if (!bMSGKINEIS_PACKED_toUserData(readings, data))
+		return 0xffff;
+
+	return u16MSGKINEIS_STDV1_setUserData(ArgosMsgHandle, data, USER_DATA_LENGTH, position);
+}
+
+
+// -------------------------------------------------------------------------- //
+// Tell if user data holds packed readings
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_PACKED_isPacked(
+	const uint8_t data[])
+{
+	return (data[0] >> 4) == PACKED_TAG;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Unpack readings from user data
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_PACKED_fromUserData(
+	const uint8_t data[USER_DATA_LENGTH],
+	ArgosPackedReadingsTypeDef_t *readings)
+{
+	uint8_t i;
+
+	if (data == NULL || readings == NULL || !bMSGKINEIS_PACKED_isPacked(data))
+		return false;
+
+	memset(readings, 0, sizeof(*readings));
+	readings->seq = u16MSGKINEIS_PACKED_getBits(data, POSITION_SEQ, SEQ_WIDTH);
+	readings->interval = (uint8_t)u16MSGKINEIS_PACKED_getBits(data, POSITION_INTERVAL, INTERVAL_WIDTH);
+	readings->count = (uint8_t)u16MSGKINEIS_PACKED_getBits(data, POSITION_COUNT, COUNT_WIDTH);
+	if (readings->count == 0 || readings->interval == 0)
+		return false;
+
+	readings->temperature[0] = s16MSGKINEIS_PACKED_signed(
+		u16MSGKINEIS_PACKED_getBits(data, POSITION_FIRST, FIRST_WIDTH), FIRST_WIDTH);
+
+	for (i = 1; i < readings->count; i++)
+		readings->temperature[i] = readings->temperature[i - 1] + s16MSGKINEIS_PACKED_signed(
+			u16MSGKINEIS_PACKED_getBits(data, POSITION_DELTA + (i - 1) * DELTA_WIDTH, DELTA_WIDTH),
+			DELTA_WIDTH);
+
+	return true;
+}
@@ -0,0 +1,185 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_packed.h
+//! @brief	Packed temperature readings in the MSGKINEIS_STDV1 user data
+//!			Several readings taken at a regular interval are sent in the
+//!			124 bits of user data of a "position and user data" message,
+//!			instead of one reading as text.
+// -------------------------------------------------------------------------- //
+
+
+// -------------------------------------------------------------------------- //
+//! * Packed user data :
+//! | Tag | Sequence | Interval | Count | First | Delta 1 | ... | Delta 14 | Spare |
+//! |     |          |          |       |       |         |     |          |       |
+//! |  4  |    12    |     6    |   4   |   12  |    6    |     |     6    |   2   |
+//!
+//! Tag : PACKED_TAG, never the high nibble of a text reading ('|' is 0x7C)
+//! Sequence : frame number, modulo 4096
+//! Interval : minutes between two readings
+//! Count : number of readings, the deltas past it are 0
+//! First : first reading, 0.1 degree C, two's complement
+//! Delta : difference to the previous reading, 0.1 degree C, two's complement
+//!
+//! The first reading is taken at the Day, Hour and Minute of the message.
+// -------------------------------------------------------------------------- //
+
+#ifndef MSG_KINEIS_PACKED_H
+
+#define MSG_KINEIS_PACKED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "msg_kineis_std.h"
+
+#pragma GCC visibility push(default)
+
+// -------------------------------------------------------------------------- //
+// Defines values
+// -------------------------------------------------------------------------- //
+
+#define PACKED_TAG					0xB
+#define PACKED_MAX_READINGS			15
+#define PACKED_MAX_INTERVAL			63
+
+//!< Range of the first reading and of the deltas (0.1 degree C)
+#define PACKED_TEMPERATURE_MIN		(-2048)
+#define PACKED_TEMPERATURE_MAX		2047
+#define PACKED_DELTA_MIN			(-32)
+#define PACKED_DELTA_MAX			31
+
+
+// -------------------------------------------------------------------------- //
+//! Readings of a packed message
+// -------------------------------------------------------------------------- //
+
+typedef struct ArgosPackedReadingsTypeDef_t {
+	uint16_t seq;		//!< Frame number (12 bits)
+	uint8_t interval;	//!< Minutes between two readings (1 to PACKED_MAX_INTERVAL)
+	uint8_t count;		//!< Number of readings (0 to PACKED_MAX_READINGS)
+	int16_t temperature[PACKED_MAX_READINGS];	//!< 0.1 degree C
+} ArgosPackedReadingsTypeDef_t;
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Start a new set of readings
+//!
+//! \param[out] readings Readings to clear
+//! \param[in] seq Frame number
+//! \param[in] interval Minutes between two readings
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_PACKED_init
+(
+	ArgosPackedReadingsTypeDef_t *readings,
+	uint16_t seq,
+	uint8_t interval
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Add a reading
+//!
+//! A reading is refused when the readings are full, when it is out of range
+//! or when it differs too much from the previous one : the readings must then
+//! be sent and a new set started with it.
+//!
+//! \param[in,out] readings Readings
+//! \param[in] temperature Reading (0.1 degree C)
+//!
+//! \return false if the reading was not added
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_PACKED_append
+(
+	ArgosPackedReadingsTypeDef_t *readings,
+	int16_t temperature
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Pack readings into user data
+//!
+//! \param[in] readings Readings, as built by bMSGKINEIS_PACKED_append
+//! \param[out] data USER_DATA_LENGTH bytes, the bytes past the packed bits
+//!		are cleared
+//!
+//! \return false if the readings cannot be packed
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_PACKED_toUserData
+(
+	const ArgosPackedReadingsTypeDef_t *readings,
+	uint8_t data[USER_DATA_LENGTH]
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Add packed readings to Argos message MSGKINEIS_STDV1
+//!
+//! \param[out] ArgosMsgHandle Argos message pointer
+//! \param[in] readings Readings
+//! \param[in] position Position in bit in the Argos message payload
+//!
+//! \return Last occupied bit, 0xffff if the readings cannot be packed
+// -------------------------------------------------------------------------- //
+
+uint16_t
+u16MSGKINEIS_PACKED_setUserData
+(
+	ArgosMsgTypeDef_t *ArgosMsgHandle,
+	const ArgosPackedReadingsTypeDef_t *readings,
+	uint16_t position
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Tell if user data holds packed readings
+//!
+//! \param[in] data User data
+//!
+//! \return true if it starts with PACKED_TAG
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_PACKED_isPacked
+(
+	const uint8_t data[]
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Unpack readings from user data
+//!
+//! \param[in] data User data, as decoded by bMSGKINEIS_STDV1_decode
+//! \param[out] readings Readings
+//!
+//! \return false if the user data does not hold packed readings
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_PACKED_fromUserData
+(
+	const uint8_t data[USER_DATA_LENGTH],
+	ArgosPackedReadingsTypeDef_t *readings
+);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // end MSG_KINEIS_PACKED_H
@@ -33,15 +33,67 @@
 // -------------------------------------------------------------------------- //
 // Includes
 // -------------------------------------------------------------------------- //
+#include <string.h>
 #include "msg_kineis_std.h"
 #include "msg_kineis_utils.h"
 
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_dword(addr)	(*(const uint32_t *)(addr))
+#endif
+
 // -------------------------------------------------------------------------- //
 // Defines
 // -------------------------------------------------------------------------- //
 #define BCH32_WIDTH		32
 #define CRC16_WIDTH		16
 
+//!< Longest field the accumulator takes in one shift, 7 bits may be pending
+#define WRITER_MAX_PUT	(sizeof(ArgosBitAccTypeDef_t) * 8 - 8)
+
+//!< Messages packed together by vMSGKINEIS_STDV1_encodeBatch
+#define BATCH_BLOCK		16
+
+//!< Bytes of the payload covered by the BCH32, and by the CRC16 from the 3rd
+#define CHECKED_LENGTH	((ARGOS_FRAME_LENGTH_BIT - BCH32_WIDTH) / 8)
+#define CRC16_OFFSET_BYTE	2
+
+// -------------------------------------------------------------------------- //
+//! BCH32 of a message holding nothing but one nibble of its CRC16, by nibble
+//! from the most significant one and value. The BCH32 is linear : the BCH32 of
+//! a message is that of the message with its CRC16 cleared, xored with the
+//! entries of the CRC16 nibbles.
+// -------------------------------------------------------------------------- //
+
+static const uint32_t au32CrcNibbleBch32[4][16] PROGMEM = {
+	{
+		0x00000000UL, 0xB9255E2BUL, 0x9C11FEABUL, 0x2534A080UL,
+		0xD678BFABUL, 0x6F5DE180UL, 0x4A694100UL, 0xF34C1F2BUL,
+		0x42AA3DABUL, 0xFB8F6380UL, 0xDEBBC300UL, 0x679E9D2BUL,
+		0x94D28200UL, 0x2DF7DC2BUL, 0x08C37CABUL, 0xB1E62280UL
+	},
+	{
+		0x00000000UL, 0xA407F853UL, 0xA654B25BUL, 0x02534A08UL,
+		0xA2F2264BUL, 0x06F5DE18UL, 0x04A69410UL, 0xA0A16C43UL,
+		0xABBF0E6BUL, 0x0FB8F638UL, 0x0DEBBC30UL, 0xA9EC4463UL,
+		0x094D2820UL, 0xAD4AD073UL, 0xAF199A7BUL, 0x0B1E6228UL
+	},
+	{
+		0x00000000UL, 0x52F8734AUL, 0xA5F0E694UL, 0xF70895DEUL,
+		0xA5BA8FD5UL, 0xF742FC9FUL, 0x004A6941UL, 0x52B21A0BUL,
+		0xA52E5D57UL, 0xF7D62E1DUL, 0x00DEBBC3UL, 0x5226C889UL,
+		0x0094D282UL, 0x526CA1C8UL, 0xA5643416UL, 0xF79C475CUL
+	},
+	{
+		0x00000000UL, 0x38E4EF6BUL, 0x71C9DED6UL, 0x492D31BDUL,
+		0xE393BDACUL, 0xDB7752C7UL, 0x925A637AUL, 0xAABE8C11UL,
+		0x297C39A5UL, 0x1198D6CEUL, 0x58B5E773UL, 0x60510818UL,
+		0xCAEF8409UL, 0xF20B6B62UL, 0xBB265ADFUL, 0x83C2B5B4UL
+	}
+};
+
 // -------------------------------------------------------------------------- //
 //! \brief Set one bit to 0 or 1 at the wanted position in the payload
 //!
@@ -91,23 +143,192 @@ uint16_t u16MSGKINEIS_STDV1_setValue(
 	uint16_t position,
 	uint16_t length)
 {
-	uint8_t j = 0;
-	bool val_bit;
-
-	position = position + length - 1;
-
-	while (j < length) {
-		if ((position - j + 1) % 8 == 0 && length - j > 7) {
-			ArgosMsgHandle->payload[(position - j) >> 3] = (value >> j) & 0xff;
-			j += 8;
-		} else {
-			val_bit = (value >> j) & 0x01;
-			vMSGKINEIS_STDV1_setBit(ArgosMsgHandle, val_bit, position-j);
-			j++;
-		}
+	ArgosBitWriterTypeDef_t writer;
+
+	vMSGKINEIS_STDV1_initWriter(&writer, ArgosMsgHandle, position);
+	vMSGKINEIS_STDV1_writeValue(&writer, value, length);
+
+	return u16MSGKINEIS_STDV1_closeWriter(&writer);
+}
+
+
+// -------------------------------------------------------------------------- //
+// Bitstream writer
+// -------------------------------------------------------------------------- //
+
+void vMSGKINEIS_STDV1_initWriter(
+	ArgosBitWriterTypeDef_t *writer,
+	ArgosMsgTypeDef_t *ArgosMsgHandle,
+	uint16_t position)
+{
+	writer->payload = ArgosMsgHandle->payload + (position >> 3);
+	writer->accBits = position & 0x7;
+	writer->position = position;
+
+	//!< Keep the bits preceding the position in the first byte
+	writer->acc = writer->accBits ? *writer->payload >> (8 - writer->accBits) : 0;
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Shift at most WRITER_MAX_PUT bits in and store the complete bytes
+// -------------------------------------------------------------------------- //
+
+static inline void vMSGKINEIS_STDV1_put(
+	ArgosBitWriterTypeDef_t *writer,
+	uint32_t value,
+	uint8_t length)
+{
+	ArgosBitAccTypeDef_t mask = ((ArgosBitAccTypeDef_t)1 << length) - 1;
+
+	writer->acc = (writer->acc << length) | (value & mask);
+	writer->accBits += length;
+	writer->position += length;
+
+	while (writer->accBits >= 8) {
+		writer->accBits -= 8;
+		*writer->payload++ = (uint8_t)(writer->acc >> writer->accBits);
 	}
+}
 
-	return position;
+
+void vMSGKINEIS_STDV1_writeValue(
+	ArgosBitWriterTypeDef_t *writer,
+	uint32_t value,
+	uint16_t length)
+{
+	//!< High part first : zeros above the 32 bits of the value
+	while (length > WRITER_MAX_PUT) {
+		length -= WRITER_MAX_PUT;
+		vMSGKINEIS_STDV1_put(writer, length >= 32 ? 0 : value >> length, WRITER_MAX_PUT);
+	}
+
+	if (length > 0)
+		vMSGKINEIS_STDV1_put(writer, value, length);
+}
+
+
+void vMSGKINEIS_STDV1_writeBytes(
+	ArgosBitWriterTypeDef_t *writer,
+	const uint8_t data[],
+	uint8_t len)
+{
+	uint8_t i;
+
+	if (len == 0)
+		return;
+
+	writer->position += (uint16_t)len * 8;
+
+	if (writer->accBits == 0) {
+		memcpy(writer->payload, data, len);
+		writer->payload += len;
+		return;
+	}
+
+	//!< The number of pending bits does not change : one byte in, one byte out
+	for (i = 0; i < len; i++) {
+		writer->acc = (writer->acc << 8) | data[i];
+		*writer->payload++ = (uint8_t)(writer->acc >> writer->accBits);
+	}
+}
+
+
+uint16_t u16MSGKINEIS_STDV1_closeWriter(
+	ArgosBitWriterTypeDef_t *writer)
+{
+	uint8_t keep;
+
+	//!< Merge the pending bits with the bits following them in the last byte
+	if (writer->accBits) {
+		keep = 0xff >> writer->accBits;
+		*writer->payload = (uint8_t)(writer->acc << (8 - writer->accBits)) |
+			(*writer->payload & keep);
+		writer->acc = 0;
+		writer->accBits = 0;
+	}
+
+	return writer->position - 1;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Message writer
+// -------------------------------------------------------------------------- //
+
+//!< Add the bytes completed since the last call to the checksums
+static void vMSGKINEIS_STDV1_checkBytes(
+	ArgosFrameWriterTypeDef_t *writer,
+	uint8_t *end)
+{
+	uint8_t *last = writer->ArgosMsgHandle->payload + CHECKED_LENGTH;
+	uint16_t lengthBit;
+
+	if (end > last)
+		end = last;
+	if (end <= writer->checked)
+		return;
+
+	lengthBit = (uint16_t)(end - writer->checked) * 8;
+	vMSG_KINEIS_UTILS_updateCrc16(&writer->crc, writer->checked, lengthBit);
+	vMSG_KINEIS_UTILS_updateBch32(&writer->bch, writer->checked, lengthBit);
+	writer->checked = end;
+}
+
+
+void vMSGKINEIS_STDV1_initFrameWriter(
+	ArgosFrameWriterTypeDef_t *writer,
+	ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	memset(ArgosMsgHandle->payload, 0, ARGOS_FRAME_LENGTH);
+	vMSGKINEIS_STDV1_initWriter(&writer->bits, ArgosMsgHandle, POSITION_STD_ACQ_PERIOD);
+	vMSG_KINEIS_UTILS_initCrc16(&writer->crc);
+	vMSG_KINEIS_UTILS_initBch32(&writer->bch);
+	writer->ArgosMsgHandle = ArgosMsgHandle;
+
+	//!< The bytes before hold the ext ID and the CRC16, cleared : the remainders stay null
+	writer->checked = ArgosMsgHandle->payload + CRC16_OFFSET_BYTE;
+}
+
+
+void vMSGKINEIS_STDV1_writeFrameValue(
+	ArgosFrameWriterTypeDef_t *writer,
+	uint32_t value,
+	uint16_t length)
+{
+	vMSGKINEIS_STDV1_writeValue(&writer->bits, value, length);
+	vMSGKINEIS_STDV1_checkBytes(writer, writer->bits.payload);
+}
+
+
+void vMSGKINEIS_STDV1_writeFrameBytes(
+	ArgosFrameWriterTypeDef_t *writer,
+	const uint8_t data[],
+	uint8_t len)
+{
+	vMSGKINEIS_STDV1_writeBytes(&writer->bits, data, len);
+	vMSGKINEIS_STDV1_checkBytes(writer, writer->bits.payload);
+}
+
+
+void vMSGKINEIS_STDV1_closeFrameWriter(
+	ArgosFrameWriterTypeDef_t *writer)
+{
+	ArgosMsgTypeDef_t *ArgosMsgHandle = writer->ArgosMsgHandle;
+	uint32_t bch;
+	uint16_t crc;
+	uint8_t i;
+
+	u16MSGKINEIS_STDV1_closeWriter(&writer->bits);
+	vMSGKINEIS_STDV1_checkBytes(writer, ArgosMsgHandle->payload + CHECKED_LENGTH);
+
+	crc = u16MSG_KINEIS_UTILS_finalCrc16(&writer->crc);
+	bch = u32MSG_KINEIS_UTILS_finalBch32(&writer->bch);
+	for (i = 0; i < 4; i++)
+		bch ^= pgm_read_dword(&au32CrcNibbleBch32[i][(crc >> (12 - 4 * i)) & 0xf]);
+
+	u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, crc, POSITION_STD_CRC, CRC16_WIDTH);
+	u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, bch, POSITION_STD_BCH32, BCH32_WIDTH);
 }
 
 
@@ -142,20 +363,24 @@ uint16_t u16MSGKINEIS_STDV1_setDate(
 	uint8_t min,
 	uint16_t position)
 {
+	ArgosBitWriterTypeDef_t writer;
+
 	if (ArgosMsgHandle == NULL)
 		return 0xffff;
 
+	vMSGKINEIS_STDV1_initWriter(&writer, ArgosMsgHandle, position);
+
 	//!< Day	: 5 bits
-	position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, day, position, 5);
+	vMSGKINEIS_STDV1_writeValue(&writer, day, 5);
 
 	//!< Hour	: 5 bits
-	position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, hour, position + 1, 5);
+	vMSGKINEIS_STDV1_writeValue(&writer, hour, 5);
 
 	//!< Min	: 6 bits
-	position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, min, position + 1, 6);
+	vMSGKINEIS_STDV1_writeValue(&writer, min, 6);
 
 	//!< Last bit occupied
-	return position;
+	return u16MSGKINEIS_STDV1_closeWriter(&writer);
 }
 
 
@@ -170,6 +395,8 @@ uint16_t u16MSGKINEIS_STDV1_setLocation(
 	int16_t alt,
 	uint16_t position)
 {
+	ArgosBitWriterTypeDef_t writer;
+
 	if (ArgosMsgHandle == NULL)
 		return 0xffff;
 
@@ -177,25 +404,27 @@ uint16_t u16MSGKINEIS_STDV1_setLocation(
 
 	if (lon < 0) {
 		lon = ABS(lon);
-		lon |= (1 << 21);
+		lon |= (1UL << 21);
 	}
 
 	if (lat < 0) {
 		lat = ABS(lat);
-		lat |= (1 << 20);
+		lat |= (1UL << 20);
 	}
 
+	vMSGKINEIS_STDV1_initWriter(&writer, ArgosMsgHandle, position);
+
 	//!< Longitude : 22 bits
-	position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, lon, position, 22);
+	vMSGKINEIS_STDV1_writeValue(&writer, lon, 22);
 
 	//!< Latitude	: 21 bits
-	position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, lat, position + 1, 21);
+	vMSGKINEIS_STDV1_writeValue(&writer, lat, 21);
 
 	//!< Altitude	: 10 bits
-	position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, alt, position + 1, 10);
+	vMSGKINEIS_STDV1_writeValue(&writer, alt, 10);
 
 	//!< Last bit occupied
-	return position;
+	return u16MSGKINEIS_STDV1_closeWriter(&writer);
 }
 
 
@@ -210,9 +439,8 @@ uint16_t u16MSGKINEIS_STDV1_setUserData(
 	uint16_t position)
 {
 	//User data	: 19.5 bytes
-	uint8_t i;
-
-	position--;
+	ArgosBitWriterTypeDef_t writer;
+	uint8_t full;
 
 	if (ArgosMsgHandle == NULL)
 		return 0xffff;
@@ -220,19 +448,20 @@ uint16_t u16MSGKINEIS_STDV1_setUserData(
 	if (len > USER_DATA_LENGTH)
 		len = USER_DATA_LENGTH;
 
-	for (i = 0; i < len && i < (USER_DATA_LENGTH) - 1; i++)
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, data[i], position + 1, 8);
+	//!< Whole bytes, then the high nibble of the last one
+	full = len < (USER_DATA_LENGTH) - 1 ? len : (USER_DATA_LENGTH) - 1;
 
-	for (i = len; i < (USER_DATA_LENGTH) - 1; i++)
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, 0, position + 1, 8);
+	vMSGKINEIS_STDV1_initWriter(&writer, ArgosMsgHandle, position);
+	vMSGKINEIS_STDV1_writeBytes(&writer, data, full);
+	vMSGKINEIS_STDV1_writeValue(&writer, 0, ((USER_DATA_LENGTH) - 1 - full) * 8);
 
 	if (len == USER_DATA_LENGTH)
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, data[len - 1] >> 4, position + 1, 4);
+		vMSGKINEIS_STDV1_writeValue(&writer, data[len - 1] >> 4, 4);
 	else
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, 0, position + 1, 4);
+		vMSGKINEIS_STDV1_writeValue(&writer, 0, 4);
 
 	//!< Last bit occupied
-	return position;
+	return u16MSGKINEIS_STDV1_closeWriter(&writer);
 }
 
 
@@ -247,9 +476,8 @@ uint16_t u16MSGKINEIS_STDV1_setUserDataOnly(
 	uint16_t position)
 {
 	//User data	ONLY : 28.5 bytes
-	uint8_t i;
-
-	position--;
+	ArgosBitWriterTypeDef_t writer;
+	uint8_t full;
 
 	if (ArgosMsgHandle == NULL)
 		return 0xffff;
@@ -257,19 +485,20 @@ uint16_t u16MSGKINEIS_STDV1_setUserDataOnly(
 	if (len > USER_DATA_ONLY_LENGTH)
 		len = USER_DATA_ONLY_LENGTH;
 
-	for (i = 0; i < len && i < (USER_DATA_ONLY_LENGTH) - 1; i++)
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, data[i], position + 1, 8);
+	//!< Whole bytes, then the high nibble of the last one
+	full = len < (USER_DATA_ONLY_LENGTH) - 1 ? len : (USER_DATA_ONLY_LENGTH) - 1;
 
-	for (i = len; i < (USER_DATA_ONLY_LENGTH) - 1; i++)
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, 0, position + 1, 8);
+	vMSGKINEIS_STDV1_initWriter(&writer, ArgosMsgHandle, position);
+	vMSGKINEIS_STDV1_writeBytes(&writer, data, full);
+	vMSGKINEIS_STDV1_writeValue(&writer, 0, ((USER_DATA_ONLY_LENGTH) - 1 - full) * 8);
 
 	if (len == USER_DATA_ONLY_LENGTH)
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, data[len - 1] >> 4, position + 1, 4);
+		vMSGKINEIS_STDV1_writeValue(&writer, data[len - 1] >> 4, 4);
 	else
-		position = u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, 0, position + 1, 4);
+		vMSGKINEIS_STDV1_writeValue(&writer, 0, 4);
 
 	//!< Last bit occupied
-	return position;
+	return u16MSGKINEIS_STDV1_closeWriter(&writer);
 }
 
 
@@ -301,7 +530,31 @@ void
 vMSGKINEIS_STDV1_cleanPayload(
 	ArgosMsgTypeDef_t *ArgosMsgHandle)
 {
-	u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, 0, 0, ARGOS_FRAME_LENGTH_BIT);
+	memset(ArgosMsgHandle->payload, 0, ARGOS_FRAME_LENGTH);
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Write the payload as upper case hexadecimal text
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_toHex(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	char hex[ARGOS_FRAME_HEX_LENGTH + 1])
+{
+	static const char digits[16] = {
+		'0', '1', '2', '3', '4', '5', '6', '7',
+		'8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+	};
+	const uint8_t *byte = ArgosMsgHandle->payload;
+	const uint8_t *end = byte + ARGOS_FRAME_LENGTH;
+
+	for (; byte < end; byte++, hex += 2) {
+		hex[0] = digits[*byte >> 4];
+		hex[1] = digits[*byte & 0x0F];
+	}
+	*hex = '\0';
 }
 
 
@@ -331,3 +584,85 @@ void vMSGKINEIS_STDV1_setCRC16andBCH32(
 
 	u16MSGKINEIS_STDV1_setValue(ArgosMsgHandle, bch, position, BCH32_WIDTH);
 }
+
+
+// -------------------------------------------------------------------------- //
+//! Encode a batch of "position and user data" messages
+//!
+//! Bits 20 to 91 (acqPeriod to altitude) of a message are first packed in a
+//! 64 bits word holding bits 20 to 83 and a byte holding bits 84 to 91.
+// -------------------------------------------------------------------------- //
+
+void vMSGKINEIS_STDV1_encodeBatch(
+	ArgosMsgTypeDef_t ArgosMsgHandles[],
+	const ArgosReadingsTypeDef_t *readings,
+	enum PeriodAcqGPS_t acqPeriod,
+	uint16_t count)
+{
+	uint64_t head[BATCH_BLOCK];
+	uint8_t tail[BATCH_BLOCK];
+	uint16_t base;
+	uint16_t n;
+	uint16_t i;
+	uint8_t j;
+
+	for (base = 0; base < count; base += n) {
+		const uint8_t *day = readings->day + base;
+		const uint8_t *hour = readings->hour + base;
+		const uint8_t *min = readings->min + base;
+		const int32_t *lon = readings->lon + base;
+		const int32_t *lat = readings->lat + base;
+		const int16_t *alt = readings->alt + base;
+		ArgosMsgTypeDef_t *msg = ArgosMsgHandles + base;
+
+		n = count - base < BATCH_BLOCK ? count - base : BATCH_BLOCK;
+
+		//!< Fixed layout fields, branch-free
+		for (i = 0; i < n; i++) {
+			int32_t lonSign = lon[i] < 0 ? -1 : 0;
+			int32_t latSign = lat[i] < 0 ? -1 : 0;
+			int32_t altDiv = (alt[i] + 500) / 10;
+			int32_t altSign = altDiv < 0 ? -1 : 0;
+			uint32_t ulon = ((uint32_t)((lon[i] ^ lonSign) - lonSign) |
+				((uint32_t)lonSign & (1UL << 21))) & 0x3fffff;
+			uint32_t ulat = ((uint32_t)((lat[i] ^ latSign) - latSign) |
+				((uint32_t)latSign & (1UL << 20))) & 0x1fffff;
+			uint32_t ualt = (uint32_t)((altDiv ^ altSign) - altSign) & 0x3ff;
+
+			head[i] = ((uint64_t)(acqPeriod & 0x7) << 61) |
+				((uint64_t)(day[i] & 0x1f) << 56) |
+				((uint64_t)(hour[i] & 0x1f) << 51) |
+				((uint64_t)(min[i] & 0x3f) << 45) |
+				((uint64_t)ulon << 23) |
+				((uint64_t)ulat << 2) |
+				(ualt >> 8);
+			tail[i] = (uint8_t)ualt;
+		}
+
+		//!< Bytes 0 to 11 : ext ID and CRC are cleared, then the fixed fields
+		for (i = 0; i < n; i++) {
+			uint8_t *p = msg[i].payload;
+
+			p[0] = 0;
+			p[1] = 0;
+			p[2] = (uint8_t)(head[i] >> 60);
+			for (j = 0; j < 7; j++)
+				p[3 + j] = (uint8_t)(head[i] >> (52 - 8 * j));
+			p[10] = (uint8_t)((head[i] << 4) | (tail[i] >> 4));
+			p[11] = (uint8_t)(tail[i] << 4);
+		}
+
+		//!< User data starts on the low nibble of byte 11
+		for (i = 0; i < n; i++) {
+			const uint8_t *data = readings->userData + (uint32_t)(base + i) * USER_DATA_LENGTH;
+			uint8_t *p = msg[i].payload + (POSITION_STD_USER_DATA >> 3);
+
+			p[0] |= data[0] >> 4;
+			for (j = 1; j < USER_DATA_LENGTH; j++)
+				p[j] = (uint8_t)((data[j - 1] << 4) | (data[j] >> 4));
+		}
+
+		for (i = 0; i < n; i++)
+			vMSGKINEIS_STDV1_setCRC16andBCH32(&msg[i], POSITION_STD_BCH32);
+	}
+}
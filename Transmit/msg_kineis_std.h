@@ -46,6 +46,8 @@ extern "C" {
 #include <stdio.h>
 #include <stdint.h>
 
+#include "msg_kineis_utils.h"
+
 #pragma GCC visibility push(default)
 
 // -------------------------------------------------------------------------- //
@@ -60,6 +62,9 @@ extern "C" {
 #define ARGOS_FRAME_LENGTH		((11) + (USER_DATA_LENGTH))
 #define ARGOS_FRAME_LENGTH_BIT	(ARGOS_FRAME_LENGTH*8)
 
+//!< Length of the hexadecimal text of a payload (characters)
+#define ARGOS_FRAME_HEX_LENGTH		(ARGOS_FRAME_LENGTH * 2)
+
 //!< Position of the different parts in the payload (in bit)
 #define POSITION_STD_EXT_ID			0
 #define POSITION_STD_CRC			4
@@ -88,6 +93,64 @@ typedef struct ArgosMsgTypeDef_t {
 } ArgosMsgTypeDef_t;
 
 
+// -------------------------------------------------------------------------- //
+//! Bit writer accumulator : 64 bits on host, 32 bits on 8-bit MCUs where 64 bits
+//! shifts are library calls
+// -------------------------------------------------------------------------- //
+
+#ifdef __AVR__
+typedef uint32_t ArgosBitAccTypeDef_t;
+#else
+typedef uint64_t ArgosBitAccTypeDef_t;
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//! Bitstream writer over an Argos message payload
+//!
+//! Fields are shifted into the accumulator and whole bytes are stored as soon
+//! as they are complete. Bits outside the written range keep their value.
+// -------------------------------------------------------------------------- //
+
+typedef struct ArgosBitWriterTypeDef_t {
+	uint8_t *payload;			//!< Next byte to store
+	ArgosBitAccTypeDef_t acc;	//!< Pending bits, right aligned
+	uint8_t accBits;			//!< Number of pending bits (0 to 7 between calls)
+	uint16_t position;			//!< Next bit to write
+} ArgosBitWriterTypeDef_t;
+
+
+// -------------------------------------------------------------------------- //
+//! Bitstream writer of a whole message, from the acqPeriod to the BCH32
+//!
+//! Each byte is added to the CRC16 and the BCH32 as soon as it is complete,
+//! so the checksums need no pass of their own over the payload.
+// -------------------------------------------------------------------------- //
+
+typedef struct ArgosFrameWriterTypeDef_t {
+	ArgosBitWriterTypeDef_t bits;
+	MsgKineisCrc16CtxTypeDef_t crc;		//!< From the 3rd byte, the CRC16 still cleared
+	MsgKineisBch32CtxTypeDef_t bch;		//!< From the 1st byte, the CRC16 still cleared
+	uint8_t *checked;					//!< Next byte not yet in the checksums
+	ArgosMsgTypeDef_t *ArgosMsgHandle;
+} ArgosFrameWriterTypeDef_t;
+
+
+// -------------------------------------------------------------------------- //
+//! Readings encoded by vMSGKINEIS_STDV1_encodeBatch, one array per field
+// -------------------------------------------------------------------------- //
+
+typedef struct ArgosReadingsTypeDef_t {
+	const uint8_t *day;
+	const uint8_t *hour;
+	const uint8_t *min;
+	const int32_t *lon;			//!< See u16MSGKINEIS_STDV1_setLocation
+	const int32_t *lat;
+	const int16_t *alt;
+	const uint8_t *userData;	//!< USER_DATA_LENGTH bytes per reading
+} ArgosReadingsTypeDef_t;
+
+
 //! Time between two successive GPS positions
 enum PeriodAcqGPS_t {
 	PRD_1_MIN	= 0b000,
@@ -317,6 +380,25 @@ vMSGKINEIS_STDV1_cleanPayload
 );
 
 
+// -------------------------------------------------------------------------- //
+//! \brief Write the payload as upper case hexadecimal text
+//!
+//! This is the text sent to the KIM1 module. It is written straight into the
+//! buffer of the caller, two characters per byte from a table of the digits,
+//! followed by a terminating 0.
+//!
+//! \param[in] ArgosMsgHandle Argos message
+//! \param[out] hex ARGOS_FRAME_HEX_LENGTH characters and a terminating 0
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_toHex
+(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	char hex[ARGOS_FRAME_HEX_LENGTH + 1]
+);
+
+
 // -------------------------------------------------------------------------- //
 //! \brief Set CRC16 and BCH32 in the payload
 //!
@@ -335,6 +417,174 @@ void vMSGKINEIS_STDV1_setCRC16andBCH32
 	uint16_t position
 );
 
+
+// -------------------------------------------------------------------------- //
+//! \brief Encode a batch of "position and user data" messages
+//!
+//! Each message is the same as the sequence vMSGKINEIS_STDV1_cleanPayload,
+//! u16MSGKINEIS_STDV1_setAcqPeriod, u16MSGKINEIS_STDV1_setDate,
+//! u16MSGKINEIS_STDV1_setLocation, u16MSGKINEIS_STDV1_setUserData (with
+//! USER_DATA_LENGTH bytes) and vMSGKINEIS_STDV1_setCRC16andBCH32 at the
+//! POSITION_STD_* positions.
+//!
+//! The fixed layout fields of a block of messages are packed in branch-free
+//! loops the compiler can vectorise, then the checksums are appended.
+//!
+//! \param[out] ArgosMsgHandles Argos messages, 'count' elements
+//! \param[in] readings Readings, 'count' elements per array
+//! \param[in] acqPeriod Acquisition period of all messages
+//! \param[in] count Number of messages
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_encodeBatch
+(
+	ArgosMsgTypeDef_t ArgosMsgHandles[],
+	const ArgosReadingsTypeDef_t *readings,
+	enum PeriodAcqGPS_t acqPeriod,
+	uint16_t count
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Start writing fields at the wanted position in the payload
+//!
+//! \param[out] writer Bit writer
+//! \param[in] ArgosMsgHandle Argos message pointer
+//! \param[in] position Position in bit of the first field
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_initWriter
+(
+	ArgosBitWriterTypeDef_t *writer,
+	ArgosMsgTypeDef_t *ArgosMsgHandle,
+	uint16_t position
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Append a value to the bitstream, MSB first
+//!
+//! \param[in,out] writer Bit writer
+//! \param[in] value Value, only its 'length' low bits are written. Bits above
+//!		the 32 bits of the value are written as 0.
+//! \param[in] length Length in bit of the field
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_writeValue
+(
+	ArgosBitWriterTypeDef_t *writer,
+	uint32_t value,
+	uint16_t length
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Append bytes to the bitstream
+//!
+//! Bytes are copied when the bitstream is byte aligned and shifted through the
+//! accumulator otherwise.
+//!
+//! \param[in,out] writer Bit writer
+//! \param[in] data Bytes to write
+//! \param[in] len Number of bytes
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_writeBytes
+(
+	ArgosBitWriterTypeDef_t *writer,
+	const uint8_t data[],
+	uint8_t len
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Store the pending bits
+//!
+//! \param[in,out] writer Bit writer
+//!
+//! \return Last occupied bit
+// -------------------------------------------------------------------------- //
+
+uint16_t
+u16MSGKINEIS_STDV1_closeWriter
+(
+	ArgosBitWriterTypeDef_t *writer
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Start writing a message, fields from POSITION_STD_ACQ_PERIOD
+//!
+//! The payload is cleared. Fields are then appended in order with
+//! vMSGKINEIS_STDV1_writeFrameValue and vMSGKINEIS_STDV1_writeFrameBytes, up
+//! to POSITION_STD_BCH32 at most, and vMSGKINEIS_STDV1_closeFrameWriter adds
+//! the CRC16 and the BCH32. The payload is the same as with the setters
+//! followed by vMSGKINEIS_STDV1_setCRC16andBCH32.
+//!
+//! \param[out] writer Message writer
+//! \param[in] ArgosMsgHandle Argos message pointer
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_initFrameWriter
+(
+	ArgosFrameWriterTypeDef_t *writer,
+	ArgosMsgTypeDef_t *ArgosMsgHandle
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Append a value to the message, see vMSGKINEIS_STDV1_writeValue
+//!
+//! \param[in,out] writer Message writer
+//! \param[in] value Value, only its 'length' low bits are written
+//! \param[in] length Length in bit of the field
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_writeFrameValue
+(
+	ArgosFrameWriterTypeDef_t *writer,
+	uint32_t value,
+	uint16_t length
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Append bytes to the message, see vMSGKINEIS_STDV1_writeBytes
+//!
+//! \param[in,out] writer Message writer
+//! \param[in] data Bytes to write
+//! \param[in] len Number of bytes
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_writeFrameBytes
+(
+	ArgosFrameWriterTypeDef_t *writer,
+	const uint8_t data[],
+	uint8_t len
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief End the message : set its CRC16 and BCH32
+//!
+//! Bits not written up to the BCH32 are left at 0.
+//!
+//! \param[in,out] writer Message writer
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_closeFrameWriter
+(
+	ArgosFrameWriterTypeDef_t *writer
+);
+
 #pragma GCC visibility pop
 
 #ifdef __cplusplus
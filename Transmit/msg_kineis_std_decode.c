@@ -0,0 +1,362 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_std_decode.c
+//! @brief	Kineis message MSGKINEIS_STDV1 decoding algorithms
+//!			Inverse of the msg_kineis_std setters for the "position and user
+//!			data" format, from a payload or from its hexadecimal text as
+//!			found in the RAW_DATA field of Kineis exports.
+// -------------------------------------------------------------------------- //
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+#include <string.h>
+#include "msg_kineis_std_decode.h"
+#include "msg_kineis_utils.h"
+
+// -------------------------------------------------------------------------- //
+// Defines
+// -------------------------------------------------------------------------- //
+#define BCH32_WIDTH		32
+#define CRC16_WIDTH		16
+
+//!< Bytes covered by the CRC16 : from the 3rd byte to the BCH32
+#define CRC16_OFFSET_BYTE	2
+#define CRC16_LENGTH_BIT	(ARGOS_FRAME_LENGTH_BIT - CRC16_WIDTH - BCH32_WIDTH)
+
+
+// -------------------------------------------------------------------------- //
+// Get an uint32_t value at the wanted position in the payload
+// -------------------------------------------------------------------------- //
+
+uint32_t u32MSGKINEIS_STDV1_getValue(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	uint16_t position,
+	uint16_t length)
+{
+	const uint8_t *byte;
+	const uint8_t *last;
+	uint8_t trailing;
+	uint32_t value;
+
+	if (length == 0)
+		return 0;
+
+	byte = ArgosMsgHandle->payload + (position >> 3);
+	last = ArgosMsgHandle->payload + ((position + length - 1) >> 3);
+
+	//!< Bits following the value in its last byte
+	trailing = 7 - ((position + length - 1) & 0x7);
+
+	value = *byte & (0xff >> (position & 0x7));
+	if (byte == last)
+		return value >> trailing;
+
+	while (++byte < last)
+		value = (value << 8) | *byte;
+
+	return (value << (8 - trailing)) | (*last >> trailing);
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Get bytes starting at the wanted position in the payload
+// -------------------------------------------------------------------------- //
+
+static void vMSGKINEIS_STDV1_getBytes(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	uint16_t position,
+	uint8_t data[],
+	uint8_t len)
+{
+	const uint8_t *byte = ArgosMsgHandle->payload + (position >> 3);
+	const uint8_t *end = ArgosMsgHandle->payload + ARGOS_FRAME_LENGTH;
+	uint8_t shift = position & 0x7;
+	uint8_t i;
+
+	if (shift == 0) {
+		memcpy(data, byte, len);
+		return;
+	}
+
+	//!< The last byte may end past the payload : its missing bits are 0
+	for (i = 0; i < len; i++, byte++)
+		data[i] = (uint8_t)((byte[0] << shift) |
+			(byte + 1 < end ? byte[1] >> (8 - shift) : 0));
+}
+
+
+// -------------------------------------------------------------------------- //
+//! Value of an hexadecimal digit, -1 if it is not one
+// -------------------------------------------------------------------------- //
+
+static inline int8_t s8MSGKINEIS_STDV1_hexDigit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+
+	c |= 0x20;
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+
+	return -1;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Convert the hexadecimal text of a payload
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_STDV1_fromHex(
+	const char *hex,
+	uint16_t len,
+	ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	int8_t high;
+	int8_t low;
+	uint8_t i;
+
+	if (ArgosMsgHandle == NULL || hex == NULL || len % 2 || len > ARGOS_FRAME_HEX_LENGTH)
+		return false;
+
+	for (i = 0; i < len / 2; i++) {
+		high = s8MSGKINEIS_STDV1_hexDigit(hex[2 * i]);
+		low = s8MSGKINEIS_STDV1_hexDigit(hex[2 * i + 1]);
+		if (high < 0 || low < 0)
+			return false;
+		ArgosMsgHandle->payload[i] = (uint8_t)((high << 4) | low);
+	}
+
+	memset(ArgosMsgHandle->payload + len / 2, 0, ARGOS_FRAME_LENGTH - len / 2);
+
+	return true;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Check the CRC16
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_STDV1_checkCRC16(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	uint8_t covered[CRC16_LENGTH_BIT / 8];
+	uint16_t crc;
+
+	//!< The CRC16 was computed while its own field was still cleared
+	memcpy(covered, ArgosMsgHandle->payload + CRC16_OFFSET_BYTE, sizeof(covered));
+	covered[0] &= 0x0f;
+
+	crc = u16MSG_KINEIS_UTILS_calcCRC16(covered, CRC16_LENGTH_BIT);
+
+	return crc == u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_CRC, CRC16_WIDTH);
+}
+
+
+// -------------------------------------------------------------------------- //
+// Check the BCH32
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_STDV1_checkBCH32(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle)
+{
+	//!< The remainder of a message followed by its BCH32 is null
+	return u32MSG_KINEIS_UTILS_calcBCH32(ArgosMsgHandle->payload, ARGOS_FRAME_LENGTH_BIT) == 0;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Decode a "position and user data" message
+// -------------------------------------------------------------------------- //
+
+bool bMSGKINEIS_STDV1_decode(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	ArgosDecodedMsgTypeDef_t *decoded)
+{
+	uint32_t lon;
+	uint32_t lat;
+
+	if (ArgosMsgHandle == NULL || decoded == NULL)
+		return false;
+
+	decoded->extId = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_EXT_ID, 4);
+	decoded->crc = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_CRC, CRC16_WIDTH);
+	decoded->acqPeriod = (enum PeriodAcqGPS_t)u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle,
+		POSITION_STD_ACQ_PERIOD, 3);
+
+	//!< Day : 5 bits, Hour : 5 bits, Min : 6 bits
+	decoded->day = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_DATE, 5);
+	decoded->hour = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_DATE + 5, 5);
+	decoded->min = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_DATE + 10, 6);
+
+	//!< Longitude : 22 bits, Latitude : 21 bits, Altitude : 10 bits
+	lon = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_LOC, 22);
+	lat = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_LOC + 22, 21);
+
+	decoded->lon = (int32_t)(lon & 0x1fffff);
+	if (lon & (1UL << 21))
+		decoded->lon = -decoded->lon;
+
+	decoded->lat = (int32_t)(lat & 0xfffff);
+	if (lat & (1UL << 20))
+		decoded->lat = -decoded->lat;
+
+	decoded->alt = (int16_t)u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle,
+		POSITION_STD_LOC + 43, 10) * 10 - 500;
+
+	//!< User data : the last byte only has its high nibble in the payload
+	vMSGKINEIS_STDV1_getBytes(ArgosMsgHandle, POSITION_STD_USER_DATA,
+		decoded->userData, USER_DATA_LENGTH);
+
+	decoded->bch = u32MSGKINEIS_STDV1_getValue(ArgosMsgHandle, POSITION_STD_BCH32, BCH32_WIDTH);
+
+	decoded->crcOk = bMSGKINEIS_STDV1_checkCRC16(ArgosMsgHandle);
+	decoded->bchOk = bMSGKINEIS_STDV1_checkBCH32(ArgosMsgHandle);
+
+	return decoded->crcOk && decoded->bchOk;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Decode a batch of messages
+// -------------------------------------------------------------------------- //
+
+uint32_t u32MSGKINEIS_STDV1_decodeBatch(
+	const ArgosMsgTypeDef_t ArgosMsgHandles[],
+	uint32_t count,
+	ArgosDecodedMsgTypeDef_t decoded[])
+{
+	uint32_t valid = 0;
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+		if (bMSGKINEIS_STDV1_decode(&ArgosMsgHandles[i], &decoded[i]))
+			valid++;
+
+	return valid;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Decode a batch of messages from their hexadecimal text
+// -------------------------------------------------------------------------- //
+
+uint32_t u32MSGKINEIS_STDV1_decodeHexBatch(
+	const char *const hex[],
+	const uint16_t len[],
+	uint32_t count,
+	ArgosDecodedMsgTypeDef_t decoded[])
+{
+	ArgosMsgTypeDef_t msg;
+	uint32_t valid = 0;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		if (!bMSGKINEIS_STDV1_fromHex(hex[i], len[i], &msg)) {
+			memset(&decoded[i], 0, sizeof(decoded[i]));
+			continue;
+		}
+		if (bMSGKINEIS_STDV1_decode(&msg, &decoded[i]))
+			valid++;
+	}
+
+	return valid;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Check a message received in pieces
+// -------------------------------------------------------------------------- //
+
+void vMSGKINEIS_STDV1_initVerifier(
+	ArgosMsgVerifierTypeDef_t *verifier)
+{
+	vMSG_KINEIS_UTILS_initCrc16(&verifier->crc);
+	vMSG_KINEIS_UTILS_initBch32(&verifier->bch);
+	verifier->crcField = 0;
+	verifier->position = 0;
+}
+
+
+uint16_t u16MSGKINEIS_STDV1_updateVerifier(
+	ArgosMsgVerifierTypeDef_t *verifier,
+	const uint8_t *ptr,
+	uint16_t lengthBit)
+{
+	uint16_t crcEnd = POSITION_STD_CRC + CRC16_WIDTH;
+	uint16_t crcStart = CRC16_OFFSET_BYTE * 8;
+	uint16_t dataEnd = crcStart + CRC16_LENGTH_BIT;
+	uint16_t bytes;
+	uint16_t next;
+	uint8_t used = 0;
+	uint8_t length;
+	uint8_t bits;
+
+	if (lengthBit > ARGOS_FRAME_LENGTH_BIT - verifier->position)
+		lengthBit = ARGOS_FRAME_LENGTH_BIT - verifier->position;
+
+	while (lengthBit > 0) {
+		//!< Whole bytes covered by both checksums in one go
+		if (used == 0 && verifier->position >= crcEnd && verifier->position % 8 == 0 &&
+				lengthBit >= 8 && verifier->position + 8 <= dataEnd) {
+			bytes = (dataEnd - verifier->position) / 8;
+			if (bytes > lengthBit / 8)
+				bytes = lengthBit / 8;
+			vMSG_KINEIS_UTILS_updateCrc16(&verifier->crc, ptr, bytes * 8);
+			vMSG_KINEIS_UTILS_updateBch32(&verifier->bch, ptr, bytes * 8);
+			ptr += bytes;
+			verifier->position += bytes * 8;
+			lengthBit -= bytes * 8;
+			continue;
+		}
+
+		//!< Else up to the end of the byte or of the field
+		next = verifier->position < POSITION_STD_CRC ? POSITION_STD_CRC :
+			verifier->position < crcStart ? crcStart :
+			verifier->position < crcEnd ? crcEnd :
+			verifier->position < dataEnd ? dataEnd : ARGOS_FRAME_LENGTH_BIT;
+		length = 8 - used;
+		if (length > lengthBit)
+			length = (uint8_t)lengthBit;
+		if (length > next - verifier->position)
+			length = (uint8_t)(next - verifier->position);
+		bits = (uint8_t)(*ptr >> (8 - used - length)) & (0xff >> (8 - length));
+
+		vMSG_KINEIS_UTILS_updateBch32Bits(&verifier->bch, bits, length);
+		if (verifier->position >= POSITION_STD_CRC && verifier->position < crcEnd)
+			verifier->crcField = (uint16_t)((verifier->crcField << length) | bits);
+		//!< The CRC16 was computed while its own field was still cleared
+		if (verifier->position >= crcStart && verifier->position < dataEnd)
+			vMSG_KINEIS_UTILS_updateCrc16Bits(&verifier->crc,
+				verifier->position < crcEnd ? 0 : bits, length);
+
+		verifier->position += length;
+		lengthBit -= length;
+		used += length;
+		if (used == 8) {
+			used = 0;
+			ptr++;
+		}
+	}
+
+	return ARGOS_FRAME_LENGTH_BIT - verifier->position;
+}
+
+
+bool bMSGKINEIS_STDV1_finalVerifier(
+	const ArgosMsgVerifierTypeDef_t *verifier,
+	bool *crcOk,
+	bool *bchOk)
+{
+	bool complete = verifier->position == ARGOS_FRAME_LENGTH_BIT;
+	//!< The remainder of a message followed by its BCH32 is null
+	bool bch = complete && u32MSG_KINEIS_UTILS_finalBch32(&verifier->bch) == 0;
+	bool crc = complete && u16MSG_KINEIS_UTILS_finalCrc16(&verifier->crc) == verifier->crcField;
+
+	if (crcOk != NULL)
+		*crcOk = crc;
+	if (bchOk != NULL)
+		*bchOk = bch;
+
+	return crc && bch;
+}
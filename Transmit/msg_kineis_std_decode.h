@@ -0,0 +1,267 @@
+// -------------------------------------------------------------------------- //
+//! @file	msg_kineis_std_decode.h
+//! @brief	Kineis message MSGKINEIS_STDV1 decoding algorithms defines
+//!			Inverse of the msg_kineis_std setters for the "position and user
+//!			data" format, from a payload or from its hexadecimal text as
+//!			found in the RAW_DATA field of Kineis exports.
+// -------------------------------------------------------------------------- //
+
+#ifndef MSG_KINEIS_STD_DECODE_H
+
+#define MSG_KINEIS_STD_DECODE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Includes
+// -------------------------------------------------------------------------- //
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "msg_kineis_std.h"
+#include "msg_kineis_utils.h"
+
+#pragma GCC visibility push(default)
+
+// -------------------------------------------------------------------------- //
+// Defines values
+// -------------------------------------------------------------------------- //
+
+//!< Length of the 'user data' part kept by the BCH32 (bits)
+#define USER_DATA_BCH_LENGTH_BIT	(POSITION_STD_BCH32 - POSITION_STD_USER_DATA)
+
+
+// -------------------------------------------------------------------------- //
+//! Decoded "position and user data" message
+// -------------------------------------------------------------------------- //
+
+typedef struct ArgosDecodedMsgTypeDef_t {
+	uint8_t extId;
+	uint16_t crc;
+	enum PeriodAcqGPS_t acqPeriod;
+	uint8_t day;
+	uint8_t hour;
+	uint8_t min;
+	int32_t lon;		//!< Same unit as u16MSGKINEIS_STDV1_setLocation
+	int32_t lat;
+	int16_t alt;		//!< Metres, 10 m resolution
+	//! Bytes as given to u16MSGKINEIS_STDV1_setUserData. Only the first
+	//! USER_DATA_BCH_LENGTH_BIT bits are sent when a BCH32 is used.
+	uint8_t userData[USER_DATA_LENGTH];
+	uint32_t bch;
+	bool crcOk;			//!< CRC16 matches the payload
+	bool bchOk;			//!< BCH32 matches the payload
+} ArgosDecodedMsgTypeDef_t;
+
+
+// -------------------------------------------------------------------------- //
+//! Verification of a message received in pieces, see
+//! vMSGKINEIS_STDV1_initVerifier
+// -------------------------------------------------------------------------- //
+
+typedef struct ArgosMsgVerifierTypeDef_t {
+	MsgKineisCrc16CtxTypeDef_t crc;
+	MsgKineisBch32CtxTypeDef_t bch;
+	uint16_t crcField;	//!< CRC16 as received
+	uint16_t position;	//!< Bits received
+} ArgosMsgVerifierTypeDef_t;
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Get an uint32_t value at the wanted position in the payload
+//!
+//! \param[in] ArgosMsgHandle Argos message pointer
+//! \param[in] position Position in bit in the Argos message payload
+//! \param[in] length Length of the value in the payload (max 32)
+//!
+//! \return Value
+// -------------------------------------------------------------------------- //
+
+uint32_t
+u32MSGKINEIS_STDV1_getValue
+(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	uint16_t position,
+	uint16_t length
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Convert the hexadecimal text of a payload
+//!
+//! Shorter texts, as sent by some devices, leave the end of the payload
+//! cleared.
+//!
+//! \param[in] hex Hexadecimal characters, upper or lower case
+//! \param[in] len Number of characters (even, max ARGOS_FRAME_HEX_LENGTH)
+//! \param[out] ArgosMsgHandle Argos message
+//!
+//! \return false if the text is not a payload
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_STDV1_fromHex
+(
+	const char *hex,
+	uint16_t len,
+	ArgosMsgTypeDef_t *ArgosMsgHandle
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Check the CRC16 written by vMSGKINEIS_STDV1_setCRC16andBCH32
+//!
+//! \param[in] ArgosMsgHandle Argos message
+//!
+//! \return true if the CRC16 matches
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_STDV1_checkCRC16
+(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Check the BCH32 written by vMSGKINEIS_STDV1_setCRC16andBCH32
+//!
+//! \param[in] ArgosMsgHandle Argos message
+//!
+//! \return true if the BCH32 matches
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_STDV1_checkBCH32
+(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Decode a "position and user data" message
+//!
+//! \param[in] ArgosMsgHandle Argos message
+//! \param[out] decoded Decoded fields
+//!
+//! \return true if both CRC16 and BCH32 match
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_STDV1_decode
+(
+	const ArgosMsgTypeDef_t *ArgosMsgHandle,
+	ArgosDecodedMsgTypeDef_t *decoded
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Decode a batch of messages
+//!
+//! \param[in] ArgosMsgHandles Argos messages
+//! \param[in] count Number of messages
+//! \param[out] decoded Decoded fields, 'count' elements
+//!
+//! \return Number of messages with both CRC16 and BCH32 matching
+// -------------------------------------------------------------------------- //
+
+uint32_t
+u32MSGKINEIS_STDV1_decodeBatch
+(
+	const ArgosMsgTypeDef_t ArgosMsgHandles[],
+	uint32_t count,
+	ArgosDecodedMsgTypeDef_t decoded[]
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Decode a batch of messages from their hexadecimal text
+//!
+//! Texts which are not a payload decode with crcOk and bchOk cleared.
+//!
+//! \param[in] hex Hexadecimal text of each message, not NUL terminated
+//! \param[in] len Number of characters of each text
+//! \param[in] count Number of messages
+//! \param[out] decoded Decoded fields, 'count' elements
+//!
+//! \return Number of messages with both CRC16 and BCH32 matching
+// -------------------------------------------------------------------------- //
+
+uint32_t
+u32MSGKINEIS_STDV1_decodeHexBatch
+(
+	const char *const hex[],
+	const uint16_t len[],
+	uint32_t count,
+	ArgosDecodedMsgTypeDef_t decoded[]
+);
+
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Start checking the CRC16 and BCH32 of a message received in pieces
+//!
+//! The pieces are given in order to vMSGKINEIS_STDV1_updateVerifier, then
+//! bMSGKINEIS_STDV1_finalVerifier gives the same results as
+//! bMSGKINEIS_STDV1_checkCRC16 and bMSGKINEIS_STDV1_checkBCH32 without the
+//! message being gathered first.
+//!
+//! \param[out] verifier Verifier
+// -------------------------------------------------------------------------- //
+
+void
+vMSGKINEIS_STDV1_initVerifier
+(
+	ArgosMsgVerifierTypeDef_t *verifier
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Add the next bits of the message
+//!
+//! \param[in,out] verifier Verifier
+//! \param[in] ptr Bits from the MSB of the first byte
+//! \param[in] lengthBit Number of bits, those past the end of the message are
+//!		ignored
+//!
+//! \return Bits of the message still expected
+// -------------------------------------------------------------------------- //
+
+uint16_t
+u16MSGKINEIS_STDV1_updateVerifier
+(
+	ArgosMsgVerifierTypeDef_t *verifier,
+	const uint8_t *ptr,
+	uint16_t lengthBit
+);
+
+
+// -------------------------------------------------------------------------- //
+//! \brief Results of the checks, once the whole message was given
+//!
+//! \param[in] verifier Verifier
+//! \param[out] crcOk CRC16 matches, may be NULL
+//! \param[out] bchOk BCH32 matches, may be NULL
+//!
+//! \return true if the message is complete and both CRC16 and BCH32 match
+// -------------------------------------------------------------------------- //
+
+bool
+bMSGKINEIS_STDV1_finalVerifier
+(
+	const ArgosMsgVerifierTypeDef_t *verifier,
+	bool *crcOk,
+	bool *bchOk
+);
+
+#pragma GCC visibility pop
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // end MSG_KINEIS_STD_DECODE_H
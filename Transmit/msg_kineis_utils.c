@@ -12,8 +12,17 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdbool.h>
+#include <stddef.h>
 #include "msg_kineis_utils.h"
 
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)	(*(const uint32_t *)(addr))
+#endif
+
 /* Private define ------------------------------------------------------------*/
 #define REMAINDER32_WIDTH		32
 #define REMAINDER32_TOPBIT		(1UL << (REMAINDER32_WIDTH - 1))
@@ -21,6 +30,165 @@
 #define REMAINDER16_WIDTH		16
 #define REMAINDER16_TOPBIT		(1UL << (REMAINDER16_WIDTH - 1))
 
+#define TABLE_SIZE				256
+#define SLICE_COUNT				8
+
+#define SYNDROME_SLOT_BITS		16
+#define SYNDROME_SLOT_COUNT		(1UL << SYNDROME_SLOT_BITS)
+#define SYNDROME_HASH			0x9E3779B1UL
+#define SYNDROME_NO_ERROR		0xFF
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Each entry is the remainder of its index shifted through 8 steps of the polynomial. */
+
+const uint16_t au16MSG_KINEIS_UTILS_crc16Table[TABLE_SIZE] PROGMEM = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+const uint32_t au32MSG_KINEIS_UTILS_bch32Table[TABLE_SIZE] PROGMEM = {
+	0x00000000, 0xEE5B42FD, 0x32EDC707, 0xDCB685FA, 0x65DB8E0E, 0x8B80CCF3,
+	0x57364909, 0xB96D0BF4, 0xCBB71C1C, 0x25EC5EE1, 0xF95ADB1B, 0x170199E6,
+	0xAE6C9212, 0x4037D0EF, 0x9C815515, 0x72DA17E8, 0x79357AC5, 0x976E3838,
+	0x4BD8BDC2, 0xA583FF3F, 0x1CEEF4CB, 0xF2B5B636, 0x2E0333CC, 0xC0587131,
+	0xB28266D9, 0x5CD92424, 0x806FA1DE, 0x6E34E323, 0xD759E8D7, 0x3902AA2A,
+	0xE5B42FD0, 0x0BEF6D2D, 0xF26AF58A, 0x1C31B777, 0xC087328D, 0x2EDC7070,
+	0x97B17B84, 0x79EA3979, 0xA55CBC83, 0x4B07FE7E, 0x39DDE996, 0xD786AB6B,
+	0x0B302E91, 0xE56B6C6C, 0x5C066798, 0xB25D2565, 0x6EEBA09F, 0x80B0E262,
+	0x8B5F8F4F, 0x6504CDB2, 0xB9B24848, 0x57E90AB5, 0xEE840141, 0x00DF43BC,
+	0xDC69C646, 0x323284BB, 0x40E89353, 0xAEB3D1AE, 0x72055454, 0x9C5E16A9,
+	0x25331D5D, 0xCB685FA0, 0x17DEDA5A, 0xF98598A7, 0x0A8EA9E9, 0xE4D5EB14,
+	0x38636EEE, 0xD6382C13, 0x6F5527E7, 0x810E651A, 0x5DB8E0E0, 0xB3E3A21D,
+	0xC139B5F5, 0x2F62F708, 0xF3D472F2, 0x1D8F300F, 0xA4E23BFB, 0x4AB97906,
+	0x960FFCFC, 0x7854BE01, 0x73BBD32C, 0x9DE091D1, 0x4156142B, 0xAF0D56D6,
+	0x16605D22, 0xF83B1FDF, 0x248D9A25, 0xCAD6D8D8, 0xB80CCF30, 0x56578DCD,
+	0x8AE10837, 0x64BA4ACA, 0xDDD7413E, 0x338C03C3, 0xEF3A8639, 0x0161C4C4,
+	0xF8E45C63, 0x16BF1E9E, 0xCA099B64, 0x2452D999, 0x9D3FD26D, 0x73649090,
+	0xAFD2156A, 0x41895797, 0x3353407F, 0xDD080282, 0x01BE8778, 0xEFE5C585,
+	0x5688CE71, 0xB8D38C8C, 0x64650976, 0x8A3E4B8B, 0x81D126A6, 0x6F8A645B,
+	0xB33CE1A1, 0x5D67A35C, 0xE40AA8A8, 0x0A51EA55, 0xD6E76FAF, 0x38BC2D52,
+	0x4A663ABA, 0xA43D7847, 0x788BFDBD, 0x96D0BF40, 0x2FBDB4B4, 0xC1E6F649,
+	0x1D5073B3, 0xF30B314E, 0x151D53D2, 0xFB46112F, 0x27F094D5, 0xC9ABD628,
+	0x70C6DDDC, 0x9E9D9F21, 0x422B1ADB, 0xAC705826, 0xDEAA4FCE, 0x30F10D33,
+	0xEC4788C9, 0x021CCA34, 0xBB71C1C0, 0x552A833D, 0x899C06C7, 0x67C7443A,
+	0x6C282917, 0x82736BEA, 0x5EC5EE10, 0xB09EACED, 0x09F3A719, 0xE7A8E5E4,
+	0x3B1E601E, 0xD54522E3, 0xA79F350B, 0x49C477F6, 0x9572F20C, 0x7B29B0F1,
+	0xC244BB05, 0x2C1FF9F8, 0xF0A97C02, 0x1EF23EFF, 0xE777A658, 0x092CE4A5,
+	0xD59A615F, 0x3BC123A2, 0x82AC2856, 0x6CF76AAB, 0xB041EF51, 0x5E1AADAC,
+	0x2CC0BA44, 0xC29BF8B9, 0x1E2D7D43, 0xF0763FBE, 0x491B344A, 0xA74076B7,
+	0x7BF6F34D, 0x95ADB1B0, 0x9E42DC9D, 0x70199E60, 0xACAF1B9A, 0x42F45967,
+	0xFB995293, 0x15C2106E, 0xC9749594, 0x272FD769, 0x55F5C081, 0xBBAE827C,
+	0x67180786, 0x8943457B, 0x302E4E8F, 0xDE750C72, 0x02C38988, 0xEC98CB75,
+	0x1F93FA3B, 0xF1C8B8C6, 0x2D7E3D3C, 0xC3257FC1, 0x7A487435, 0x941336C8,
+	0x48A5B332, 0xA6FEF1CF, 0xD424E627, 0x3A7FA4DA, 0xE6C92120, 0x089263DD,
+	0xB1FF6829, 0x5FA42AD4, 0x8312AF2E, 0x6D49EDD3, 0x66A680FE, 0x88FDC203,
+	0x544B47F9, 0xBA100504, 0x037D0EF0, 0xED264C0D, 0x3190C9F7, 0xDFCB8B0A,
+	0xAD119CE2, 0x434ADE1F, 0x9FFC5BE5, 0x71A71918, 0xC8CA12EC, 0x26915011,
+	0xFA27D5EB, 0x147C9716, 0xEDF90FB1, 0x03A24D4C, 0xDF14C8B6, 0x314F8A4B,
+	0x882281BF, 0x6679C342, 0xBACF46B8, 0x54940445, 0x264E13AD, 0xC8155150,
+	0x14A3D4AA, 0xFAF89657, 0x43959DA3, 0xADCEDF5E, 0x71785AA4, 0x9F231859,
+	0x94CC7574, 0x7A973789, 0xA621B273, 0x487AF08E, 0xF117FB7A, 0x1F4CB987,
+	0xC3FA3C7D, 0x2DA17E80, 0x5F7B6968, 0xB1202B95, 0x6D96AE6F, 0x83CDEC92,
+	0x3AA0E766, 0xD4FBA59B, 0x084D2061, 0xE616629C
+};
+
+const uint32_t au32MSG_KINEIS_UTILS_fcs32Table[TABLE_SIZE] PROGMEM = {
+	0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9, 0x130476DC, 0x17C56B6B,
+	0x1A864DB2, 0x1E475005, 0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61,
+	0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD, 0x4C11DB70, 0x48D0C6C7,
+	0x4593E01E, 0x4152FDA9, 0x5F15ADAC, 0x5BD4B01B, 0x569796C2, 0x52568B75,
+	0x6A1936C8, 0x6ED82B7F, 0x639B0DA6, 0x675A1011, 0x791D4014, 0x7DDC5DA3,
+	0x709F7B7A, 0x745E66CD, 0x9823B6E0, 0x9CE2AB57, 0x91A18D8E, 0x95609039,
+	0x8B27C03C, 0x8FE6DD8B, 0x82A5FB52, 0x8664E6E5, 0xBE2B5B58, 0xBAEA46EF,
+	0xB7A96036, 0xB3687D81, 0xAD2F2D84, 0xA9EE3033, 0xA4AD16EA, 0xA06C0B5D,
+	0xD4326D90, 0xD0F37027, 0xDDB056FE, 0xD9714B49, 0xC7361B4C, 0xC3F706FB,
+	0xCEB42022, 0xCA753D95, 0xF23A8028, 0xF6FB9D9F, 0xFBB8BB46, 0xFF79A6F1,
+	0xE13EF6F4, 0xE5FFEB43, 0xE8BCCD9A, 0xEC7DD02D, 0x34867077, 0x30476DC0,
+	0x3D044B19, 0x39C556AE, 0x278206AB, 0x23431B1C, 0x2E003DC5, 0x2AC12072,
+	0x128E9DCF, 0x164F8078, 0x1B0CA6A1, 0x1FCDBB16, 0x018AEB13, 0x054BF6A4,
+	0x0808D07D, 0x0CC9CDCA, 0x7897AB07, 0x7C56B6B0, 0x71159069, 0x75D48DDE,
+	0x6B93DDDB, 0x6F52C06C, 0x6211E6B5, 0x66D0FB02, 0x5E9F46BF, 0x5A5E5B08,
+	0x571D7DD1, 0x53DC6066, 0x4D9B3063, 0x495A2DD4, 0x44190B0D, 0x40D816BA,
+	0xACA5C697, 0xA864DB20, 0xA527FDF9, 0xA1E6E04E, 0xBFA1B04B, 0xBB60ADFC,
+	0xB6238B25, 0xB2E29692, 0x8AAD2B2F, 0x8E6C3698, 0x832F1041, 0x87EE0DF6,
+	0x99A95DF3, 0x9D684044, 0x902B669D, 0x94EA7B2A, 0xE0B41DE7, 0xE4750050,
+	0xE9362689, 0xEDF73B3E, 0xF3B06B3B, 0xF771768C, 0xFA325055, 0xFEF34DE2,
+	0xC6BCF05F, 0xC27DEDE8, 0xCF3ECB31, 0xCBFFD686, 0xD5B88683, 0xD1799B34,
+	0xDC3ABDED, 0xD8FBA05A, 0x690CE0EE, 0x6DCDFD59, 0x608EDB80, 0x644FC637,
+	0x7A089632, 0x7EC98B85, 0x738AAD5C, 0x774BB0EB, 0x4F040D56, 0x4BC510E1,
+	0x46863638, 0x42472B8F, 0x5C007B8A, 0x58C1663D, 0x558240E4, 0x51435D53,
+	0x251D3B9E, 0x21DC2629, 0x2C9F00F0, 0x285E1D47, 0x36194D42, 0x32D850F5,
+	0x3F9B762C, 0x3B5A6B9B, 0x0315D626, 0x07D4CB91, 0x0A97ED48, 0x0E56F0FF,
+	0x1011A0FA, 0x14D0BD4D, 0x19939B94, 0x1D528623, 0xF12F560E, 0xF5EE4BB9,
+	0xF8AD6D60, 0xFC6C70D7, 0xE22B20D2, 0xE6EA3D65, 0xEBA91BBC, 0xEF68060B,
+	0xD727BBB6, 0xD3E6A601, 0xDEA580D8, 0xDA649D6F, 0xC423CD6A, 0xC0E2D0DD,
+	0xCDA1F604, 0xC960EBB3, 0xBD3E8D7E, 0xB9FF90C9, 0xB4BCB610, 0xB07DABA7,
+	0xAE3AFBA2, 0xAAFBE615, 0xA7B8C0CC, 0xA379DD7B, 0x9B3660C6, 0x9FF77D71,
+	0x92B45BA8, 0x9675461F, 0x8832161A, 0x8CF30BAD, 0x81B02D74, 0x857130C3,
+	0x5D8A9099, 0x594B8D2E, 0x5408ABF7, 0x50C9B640, 0x4E8EE645, 0x4A4FFBF2,
+	0x470CDD2B, 0x43CDC09C, 0x7B827D21, 0x7F436096, 0x7200464F, 0x76C15BF8,
+	0x68860BFD, 0x6C47164A, 0x61043093, 0x65C52D24, 0x119B4BE9, 0x155A565E,
+	0x18197087, 0x1CD86D30, 0x029F3D35, 0x065E2082, 0x0B1D065B, 0x0FDC1BEC,
+	0x3793A651, 0x3352BBE6, 0x3E119D3F, 0x3AD08088, 0x2497D08D, 0x2056CD3A,
+	0x2D15EBE3, 0x29D4F654, 0xC5A92679, 0xC1683BCE, 0xCC2B1D17, 0xC8EA00A0,
+	0xD6AD50A5, 0xD26C4D12, 0xDF2F6BCB, 0xDBEE767C, 0xE3A1CBC1, 0xE760D676,
+	0xEA23F0AF, 0xEEE2ED18, 0xF0A5BD1D, 0xF464A0AA, 0xF9278673, 0xFDE69BC4,
+	0x89B8FD09, 0x8D79E0BE, 0x803AC667, 0x84FBDBD0, 0x9ABC8BD5, 0x9E7D9662,
+	0x933EB0BB, 0x97FFAD0C, 0xAFB010B1, 0xAB710D06, 0xA6322BDF, 0xA2F33668,
+	0xBCB4666D, 0xB8757BDA, 0xB5365D03, 0xB1F740B4
+};
+
+/* Private variables ---------------------------------------------------------*/
+
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+/* Slice k holds the remainder of a byte followed by k zero bytes. Slice 0 is the byte table. */
+static uint16_t au16Crc16Slice8[SLICE_COUNT][TABLE_SIZE];
+static uint32_t au32Bch32Slice8[SLICE_COUNT][TABLE_SIZE];
+static uint32_t au32Fcs32Slice8[SLICE_COUNT][TABLE_SIZE];
+static bool bSlice8Ready = false;
+#endif
+
+#if MSG_KINEIS_UTILS_BCH32_CORRECT
+/*
+ * Open addressing hash of the syndromes of all 1 and 2 bit errors (30876 entries for 248 bits).
+ * An error is stored as its distance from the end of the codeword, so one lookup serves every
+ * length. A null syndrome marks an empty slot since no correctable error gives one.
+ */
+static uint32_t au32Bch32Syndrome[SYNDROME_SLOT_COUNT];
+static uint16_t au16Bch32Errors[SYNDROME_SLOT_COUNT];
+static bool bBch32CorrectReady = false;
+#endif
 
 /* Functions -----------------------------------------------------------------*/
 
@@ -100,6 +268,497 @@ uint16_t u16MSG_KINEIS_UTILS_calcCrcBch16(
 	return remainder;
 }
 
+/*
+ * The bit-wise functions above consume a length which is not a multiple of 8 as if it was
+ * prefixed with (8 - lengthBit % 8) zero bits: the first step takes the top bits of the first
+ * byte, every following step takes a byte window straddling two source bytes. Leading zeros do
+ * not change a CRC with a null initial remainder, so the table engines below feed exactly the
+ * same byte windows.
+ */
+
+uint32_t u32MSG_KINEIS_UTILS_calcCrcBch32Table(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint32_t *table)
+{
+	uint32_t remainder = 0;
+	uint8_t leftShift;
+	uint8_t rightShift;
+	uint8_t window;
+
+	if (lengthBit <= 0)
+		return 0;
+
+	leftShift = lengthBit % 8;
+
+	if (leftShift == 0) {
+		for (; lengthBit > 0; lengthBit -= 8, ptr++)
+			remainder = (remainder << 8) ^
+				pgm_read_dword(&table[(uint8_t)(remainder >> 24) ^ *ptr]);
+		return remainder;
+	}
+
+	rightShift = 8 - leftShift;
+
+	//!< First window: the remainder is still null
+	remainder = pgm_read_dword(&table[*ptr >> rightShift]);
+
+	for (lengthBit -= leftShift; lengthBit > 0; lengthBit -= 8, ptr++) {
+		window = (uint8_t)((ptr[0] << leftShift) | (ptr[1] >> rightShift));
+		remainder = (remainder << 8) ^
+			pgm_read_dword(&table[(uint8_t)(remainder >> 24) ^ window]);
+	}
+	return remainder;
+}
+
+uint16_t u16MSG_KINEIS_UTILS_calcCrcBch16Table(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint16_t *table)
+{
+	uint16_t remainder = 0;
+	uint8_t leftShift;
+	uint8_t rightShift;
+	uint8_t window;
+
+	if (lengthBit <= 0)
+		return 0;
+
+	leftShift = lengthBit % 8;
+
+	if (leftShift == 0) {
+		for (; lengthBit > 0; lengthBit -= 8, ptr++)
+			remainder = (uint16_t)(remainder << 8) ^
+				pgm_read_word(&table[(uint8_t)(remainder >> 8) ^ *ptr]);
+		return remainder;
+	}
+
+	rightShift = 8 - leftShift;
+
+	//!< First window: the remainder is still null
+	remainder = pgm_read_word(&table[*ptr >> rightShift]);
+
+	for (lengthBit -= leftShift; lengthBit > 0; lengthBit -= 8, ptr++) {
+		window = (uint8_t)((ptr[0] << leftShift) | (ptr[1] >> rightShift));
+		remainder = (uint16_t)(remainder << 8) ^
+			pgm_read_word(&table[(uint8_t)(remainder >> 8) ^ window]);
+	}
+	return remainder;
+}
+
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+
+static void vBuildSlice32(uint32_t slices[SLICE_COUNT][TABLE_SIZE], const uint32_t *table)
+{
+	uint16_t i;
+	uint8_t k;
+
+	for (i = 0; i < TABLE_SIZE; i++)
+		slices[0][i] = table[i];
+
+	for (k = 1; k < SLICE_COUNT; k++)
+		for (i = 0; i < TABLE_SIZE; i++)
+			slices[k][i] = (slices[k - 1][i] << 8) ^ table[slices[k - 1][i] >> 24];
+}
+
+static void vBuildSlice16(uint16_t slices[SLICE_COUNT][TABLE_SIZE], const uint16_t *table)
+{
+	uint16_t i;
+	uint8_t k;
+
+	for (i = 0; i < TABLE_SIZE; i++)
+		slices[0][i] = table[i];
+
+	for (k = 1; k < SLICE_COUNT; k++)
+		for (i = 0; i < TABLE_SIZE; i++)
+			slices[k][i] = (uint16_t)(slices[k - 1][i] << 8) ^ table[slices[k - 1][i] >> 8];
+}
+
+void vMSG_KINEIS_UTILS_initSlice8(void)
+{
+	if (bSlice8Ready)
+		return;
+
+	vBuildSlice16(au16Crc16Slice8, au16MSG_KINEIS_UTILS_crc16Table);
+	vBuildSlice32(au32Bch32Slice8, au32MSG_KINEIS_UTILS_bch32Table);
+	vBuildSlice32(au32Fcs32Slice8, au32MSG_KINEIS_UTILS_fcs32Table);
+	bSlice8Ready = true;
+}
+
+/*
+ * Return the next 8 byte windows. For aligned lengths the windows are the source bytes and are
+ * used in place.
+ */
+static inline const uint8_t *pu8Windows8(
+		const uint8_t *ptr,
+		uint8_t leftShift,
+		uint8_t buf[SLICE_COUNT])
+{
+	uint8_t i;
+
+	if (leftShift == 0)
+		return ptr;
+
+	for (i = 0; i < SLICE_COUNT; i++)
+		buf[i] = (uint8_t)((ptr[i] << leftShift) | (ptr[i + 1] >> (8 - leftShift)));
+	return buf;
+}
+
+uint32_t u32MSG_KINEIS_UTILS_calcCrcBch32Slice8(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint32_t *table)
+{
+	uint32_t (*slices)[TABLE_SIZE];
+	uint32_t remainder = 0;
+	uint32_t word;
+	uint8_t leftShift;
+	uint8_t window;
+	uint8_t buf[SLICE_COUNT];
+	const uint8_t *w;
+
+	if (table == au32MSG_KINEIS_UTILS_bch32Table)
+		slices = au32Bch32Slice8;
+	else if (table == au32MSG_KINEIS_UTILS_fcs32Table)
+		slices = au32Fcs32Slice8;
+	else
+		return u32MSG_KINEIS_UTILS_calcCrcBch32Table(ptr, lengthBit, table);
+
+	if (lengthBit <= 0)
+		return 0;
+
+	vMSG_KINEIS_UTILS_initSlice8();
+
+	leftShift = lengthBit % 8;
+	if (leftShift != 0) {
+		//!< First window: the remainder is still null
+		remainder = table[*ptr >> (8 - leftShift)];
+		lengthBit -= leftShift;
+	}
+
+	while (lengthBit >= 8 * SLICE_COUNT) {
+		w = pu8Windows8(ptr, leftShift, buf);
+		word = remainder ^ (((uint32_t)w[0] << 24) | ((uint32_t)w[1] << 16) |
+			((uint32_t)w[2] << 8) | w[3]);
+		remainder = slices[7][word >> 24] ^ slices[6][(word >> 16) & 0xff] ^
+			slices[5][(word >> 8) & 0xff] ^ slices[4][word & 0xff] ^
+			slices[3][w[4]] ^ slices[2][w[5]] ^ slices[1][w[6]] ^ slices[0][w[7]];
+		ptr += SLICE_COUNT;
+		lengthBit -= 8 * SLICE_COUNT;
+	}
+
+	for (; lengthBit > 0; lengthBit -= 8, ptr++) {
+		window = leftShift == 0 ? *ptr :
+			(uint8_t)((ptr[0] << leftShift) | (ptr[1] >> (8 - leftShift)));
+		remainder = (remainder << 8) ^ table[(uint8_t)(remainder >> 24) ^ window];
+	}
+	return remainder;
+}
+
+uint16_t u16MSG_KINEIS_UTILS_calcCrcBch16Slice8(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint16_t *table)
+{
+	uint16_t (*slices)[TABLE_SIZE] = au16Crc16Slice8;
+	uint16_t remainder = 0;
+	uint16_t word;
+	uint8_t leftShift;
+	uint8_t window;
+	uint8_t buf[SLICE_COUNT];
+	const uint8_t *w;
+
+	if (table != au16MSG_KINEIS_UTILS_crc16Table)
+		return u16MSG_KINEIS_UTILS_calcCrcBch16Table(ptr, lengthBit, table);
+
+	if (lengthBit <= 0)
+		return 0;
+
+	vMSG_KINEIS_UTILS_initSlice8();
+
+	leftShift = lengthBit % 8;
+	if (leftShift != 0) {
+		//!< First window: the remainder is still null
+		remainder = table[*ptr >> (8 - leftShift)];
+		lengthBit -= leftShift;
+	}
+
+	while (lengthBit >= 8 * SLICE_COUNT) {
+		w = pu8Windows8(ptr, leftShift, buf);
+		word = remainder ^ (uint16_t)((w[0] << 8) | w[1]);
+		remainder = slices[7][word >> 8] ^ slices[6][word & 0xff] ^
+			slices[5][w[2]] ^ slices[4][w[3]] ^ slices[3][w[4]] ^
+			slices[2][w[5]] ^ slices[1][w[6]] ^ slices[0][w[7]];
+		ptr += SLICE_COUNT;
+		lengthBit -= 8 * SLICE_COUNT;
+	}
+
+	for (; lengthBit > 0; lengthBit -= 8, ptr++) {
+		window = leftShift == 0 ? *ptr :
+			(uint8_t)((ptr[0] << leftShift) | (ptr[1] >> (8 - leftShift)));
+		remainder = (uint16_t)(remainder << 8) ^ table[(uint8_t)(remainder >> 8) ^ window];
+	}
+	return remainder;
+}
+
+#endif /* MSG_KINEIS_UTILS_SLICE_BY_8 */
+
+/**
+ * Add 1 to 8 bits to a remainder. The byte-wise table entry of a value below 256 is the
+ * remainder of the value shifted by the width of the CRC, so it holds for fewer bits as well.
+ */
+static inline uint16_t u16Crc16Step(uint16_t remainder, uint8_t bits, uint8_t lengthBit)
+{
+	return (uint16_t)(remainder << lengthBit) ^
+		pgm_read_word(&au16MSG_KINEIS_UTILS_crc16Table[(uint8_t)(remainder >> (16 - lengthBit)) ^ bits]);
+}
+
+static inline uint32_t u32Bch32Step(uint32_t remainder, uint8_t bits, uint8_t lengthBit)
+{
+	return (remainder << lengthBit) ^
+		pgm_read_dword(&au32MSG_KINEIS_UTILS_bch32Table[(uint8_t)(remainder >> (32 - lengthBit)) ^ bits]);
+}
+
+void vMSG_KINEIS_UTILS_initCrc16(MsgKineisCrc16CtxTypeDef_t *ctx)
+{
+	ctx->remainder = 0;
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	vMSG_KINEIS_UTILS_initSlice8();
+#endif
+}
+
+void vMSG_KINEIS_UTILS_updateCrc16(
+		MsgKineisCrc16CtxTypeDef_t *ctx,
+		const uint8_t *ptr,
+		int16_t lengthBit)
+{
+	uint16_t remainder = ctx->remainder;
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	uint16_t (*slices)[TABLE_SIZE] = au16Crc16Slice8;
+	uint16_t word;
+
+	for (; lengthBit >= 8 * SLICE_COUNT; lengthBit -= 8 * SLICE_COUNT, ptr += SLICE_COUNT) {
+		word = remainder ^ (uint16_t)((ptr[0] << 8) | ptr[1]);
+		remainder = slices[7][word >> 8] ^ slices[6][word & 0xff] ^
+			slices[5][ptr[2]] ^ slices[4][ptr[3]] ^ slices[3][ptr[4]] ^
+			slices[2][ptr[5]] ^ slices[1][ptr[6]] ^ slices[0][ptr[7]];
+	}
+#endif
+
+	for (; lengthBit >= 8; lengthBit -= 8, ptr++)
+		remainder = u16Crc16Step(remainder, *ptr, 8);
+	if (lengthBit > 0)
+		remainder = u16Crc16Step(remainder, *ptr >> (8 - lengthBit), (uint8_t)lengthBit);
+	ctx->remainder = remainder;
+}
+
+void vMSG_KINEIS_UTILS_updateCrc16Bits(
+		MsgKineisCrc16CtxTypeDef_t *ctx,
+		uint32_t value,
+		uint8_t lengthBit)
+{
+	uint16_t remainder = ctx->remainder;
+
+	while (lengthBit > 8) {
+		lengthBit -= 8;
+		remainder = u16Crc16Step(remainder, (uint8_t)(value >> lengthBit), 8);
+	}
+	if (lengthBit > 0)
+		remainder = u16Crc16Step(remainder, (uint8_t)(value & (0xff >> (8 - lengthBit))), lengthBit);
+	ctx->remainder = remainder;
+}
+
+uint16_t u16MSG_KINEIS_UTILS_finalCrc16(const MsgKineisCrc16CtxTypeDef_t *ctx)
+{
+	return ctx->remainder;
+}
+
+void vMSG_KINEIS_UTILS_initBch32(MsgKineisBch32CtxTypeDef_t *ctx)
+{
+	ctx->remainder = 0;
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	vMSG_KINEIS_UTILS_initSlice8();
+#endif
+}
+
+void vMSG_KINEIS_UTILS_updateBch32(
+		MsgKineisBch32CtxTypeDef_t *ctx,
+		const uint8_t *ptr,
+		int16_t lengthBit)
+{
+	uint32_t remainder = ctx->remainder;
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	uint32_t (*slices)[TABLE_SIZE] = au32Bch32Slice8;
+	uint32_t word;
+
+	for (; lengthBit >= 8 * SLICE_COUNT; lengthBit -= 8 * SLICE_COUNT, ptr += SLICE_COUNT) {
+		word = remainder ^ (((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) |
+			((uint32_t)ptr[2] << 8) | ptr[3]);
+		remainder = slices[7][word >> 24] ^ slices[6][(word >> 16) & 0xff] ^
+			slices[5][(word >> 8) & 0xff] ^ slices[4][word & 0xff] ^
+			slices[3][ptr[4]] ^ slices[2][ptr[5]] ^ slices[1][ptr[6]] ^ slices[0][ptr[7]];
+	}
+#endif
+
+	for (; lengthBit >= 8; lengthBit -= 8, ptr++)
+		remainder = u32Bch32Step(remainder, *ptr, 8);
+	if (lengthBit > 0)
+		remainder = u32Bch32Step(remainder, *ptr >> (8 - lengthBit), (uint8_t)lengthBit);
+	ctx->remainder = remainder;
+}
+
+void vMSG_KINEIS_UTILS_updateBch32Bits(
+		MsgKineisBch32CtxTypeDef_t *ctx,
+		uint32_t value,
+		uint8_t lengthBit)
+{
+	uint32_t remainder = ctx->remainder;
+
+	while (lengthBit > 8) {
+		lengthBit -= 8;
+		remainder = u32Bch32Step(remainder, (uint8_t)(value >> lengthBit), 8);
+	}
+	if (lengthBit > 0)
+		remainder = u32Bch32Step(remainder, (uint8_t)(value & (0xff >> (8 - lengthBit))), lengthBit);
+	ctx->remainder = remainder;
+}
+
+uint32_t u32MSG_KINEIS_UTILS_finalBch32(const MsgKineisBch32CtxTypeDef_t *ctx)
+{
+	return ctx->remainder;
+}
+
+#if MSG_KINEIS_UTILS_BCH32_CORRECT
+
+static inline uint32_t u32SyndromeSlot(uint32_t syndrome)
+{
+	return (uint32_t)(syndrome * SYNDROME_HASH) >> (REMAINDER32_WIDTH - SYNDROME_SLOT_BITS);
+}
+
+static void vInsertSyndrome(uint32_t syndrome, uint8_t distance1, uint8_t distance2)
+{
+	uint32_t slot = u32SyndromeSlot(syndrome);
+
+	while (au32Bch32Syndrome[slot] != 0)
+		slot = (slot + 1) & (SYNDROME_SLOT_COUNT - 1);
+
+	au32Bch32Syndrome[slot] = syndrome;
+	au16Bch32Errors[slot] = (uint16_t)(distance1 | (distance2 << 8));
+}
+
+void vMSG_KINEIS_UTILS_initBch32Correct(void)
+{
+	uint32_t syndromes[BCH32_CORRECT_MAX_LENGTH_BIT];
+	uint32_t remainder = BCH32_POLYNOMIAL;
+	uint8_t i;
+	uint8_t j;
+
+	if (bBch32CorrectReady)
+		return;
+
+	/* The syndrome of the last bit is x^32 mod P, each bit before it is one more step */
+	for (i = 0; i < BCH32_CORRECT_MAX_LENGTH_BIT; i++) {
+		syndromes[i] = remainder;
+		if (remainder & REMAINDER32_TOPBIT)
+			remainder = (remainder << 1) ^ BCH32_POLYNOMIAL;
+		else
+			remainder = (remainder << 1);
+	}
+
+	for (i = 0; i < BCH32_CORRECT_MAX_LENGTH_BIT; i++) {
+		vInsertSyndrome(syndromes[i], i, SYNDROME_NO_ERROR);
+		for (j = i + 1; j < BCH32_CORRECT_MAX_LENGTH_BIT; j++)
+			vInsertSyndrome(syndromes[i] ^ syndromes[j], i, j);
+	}
+	bBch32CorrectReady = true;
+}
+
+int8_t s8MSG_KINEIS_UTILS_correctBch32(
+		uint8_t *ptr,
+		int16_t lengthBit,
+		int16_t errorBit[2])
+{
+	uint32_t syndrome;
+	uint32_t slot;
+	int16_t position[2] = { -1, -1 };
+	uint8_t distance;
+	uint8_t i;
+
+	if (errorBit != NULL) {
+		errorBit[0] = -1;
+		errorBit[1] = -1;
+	}
+
+	if (lengthBit <= REMAINDER32_WIDTH || lengthBit > BCH32_CORRECT_MAX_LENGTH_BIT)
+		return BCH32_STATUS_UNCORRECTABLE;
+
+	syndrome = u32MSG_KINEIS_UTILS_calcBch32Fast(ptr, lengthBit);
+	if (syndrome == 0)
+		return BCH32_STATUS_OK;
+
+	vMSG_KINEIS_UTILS_initBch32Correct();
+
+	slot = u32SyndromeSlot(syndrome);
+	while (au32Bch32Syndrome[slot] != syndrome) {
+		if (au32Bch32Syndrome[slot] == 0)
+			return BCH32_STATUS_UNCORRECTABLE;
+		slot = (slot + 1) & (SYNDROME_SLOT_COUNT - 1);
+	}
+
+	/* Errors found past the start of a shorter codeword cannot be the right ones */
+	for (i = 0; i < 2; i++) {
+		distance = (uint8_t)(au16Bch32Errors[slot] >> (8 * i));
+		if (distance == SYNDROME_NO_ERROR)
+			break;
+		if (distance >= lengthBit)
+			return BCH32_STATUS_UNCORRECTABLE;
+		position[i] = lengthBit - 1 - distance;
+	}
+
+	for (i = 0; i < 2 && position[i] >= 0; i++) {
+		ptr[position[i] >> 3] ^= (uint8_t)(0x80 >> (position[i] & 0x7));
+		if (errorBit != NULL)
+			errorBit[i] = position[i];
+	}
+
+	return (int8_t)i;
+}
+
+#endif /* MSG_KINEIS_UTILS_BCH32_CORRECT */
+
+uint32_t u32MSG_KINEIS_UTILS_calcBch32Fast(const uint8_t *ptr, int16_t lengthBit)
+{
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	return u32MSG_KINEIS_UTILS_calcCrcBch32Slice8(ptr, lengthBit,
+		au32MSG_KINEIS_UTILS_bch32Table);
+#else
+	return u32MSG_KINEIS_UTILS_calcCrcBch32Table(ptr, lengthBit,
+		au32MSG_KINEIS_UTILS_bch32Table);
+#endif
+}
+
+uint32_t u32MSG_KINEIS_UTILS_calcFcs32Fast(const uint8_t *ptr, int16_t lengthBit)
+{
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	return u32MSG_KINEIS_UTILS_calcCrcBch32Slice8(ptr, lengthBit,
+		au32MSG_KINEIS_UTILS_fcs32Table);
+#else
+	return u32MSG_KINEIS_UTILS_calcCrcBch32Table(ptr, lengthBit,
+		au32MSG_KINEIS_UTILS_fcs32Table);
+#endif
+}
+
+uint16_t u16MSG_KINEIS_UTILS_calcCrc16Fast(const uint8_t *ptr, int16_t lengthBit)
+{
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+	return u16MSG_KINEIS_UTILS_calcCrcBch16Slice8(ptr, lengthBit,
+		au16MSG_KINEIS_UTILS_crc16Table);
+#else
+	return u16MSG_KINEIS_UTILS_calcCrcBch16Table(ptr, lengthBit,
+		au16MSG_KINEIS_UTILS_crc16Table);
+#endif
+}
+
 /**
  * @}
  */
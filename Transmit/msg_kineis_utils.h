@@ -36,6 +36,61 @@
  *	the calculation. See https://barrgroup.com/embedded-systems/how-to/crc-calculation-c-code
  */
 
+/** Table-driven engine selection :
+ *	- MCU builds (ARDUINO defined) use one 256-entry table per polynomial, kept in flash.
+ *	- Host builds also use slicing-by-8 (8 x 256 entries per polynomial, built in RAM on first
+ *	  use) which consumes 8 bytes per step. Define MSG_KINEIS_UTILS_SLICE_BY_8 to 0 or 1 to
+ *	  override.
+ */
+#ifndef MSG_KINEIS_UTILS_SLICE_BY_8
+#ifdef ARDUINO
+#define MSG_KINEIS_UTILS_SLICE_BY_8	0
+#else
+#define MSG_KINEIS_UTILS_SLICE_BY_8	1
+#endif
+#endif
+
+/** BCH32 error correction (syndrome lookup of all 1 and 2 bit errors, ~384 KB of RAM built on
+ *	first use) is only compiled in host builds. Define MSG_KINEIS_UTILS_BCH32_CORRECT to 0 or 1
+ *	to override.
+ */
+#ifndef MSG_KINEIS_UTILS_BCH32_CORRECT
+#ifdef ARDUINO
+#define MSG_KINEIS_UTILS_BCH32_CORRECT	0
+#else
+#define MSG_KINEIS_UTILS_BCH32_CORRECT	1
+#endif
+#endif
+
+/** Longest codeword, BCH32 included, handled by the error correction (bit) */
+#define BCH32_CORRECT_MAX_LENGTH_BIT	248
+
+/** Status returned by s8MSG_KINEIS_UTILS_correctBch32, same values as the BCH_STATUS field of
+ *	the Kineis exports */
+#define BCH32_STATUS_OK				0
+#define BCH32_STATUS_CORRECTED_1	1
+#define BCH32_STATUS_CORRECTED_2	2
+#define BCH32_STATUS_UNCORRECTABLE	-1
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Incremental CRC16 calculation, for data written or received in pieces */
+typedef struct {
+	uint16_t remainder;
+} MsgKineisCrc16CtxTypeDef_t;
+
+/** Incremental BCH32 calculation, for data written or received in pieces */
+typedef struct {
+	uint32_t remainder;
+} MsgKineisBch32CtxTypeDef_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+/** Byte-wise lookup tables (in program memory on AVR) */
+extern const uint16_t au16MSG_KINEIS_UTILS_crc16Table[256];
+extern const uint32_t au32MSG_KINEIS_UTILS_bch32Table[256];
+extern const uint32_t au32MSG_KINEIS_UTILS_fcs32Table[256];
+
 /* Exported functions prototypes ---------------------------------------------*/
 
 /**
@@ -53,7 +108,7 @@
  * @return BCH32 value
  */
 #define u32MSG_KINEIS_UTILS_calcBCH32(ptr, lengthBit) \
-			u32MSG_KINEIS_UTILS_calcCrcBch32(ptr, lengthBit, (uint32_t)BCH32_POLYNOMIAL)
+			u32MSG_KINEIS_UTILS_calcBch32Fast(ptr, lengthBit)
 
 /**
  * @brief Calculate the FCS32
@@ -70,7 +125,7 @@
  * @return FCS32 value
  */
 #define u32MSG_KINEIS_UTILS_calcFCS32(ptr, lengthBit) \
-			u32MSG_KINEIS_UTILS_calcCrcBch32(ptr, lengthBit, (uint32_t)FCS32_POLYNOMIAL)
+			u32MSG_KINEIS_UTILS_calcFcs32Fast(ptr, lengthBit)
 
 /**
  * @brief Calculate the CRC16 depending on polynomial value.
@@ -87,7 +142,7 @@
  * @return CRC16 value
  */
 #define u16MSG_KINEIS_UTILS_calcCRC16(ptr, lengthBit) \
-			u16MSG_KINEIS_UTILS_calcCrcBch16(ptr, lengthBit, (uint16_t)CRC16_POLYNOMIAL)
+			u16MSG_KINEIS_UTILS_calcCrc16Fast(ptr, lengthBit)
 
 /**
  * @brief Calculate the CRC32, BCH32 or FCS32 depending on polynomial value.
@@ -129,6 +184,229 @@ uint16_t u16MSG_KINEIS_UTILS_calcCrcBch16(
 		int16_t lengthBit,
 		uint16_t u16Polynomial);
 
+/**
+ * @brief Calculate a 32 bits CRC/BCH with a byte-wise lookup table.
+ *
+ * Bit-exact with u32MSG_KINEIS_UTILS_calcCrcBch32 for the polynomial the table was built
+ * from, including lengths which are not a multiple of 8.
+ *
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ * @param[in] table: 256-entry table of the polynomial (in program memory on AVR)
+ *
+ * @return CRC32, BCH32 or FCS32 value
+ */
+uint32_t u32MSG_KINEIS_UTILS_calcCrcBch32Table(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint32_t *table);
+
+/**
+ * @brief Calculate a 16 bits CRC/BCH with a byte-wise lookup table.
+ *
+ * Bit-exact with u16MSG_KINEIS_UTILS_calcCrcBch16 for the polynomial the table was built
+ * from, including lengths which are not a multiple of 8.
+ *
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ * @param[in] table: 256-entry table of the polynomial (in program memory on AVR)
+ *
+ * @return CRC16 or BCH16 value
+ */
+uint16_t u16MSG_KINEIS_UTILS_calcCrcBch16Table(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint16_t *table);
+
+#if MSG_KINEIS_UTILS_SLICE_BY_8
+/**
+ * @brief Build the slicing-by-8 tables.
+ *
+ * Called lazily by the slicing functions and by vMSG_KINEIS_UTILS_initCrc16 and
+ * vMSG_KINEIS_UTILS_initBch32. Multithreaded host tools should call it once before starting
+ * their workers.
+ */
+void vMSG_KINEIS_UTILS_initSlice8(void);
+
+/**
+ * @brief Calculate a 32 bits CRC/BCH with slicing-by-8.
+ *
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ * @param[in] table: one of the au32MSG_KINEIS_UTILS_*Table byte-wise tables, used to select
+ *	the matching slice set. Other tables fall back to u32MSG_KINEIS_UTILS_calcCrcBch32Table.
+ *
+ * @return CRC32, BCH32 or FCS32 value
+ */
+uint32_t u32MSG_KINEIS_UTILS_calcCrcBch32Slice8(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint32_t *table);
+
+/**
+ * @brief Calculate a 16 bits CRC/BCH with slicing-by-8.
+ *
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ * @param[in] table: au16MSG_KINEIS_UTILS_crc16Table. Other tables fall back to
+ *	u16MSG_KINEIS_UTILS_calcCrcBch16Table.
+ *
+ * @return CRC16 or BCH16 value
+ */
+uint16_t u16MSG_KINEIS_UTILS_calcCrcBch16Slice8(
+		const uint8_t *ptr,
+		int16_t lengthBit,
+		const uint16_t *table);
+#endif
+
+/**
+ * @brief Calculate the BCH32 with the fastest engine of the build (see
+ * MSG_KINEIS_UTILS_SLICE_BY_8).
+ *
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ *
+ * @return BCH32 value
+ */
+uint32_t u32MSG_KINEIS_UTILS_calcBch32Fast(const uint8_t *ptr, int16_t lengthBit);
+
+/**
+ * @brief Calculate the FCS32 with the fastest engine of the build.
+ *
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ *
+ * @return FCS32 value
+ */
+uint32_t u32MSG_KINEIS_UTILS_calcFcs32Fast(const uint8_t *ptr, int16_t lengthBit);
+
+/**
+ * @brief Calculate the CRC16 with the fastest engine of the build.
+ *
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ *
+ * @return CRC16 value
+ */
+uint16_t u16MSG_KINEIS_UTILS_calcCrc16Fast(const uint8_t *ptr, int16_t lengthBit);
+
+/**
+ * @brief Start an incremental CRC16 calculation.
+ *
+ * The data may then be given in pieces of any number of bits, in order, with
+ * vMSG_KINEIS_UTILS_updateCrc16 and vMSG_KINEIS_UTILS_updateCrc16Bits. The result is the same as
+ * u16MSG_KINEIS_UTILS_calcCRC16 over the whole data. On host, the slicing-by-8 tables are
+ * built here rather than in the updates.
+ *
+ * @param[out] ctx: CRC16 context
+ */
+void vMSG_KINEIS_UTILS_initCrc16(MsgKineisCrc16CtxTypeDef_t *ctx);
+
+/**
+ * @brief Add bits to a CRC16, from the MSB of the pointed byte by ptr to the last bit
+ * (ptr+lengthBit).
+ *
+ * @param[in,out] ctx: CRC16 context
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ */
+void vMSG_KINEIS_UTILS_updateCrc16(
+		MsgKineisCrc16CtxTypeDef_t *ctx,
+		const uint8_t *ptr,
+		int16_t lengthBit);
+
+/**
+ * @brief Add the low bits of a value to a CRC16, MSB first.
+ *
+ * @param[in,out] ctx: CRC16 context
+ * @param[in] value: Bits to add, right aligned
+ * @param[in] lengthBit: Number of bits (max 32)
+ */
+void vMSG_KINEIS_UTILS_updateCrc16Bits(
+		MsgKineisCrc16CtxTypeDef_t *ctx,
+		uint32_t value,
+		uint8_t lengthBit);
+
+/**
+ * @brief CRC16 of the bits added so far.
+ *
+ * @param[in] ctx: CRC16 context, may still be updated afterwards
+ *
+ * @return CRC16 value
+ */
+uint16_t u16MSG_KINEIS_UTILS_finalCrc16(const MsgKineisCrc16CtxTypeDef_t *ctx);
+
+/**
+ * @brief Start an incremental BCH32 calculation, see vMSG_KINEIS_UTILS_initCrc16.
+ *
+ * @param[out] ctx: BCH32 context
+ */
+void vMSG_KINEIS_UTILS_initBch32(MsgKineisBch32CtxTypeDef_t *ctx);
+
+/**
+ * @brief Add bits to a BCH32, from the MSB of the pointed byte by ptr to the last bit
+ * (ptr+lengthBit).
+ *
+ * @param[in,out] ctx: BCH32 context
+ * @param[in] ptr: Pointer of the first byte
+ * @param[in] lengthBit: Length of the data in bit
+ */
+void vMSG_KINEIS_UTILS_updateBch32(
+		MsgKineisBch32CtxTypeDef_t *ctx,
+		const uint8_t *ptr,
+		int16_t lengthBit);
+
+/**
+ * @brief Add the low bits of a value to a BCH32, MSB first.
+ *
+ * @param[in,out] ctx: BCH32 context
+ * @param[in] value: Bits to add, right aligned
+ * @param[in] lengthBit: Number of bits (max 32)
+ */
+void vMSG_KINEIS_UTILS_updateBch32Bits(
+		MsgKineisBch32CtxTypeDef_t *ctx,
+		uint32_t value,
+		uint8_t lengthBit);
+
+/**
+ * @brief BCH32 of the bits added so far. Null once a codeword and its BCH32 have been added.
+ *
+ * @param[in] ctx: BCH32 context, may still be updated afterwards
+ *
+ * @return BCH32 value
+ */
+uint32_t u32MSG_KINEIS_UTILS_finalBch32(const MsgKineisBch32CtxTypeDef_t *ctx);
+
+#if MSG_KINEIS_UTILS_BCH32_CORRECT
+/**
+ * @brief Build the syndrome lookup of the BCH32 error correction.
+ *
+ * Called lazily by s8MSG_KINEIS_UTILS_correctBch32. Multithreaded host tools should call it
+ * once before starting their workers.
+ */
+void vMSG_KINEIS_UTILS_initBch32Correct(void);
+
+/**
+ * @brief Correct up to 2 erroneous bits of a codeword protected by a BCH32.
+ *
+ * The codeword is the data followed by its BCH32, as built by vMSGKINEIS_STDV1_setCRC16andBCH32.
+ * Its syndrome (BCH32 remainder of the whole codeword) is null when no error occurred, else it
+ * is looked up among the syndromes of all 1 and 2 bit errors, and the matching bits are flipped.
+ *
+ * @param[in,out] ptr: Pointer of the first byte of the codeword
+ * @param[in] lengthBit: Length of the codeword in bit (max BCH32_CORRECT_MAX_LENGTH_BIT)
+ * @param[out] errorBit: Positions in bit of the corrected errors from the MSB of ptr[0], 2
+ *	elements, may be NULL. Unused elements are set to -1.
+ *
+ * @return BCH32_STATUS_OK, BCH32_STATUS_CORRECTED_1, BCH32_STATUS_CORRECTED_2 or
+ *	BCH32_STATUS_UNCORRECTABLE (codeword left untouched)
+ */
+int8_t s8MSG_KINEIS_UTILS_correctBch32(
+		uint8_t *ptr,
+		int16_t lengthBit,
+		int16_t errorBit[2]);
+#endif
+
 /**
  * @}
  */
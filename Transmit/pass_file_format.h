@@ -0,0 +1,24 @@
+#ifndef PassFileFormat_h
+#define PassFileFormat_h
+// Binary satellite pass schedule stored on the SD card, written by Tools/prepas2bin.c
+// All values are little-endian.
+//
+// Header (PASS_FILE_HEADER_SIZE bytes)
+//   0  char[4]  magic "SPAS"
+//   4  uint8    version (PASS_FILE_VERSION)
+//   5  uint8    record size (PASS_FILE_RECORD_SIZE)
+//   6  uint16   reserved, 0
+//   8  uint32   number of records
+// Records (PASS_FILE_RECORD_SIZE bytes each), sorted by start time. Passes may overlap.
+//   0  uint32   start, seconds since 1970-01-01 UTC
+//   4  uint16   duration in seconds, the pass ends at start + duration included
+//   6  uint8    satellite id, see PASS_FILE_SATELLITES
+#define PASS_FILE_MAGIC "SPAS"
+#define PASS_FILE_VERSION 1
+#define PASS_FILE_HEADER_SIZE 12
+#define PASS_FILE_RECORD_SIZE 7
+#define PASS_FILE_MAX_DURATION 0xFFFFUL
+// Satellite codes of the Prepas output, in id order. Other satellites get PASS_FILE_UNKNOWN_SATELLITE
+#define PASS_FILE_SATELLITES { "MA", "MB", "MC", "NK", "NN", "NP", "SR", "A1", "CS", "OC" }
+#define PASS_FILE_UNKNOWN_SATELLITE 0xFF
+#endif
@@ -0,0 +1,270 @@
+#include "pass_predictor.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EARTH_MU 398600.4418f // km3/s2
+#define EARTH_RADIUS 6378.137f // km, WGS84 equatorial radius
+#define EARTH_FLATTENING (1.0f / 298.257223563f)
+#define EARTH_J2 1.08262668e-3f
+#define EARTH_ROTATION 7.2921159e-5f // rad/s
+#define TWO_PI 6.28318530718f
+#define DEGREES_TO_RADIANS 0.0174532925199f
+#define SECONDS_PER_DAY 86400L
+#define J2000_UNIX_TIME 946728000UL // 2000-01-01 12:00:00 UTC
+#define TLE_LINE_LENGTH 69
+// Search steps in seconds: shortest jump while out of range, and step along a pass
+#define PREDICT_MIN_STEP 10
+#define PREDICT_PASS_STEP 30
+#define PREDICT_MAX_PASS 3600
+
+static float wrapAngle(float angle) {
+  angle = fmodf(angle, TWO_PI);
+  return angle < 0 ? angle + TWO_PI : angle;
+}
+
+// Angle of the Earth around its axis (Greenwich mean sidereal time) in radians. The time is
+// split into days and seconds so a float keeps the fraction of a turn
+static float siderealAngle(uint32_t unixTime) {
+  int32_t seconds = (int32_t)(unixTime - J2000_UNIX_TIME);
+  int32_t days = seconds / SECONDS_PER_DAY;
+  seconds -= days * SECONDS_PER_DAY;
+  float turns = fmodf(0.00273781191135448f * days, 1.0f) + 0.7790572732640f +
+    1.00273781191135448f * seconds / SECONDS_PER_DAY;
+  // Precession of the equinox since J2000
+  float centuries = (days + (float)seconds / SECONDS_PER_DAY) / 36525.0f;
+  return wrapAngle(TWO_PI * (turns - floorf(turns)) + 2.23603e-2f * centuries);
+}
+
+// Earth-fixed position of the satellite in km
+static void satellitePosition(const OrbitalElements &elements, uint32_t unixTime, float position[3]) {
+  float elapsed = (float)(int32_t)(unixTime - elements.epoch);
+  float meanAnomaly = wrapAngle(elements.meanAnomaly + elements.meanMotion * elapsed);
+  float raan = elements.raan + elements.raanRate * elapsed;
+  float argPerigee = elements.argPerigee + elements.argPerigeeRate * elapsed;
+  float e = elements.eccentricity;
+
+  // Kepler's equation by Newton iterations, the orbits are nearly circular
+  float eccentricAnomaly = meanAnomaly + e * sinf(meanAnomaly);
+  for (uint8_t i = 0; i < 3; i++) {
+    eccentricAnomaly -= (eccentricAnomaly - e * sinf(eccentricAnomaly) - meanAnomaly) /
+      (1 - e * cosf(eccentricAnomaly));
+  }
+  float x = elements.semiMajorAxis * (cosf(eccentricAnomaly) - e);
+  float y = elements.semiMajorAxis * sqrtf(1 - e * e) * sinf(eccentricAnomaly);
+
+  float cosRaan = cosf(raan), sinRaan = sinf(raan);
+  float cosArg = cosf(argPerigee), sinArg = sinf(argPerigee);
+  float cosInc = cosf(elements.inclination), sinInc = sinf(elements.inclination);
+  float inertial[3] = {
+    x * (cosRaan * cosArg - sinRaan * sinArg * cosInc) - y * (cosRaan * sinArg + sinRaan * cosArg * cosInc),
+    x * (sinRaan * cosArg + cosRaan * sinArg * cosInc) - y * (sinRaan * sinArg - cosRaan * cosArg * cosInc),
+    x * sinArg * sinInc + y * cosArg * sinInc
+  };
+
+  float angle = siderealAngle(unixTime);
+  float cosAngle = cosf(angle), sinAngle = sinf(angle);
+  position[0] = cosAngle * inertial[0] + sinAngle * inertial[1];
+  position[1] = cosAngle * inertial[1] - sinAngle * inertial[0];
+  position[2] = inertial[2];
+}
+
+// Number in columns [start, start + length) of a TLE line, with an optional implied "0." prefix
+static float tleField(const char *line, uint8_t start, uint8_t length, bool impliedDecimal) {
+  char field[16];
+  uint8_t used = 0;
+  if (impliedDecimal) {
+    field[used++] = '0';
+    field[used++] = '.';
+  }
+  memcpy(&field[used], &line[start], length);
+  field[used + length] = '\0';
+  return (float)atof(field);
+}
+
+static bool tleChecksumOk(const char *line) {
+  uint8_t sum = 0;
+  for (uint8_t i = 0; i < TLE_LINE_LENGTH - 1; i++) {
+    if (line[i] >= '0' && line[i] <= '9') {
+      sum += line[i] - '0';
+    } else if (line[i] == '-') {
+      sum++;
+    }
+  }
+  return line[TLE_LINE_LENGTH - 1] - '0' == sum % 10;
+}
+
+bool parseTwoLineElements(const char *line1, const char *line2, OrbitalElements &elements) {
+  if (strlen(line1) < TLE_LINE_LENGTH || strlen(line2) < TLE_LINE_LENGTH ||
+      line1[0] != '1' || line2[0] != '2' || !tleChecksumOk(line1) || !tleChecksumOk(line2)) {
+    return false;
+  }
+
+  // Epoch : 2 digit year, then day of the year with its fraction
+  int year = (int)tleField(line1, 18, 2, false);
+  year += year < 57 ? 2000 : 1900;
+  int32_t daysTo1970 = 365L * (year - 1970) + (year - 1969) / 4 - (year - 1901) / 100 + (year - 1601) / 400;
+  int dayOfYear = (int)tleField(line1, 20, 3, false);
+  float dayFraction = tleField(line1, 24, 8, true) * SECONDS_PER_DAY;
+  elements.epoch = (uint32_t)((daysTo1970 + dayOfYear - 1) * SECONDS_PER_DAY) + (uint32_t)dayFraction;
+
+  elements.inclination = tleField(line2, 8, 8, false) * DEGREES_TO_RADIANS;
+  elements.raan = tleField(line2, 17, 8, false) * DEGREES_TO_RADIANS;
+  elements.eccentricity = tleField(line2, 26, 7, true);
+  elements.argPerigee = tleField(line2, 34, 8, false) * DEGREES_TO_RADIANS;
+  elements.meanMotion = tleField(line2, 52, 11, false) * TWO_PI / SECONDS_PER_DAY;
+  // The epoch is kept to the second, move the mean anomaly back by the dropped fraction
+  elements.meanAnomaly = wrapAngle(tleField(line2, 43, 8, false) * DEGREES_TO_RADIANS -
+    elements.meanMotion * (dayFraction - floorf(dayFraction)));
+
+  float n = elements.meanMotion;
+  float e = elements.eccentricity;
+  elements.semiMajorAxis = powf(EARTH_MU / (n * n), 1.0f / 3.0f);
+  float semiLatusRectum = elements.semiMajorAxis * (1 - e * e);
+  float drift = 1.5f * EARTH_J2 * n * (EARTH_RADIUS / semiLatusRectum) * (EARTH_RADIUS / semiLatusRectum);
+  float sinInc = sinf(elements.inclination);
+  elements.raanRate = -drift * cosf(elements.inclination);
+  elements.argPerigeeRate = drift * (2.0f - 2.5f * sinInc * sinInc);
+  return true;
+}
+
+PassPredictor::PassPredictor(float latitude, float longitude, float altitude, float minElevation) {
+  float lat = latitude * DEGREES_TO_RADIANS;
+  float lon = longitude * DEGREES_TO_RADIANS;
+  float e2 = EARTH_FLATTENING * (2 - EARTH_FLATTENING);
+  float normal = EARTH_RADIUS / sqrtf(1 - e2 * sinf(lat) * sinf(lat));
+  float height = altitude / 1000.0f;
+  _observer[0] = (normal + height) * cosf(lat) * cosf(lon);
+  _observer[1] = (normal + height) * cosf(lat) * sinf(lon);
+  _observer[2] = (normal * (1 - e2) + height) * sinf(lat);
+  _up[0] = cosf(lat) * cosf(lon);
+  _up[1] = cosf(lat) * sinf(lon);
+  _up[2] = sinf(lat);
+  _observerRadius = sqrtf(_observer[0] * _observer[0] + _observer[1] * _observer[1] + _observer[2] * _observer[2]);
+  _minElevation = minElevation * DEGREES_TO_RADIANS;
+  _sinMinElevation = sinf(_minElevation);
+  _cosMinElevation = cosf(_minElevation);
+}
+
+float PassPredictor::elevation(const OrbitalElements &elements, uint32_t targetTime) {
+  float position[3];
+  satellitePosition(elements, targetTime, position);
+  float range[3] = { position[0] - _observer[0], position[1] - _observer[1], position[2] - _observer[2] };
+  float distance = sqrtf(range[0] * range[0] + range[1] * range[1] + range[2] * range[2]);
+  return asinf((range[0] * _up[0] + range[1] * _up[1] + range[2] * _up[2]) / distance) / DEGREES_TO_RADIANS;
+}
+
+// Whether the satellite is above the lowest elevation. When it is not, skipTime is a time it cannot
+// get in range within: the angle it still has to travel over the highest rate it moves at
+bool PassPredictor::isVisible(const OrbitalElements &elements, uint32_t targetTime, float &skipTime) {
+  float position[3];
+  satellitePosition(elements, targetTime, position);
+  float range[3] = { position[0] - _observer[0], position[1] - _observer[1], position[2] - _observer[2] };
+  float distance = sqrtf(range[0] * range[0] + range[1] * range[1] + range[2] * range[2]);
+  float up = range[0] * _up[0] + range[1] * _up[1] + range[2] * _up[2];
+  skipTime = 0;
+  if (up >= _sinMinElevation * distance) {
+    return true;
+  }
+
+  float radius = sqrtf(position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+  float cosAngle = (position[0] * _observer[0] + position[1] * _observer[1] + position[2] * _observer[2]) /
+    (radius * _observerRadius);
+  float angle = acosf(fmaxf(-1.0f, fminf(1.0f, cosAngle)));
+  // Largest angle between the observer and the satellite, seen from the centre of the Earth, for
+  // the lowest elevation, with half a degree of margin
+  float rangeAngle = acosf(_observerRadius / radius * _cosMinElevation) - _minElevation + 0.5f * DEGREES_TO_RADIANS;
+  float rate = elements.meanMotion * (1 + 3 * elements.eccentricity) + EARTH_ROTATION;
+  skipTime = (angle - rangeAngle) / rate;
+  return false;
+}
+
+// First visible second between a time the satellite is not visible and one it is, in either order
+uint32_t PassPredictor::findEdge(const OrbitalElements &elements, uint32_t notVisibleTime, uint32_t visibleTime) {
+  float skipTime;
+  while (notVisibleTime - visibleTime > 1 && visibleTime - notVisibleTime > 1) {
+    uint32_t middle = notVisibleTime < visibleTime ?
+      notVisibleTime + (visibleTime - notVisibleTime) / 2 : visibleTime + (notVisibleTime - visibleTime) / 2;
+    if (isVisible(elements, middle, skipTime)) {
+      visibleTime = middle;
+    } else {
+      notVisibleTime = middle;
+    }
+  }
+  return visibleTime;
+}
+
+bool PassPredictor::nextPass(const OrbitalElements &elements, uint32_t fromTime, SatellitePass &pass) {
+  float skipTime;
+  uint32_t time = fromTime;
+  uint32_t startTime;
+
+  if (isVisible(elements, fromTime, skipTime)) {
+    // Pass in progress: go back to its start
+    do {
+      time -= PREDICT_PASS_STEP;
+    } while (fromTime - time < PREDICT_MAX_PASS && isVisible(elements, time, skipTime));
+    startTime = findEdge(elements, time, time + PREDICT_PASS_STEP);
+  } else {
+    uint32_t previous;
+    do {
+      previous = time;
+      time += skipTime > PREDICT_MIN_STEP ? (uint32_t)skipTime : PREDICT_MIN_STEP;
+      if (time - fromTime > PREDICT_HORIZON) {
+        return false;
+      }
+    } while (!isVisible(elements, time, skipTime));
+    startTime = findEdge(elements, previous, time);
+  }
+
+  time = startTime;
+  do {
+    time += PREDICT_PASS_STEP;
+  } while (time - startTime < PREDICT_MAX_PASS && isVisible(elements, time, skipTime));
+  pass = SatellitePass(startTime, findEdge(elements, time, time - PREDICT_PASS_STEP));
+  return true;
+}
+
+PredictedPassSchedule::PredictedPassSchedule(PassPredictor &predictor) : _predictor(predictor) {
+  _count = 0;
+}
+
+bool PredictedPassSchedule::addSatellite(const OrbitalElements &elements) {
+  if (_count == PREDICT_MAX_SATELLITES) {
+    return false;
+  }
+  _satellites[_count] = elements;
+  _predicted[_count] = false;
+  _count++;
+  return true;
+}
+
+uint8_t PredictedPassSchedule::satelliteCount() {
+  return _count;
+}
+
+bool PredictedPassSchedule::findPass(uint32_t targetTime, SatellitePass &pass) {
+  bool found = false;
+  for (uint8_t i = 0; i < _count; i++) {
+    // A prediction stays valid until its pass is over. When there was none, look again every hour
+    bool valid = _predicted[i] && _predictedFrom[i] <= targetTime &&
+      (_found[i] ? _passes[i].endTime() >= targetTime : targetTime - _predictedFrom[i] < 3600);
+    if (!valid) {
+      _found[i] = _predictor.nextPass(_satellites[i], targetTime, _passes[i]);
+      _predictedFrom[i] = targetTime;
+      _predicted[i] = true;
+    }
+    if (!_found[i]) {
+      continue;
+    }
+    // The pass in progress lasting the longest, or else the first one to start
+    bool inProgress = _passes[i].isInRange(targetTime);
+    if (!found ||
+        (inProgress && (!pass.isInRange(targetTime) || _passes[i].endTime() > pass.endTime())) ||
+        (!inProgress && !pass.isInRange(targetTime) && _passes[i].startTime() < pass.startTime())) {
+      pass = _passes[i];
+      found = true;
+    }
+  }
+  return found;
+}
@@ -0,0 +1,67 @@
+#ifndef PassPredictor_h
+#define PassPredictor_h
+#include <stdint.h>
+#include "pass_schedule.h"
+
+#define PREDICT_MAX_SATELLITES 8
+// Longest search for the next pass of a satellite, in seconds
+#define PREDICT_HORIZON 172800UL
+
+// Mean orbital elements of a satellite, propagated with a Keplerian orbit plus the secular drift of
+// the node and perigee due to the Earth's flattening (J2). Angles in radians, times in seconds.
+struct OrbitalElements {
+  uint32_t epoch; // seconds since 1970-01-01 UTC
+  float meanMotion; // rad/s
+  float eccentricity;
+  float inclination;
+  float raan; // at epoch
+  float argPerigee; // at epoch
+  float meanAnomaly; // at epoch
+  float semiMajorAxis; // km
+  float raanRate; // rad/s
+  float argPerigeeRate; // rad/s
+};
+
+// Read the two data lines of a TLE (NORAD two-line element set), as published by Celestrak or
+// Space-Track. Returns false when a line is too short or its checksum is wrong
+bool parseTwoLineElements(const char *line1, const char *line2, OrbitalElements &elements);
+
+// Visibility of satellites from a place on the ground. Float math only, sized for 8-bit MCUs:
+// far from a pass, the search jumps ahead by the time the satellite needs to get in range.
+class PassPredictor {
+  public:
+    // Latitude and longitude in degrees, altitude in metres, lowest useful elevation in degrees
+    PassPredictor(float latitude, float longitude, float altitude, float minElevation);
+    // Elevation in degrees of the satellite at targetTime
+    float elevation(const OrbitalElements &elements, uint32_t targetTime);
+    // Pass in progress at fromTime, or else the next one within PREDICT_HORIZON. Times are to the second
+    bool nextPass(const OrbitalElements &elements, uint32_t fromTime, SatellitePass &pass);
+  private:
+    bool isVisible(const OrbitalElements &elements, uint32_t targetTime, float &skipTime);
+    uint32_t findEdge(const OrbitalElements &elements, uint32_t notVisibleTime, uint32_t visibleTime);
+    float _observer[3];
+    float _up[3];
+    float _observerRadius;
+    float _sinMinElevation;
+    float _cosMinElevation;
+    float _minElevation;
+};
+
+// Passes of up to PREDICT_MAX_SATELLITES satellites, each predicted one pass ahead when needed
+class PredictedPassSchedule : public PassSchedule {
+  public:
+    PredictedPassSchedule(PassPredictor &predictor);
+    bool addSatellite(const OrbitalElements &elements);
+    uint8_t satelliteCount();
+    bool findPass(uint32_t targetTime, SatellitePass &pass);
+  private:
+    PassPredictor &_predictor;
+    OrbitalElements _satellites[PREDICT_MAX_SATELLITES];
+    // Next pass of each satellite from _predictedFrom, if _found
+    SatellitePass _passes[PREDICT_MAX_SATELLITES];
+    uint32_t _predictedFrom[PREDICT_MAX_SATELLITES];
+    bool _found[PREDICT_MAX_SATELLITES];
+    bool _predicted[PREDICT_MAX_SATELLITES];
+    uint8_t _count;
+};
+#endif
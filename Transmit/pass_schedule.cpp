@@ -0,0 +1,60 @@
+#include "pass_schedule.h"
+
+bool PassSchedule::isInPass(uint32_t targetTime) {
+  SatellitePass pass;
+  return findPass(targetTime, pass) && pass.isInRange(targetTime);
+}
+
+bool PassSchedule::nextPass(uint32_t targetTime, SatellitePass &pass) {
+  if (!findPass(targetTime, pass)) {
+    return false;
+  }
+  if (pass.isInRange(targetTime)) {
+    return pass.endTime() != 0xFFFFFFFFUL && findPass(pass.endTime() + 1, pass);
+  }
+  return true;
+}
+
+FlashPassSchedule::FlashPassSchedule(const uint32_t *passTimes, uint16_t count) {
+  _passTimes = passTimes;
+  _count = count;
+  _cursor = 0;
+}
+
+uint32_t FlashPassSchedule::startTime(uint16_t index) {
+  return pgm_read_dword(&_passTimes[2 * index]);
+}
+
+uint32_t FlashPassSchedule::endTime(uint16_t index) {
+  return pgm_read_dword(&_passTimes[2 * index + 1]);
+}
+
+// True when the pass at index is the first one not over at targetTime (index == count when all are over)
+bool FlashPassSchedule::isFirstEndingFrom(uint16_t index, uint32_t targetTime) {
+  return (index == _count || endTime(index) >= targetTime) && (index == 0 || endTime(index - 1) < targetTime);
+}
+
+bool FlashPassSchedule::findPass(uint32_t targetTime, SatellitePass &pass) {
+  if (isFirstEndingFrom(_cursor, targetTime)) {
+    // Same pass as the last lookup
+  } else if (_cursor < _count && isFirstEndingFrom(_cursor + 1, targetTime)) {
+    _cursor++;
+  } else {
+    uint16_t low = 0;
+    uint16_t high = _count;
+    while (low < high) {
+      uint16_t middle = low + (high - low) / 2;
+      if (endTime(middle) < targetTime) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    _cursor = low;
+  }
+  if (_cursor == _count) {
+    return false;
+  }
+  pass = SatellitePass(startTime(_cursor), endTime(_cursor));
+  return true;
+}
@@ -0,0 +1,42 @@
+#ifndef PassSchedule_h
+#define PassSchedule_h
+#include <stdint.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_dword
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#endif
+#endif
+#include "satellite_pass.h"
+
+// Satellite passes ordered in time. Times are in seconds since 1970-01-01, as DateTime::unixtime()
+class PassSchedule {
+  public:
+    virtual ~PassSchedule() {}
+    // Pass in progress at targetTime, or else the next one. Returns false when no pass is left
+    virtual bool findPass(uint32_t targetTime, SatellitePass &pass) = 0;
+    bool isInPass(uint32_t targetTime);
+    // First pass starting after targetTime, even when a pass is in progress
+    bool nextPass(uint32_t targetTime, SatellitePass &pass);
+};
+
+// Passes stored in flash as pairs of start and end times, sorted and without overlaps.
+// Lookups are a binary search, except when the time is still in the same pass as the last
+// lookup or has moved on to the following one, which is the case when the clock is polled.
+class FlashPassSchedule : public PassSchedule {
+  public:
+    FlashPassSchedule(const uint32_t *passTimes, uint16_t count);
+    bool findPass(uint32_t targetTime, SatellitePass &pass);
+  private:
+    uint32_t startTime(uint16_t index);
+    uint32_t endTime(uint16_t index);
+    bool isFirstEndingFrom(uint16_t index, uint32_t targetTime);
+    const uint32_t *_passTimes;
+    uint16_t _count;
+    uint16_t _cursor;
+};
+#endif
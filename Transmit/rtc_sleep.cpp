@@ -0,0 +1,65 @@
+#include "rtc_sleep.h"
+#include <Arduino.h>
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+#define MAX_PERIODS 255
+
+RtcSleep::RtcSleep(RTC_PCF8523 &rtc, uint8_t interruptPin) : _rtc(rtc) {
+  _interruptPin = interruptPin;
+}
+
+void RtcSleep::begin() {
+  // INT/SQW is an open drain output
+  pinMode(_interruptPin, INPUT_PULLUP);
+  _rtc.deconfigureAllTimers();
+}
+
+void RtcSleep::sleepUntil(uint32_t wakeTime) {
+  uint32_t now = _rtc.now().unixtime();
+  while (now < wakeTime) {
+    uint32_t left = wakeTime - now;
+    // The first period of the timer may be short, so it wakes early rather than late and sleeps again
+    if (left > MAX_PERIODS) {
+      _rtc.enableCountdownTimer(PCF8523_FrequencyMinute, left / 60 > MAX_PERIODS ? MAX_PERIODS : left / 60);
+    } else {
+      _rtc.enableCountdownTimer(PCF8523_FrequencySecond, left);
+    }
+    powerDown();
+    _rtc.disableCountdownTimer();
+    now = _rtc.now().unixtime();
+  }
+}
+
+#if defined(__AVR__)
+static int wakeInterrupt;
+
+// The level interrupt keeps firing while the pin is low
+static void wake() {
+  sleep_disable();
+  detachInterrupt(wakeInterrupt);
+}
+#endif
+
+// Until the timer pulls the interrupt pin low
+void RtcSleep::powerDown() {
+#if defined(__AVR__)
+  int interrupt = digitalPinToInterrupt(_interruptPin);
+  if (interrupt != NOT_AN_INTERRUPT) {
+    // A low level wakes the MCU from power down on every pin, an edge does not
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    wakeInterrupt = interrupt;
+    noInterrupts();
+    sleep_enable();
+    attachInterrupt(interrupt, wake, LOW);
+    interrupts();
+    sleep_cpu();
+    sleep_disable();
+    return;
+  }
+#endif
+  while (digitalRead(_interruptPin) == HIGH) {
+    delay(250);
+  }
+}
@@ -0,0 +1,21 @@
+#ifndef RtcSleep_h
+#define RtcSleep_h
+#include <stdint.h>
+#include "RTClib.h"
+
+// Sleep until a time of the real time clock. The countdown timer of the PCF8523 is set to the time
+// left, in minutes then in seconds as it counts to 255 at most, and pulls its INT/SQW output low when
+// it runs out. With that output wired to an interrupt pin, AVR boards power down until then.
+// Elsewhere, e.g. an UNO whose interrupt pins 2 and 3 are taken, the board waits for it awake.
+class RtcSleep {
+  public:
+    RtcSleep(RTC_PCF8523 &rtc, uint8_t interruptPin);
+    void begin();
+    // Returns at wakeTime, in seconds since 1970-01-01, or straight away when it is past
+    void sleepUntil(uint32_t wakeTime);
+  private:
+    void powerDown();
+    RTC_PCF8523 &_rtc;
+    uint8_t _interruptPin;
+};
+#endif
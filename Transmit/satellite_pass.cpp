@@ -1,10 +1,32 @@
 #include "satellite_pass.h"
 #include "RTClib.h"
+SatellitePass::SatellitePass() {
+    _startTime = 0;
+    _endTime = 0;
+}
+
 SatellitePass::SatellitePass(DateTime startDate, DateTime endDate) {
-    _startDate = startDate;
-    _endDate = endDate;
+    _startTime = startDate.unixtime();
+    _endTime = endDate.unixtime();
+}
+
+SatellitePass::SatellitePass(uint32_t startTime, uint32_t endTime) {
+    _startTime = startTime;
+    _endTime = endTime;
 }
 
 bool SatellitePass::isInRange(DateTime targetDate) {
-  return targetDate >= _startDate && targetDate <= _endDate;
+  return isInRange(targetDate.unixtime());
+}
+
+bool SatellitePass::isInRange(uint32_t targetTime) {
+  return targetTime >= _startTime && targetTime <= _endTime;
+}
+
+uint32_t SatellitePass::startTime() {
+  return _startTime;
+}
+
+uint32_t SatellitePass::endTime() {
+  return _endTime;
 }
@@ -1,12 +1,18 @@
 #ifndef SatellitePass_h
 #define SatellitePass_h
 #include "RTClib.h"
+// Time interval when a satellite can be reached, in seconds since 1970-01-01 with both ends included
 class SatellitePass {
 	public:
+    SatellitePass();
     SatellitePass(DateTime startDate, DateTime endDate);
+    SatellitePass(uint32_t startTime, uint32_t endTime);
     bool isInRange(DateTime targetDate);
+    bool isInRange(uint32_t targetTime);
+    uint32_t startTime();
+    uint32_t endTime();
   private:
-    DateTime _startDate;
-    DateTime _endDate;
+    uint32_t _startTime;
+    uint32_t _endTime;
 };
 #endif
@@ -0,0 +1,83 @@
+#ifndef SatellitePasses_h
+#define SatellitePasses_h
+#include "pass_schedule.h"
+
+// Satellite passes over the transmitter from Prepas (see README.md), as pairs of start and end
+// times in seconds since 1970-01-01 UTC, both included.
+// Passes must be sorted by start time and overlapping or touching passes merged into one, as
+// FlashPassSchedule searches them by end time.
+const uint32_t satellitePassTimes[] PROGMEM = {
+	1646017141UL, 1646017263UL,	// 2022-02-28 02:59:01 - 03:01:03
+	1646019633UL, 1646019751UL,	// 2022-02-28 03:40:33 - 03:42:31
+	1646022869UL, 1646023164UL,	// 2022-02-28 04:34:29 - 04:39:24
+	1646025145UL, 1646025365UL,	// 2022-02-28 05:12:25 - 05:16:05
+	1646028878UL, 1646029144UL,	// 2022-02-28 06:14:38 - 06:19:04
+	1646029981UL, 1646030160UL,	// 2022-02-28 06:33:01 - 06:36:00
+	1646031340UL, 1646031588UL,	// 2022-02-28 06:55:40 - 06:59:48
+	1646035884UL, 1646036194UL,	// 2022-02-28 08:11:24 - 08:16:34
+	1646037339UL, 1646037820UL,	// 2022-02-28 08:35:39 - 08:43:40
+	1646038537UL, 1646038651UL,	// 2022-02-28 08:55:37 - 08:57:31
+	1646040394UL, 1646040686UL,	// 2022-02-28 09:26:34 - 09:31:26
+	1646041920UL, 1646042149UL,	// 2022-02-28 09:52:00 - 09:55:49
+	1646043443UL, 1646043869UL,	// 2022-02-28 10:17:23 - 10:24:29
+	1646044436UL, 1646044757UL,	// 2022-02-28 10:33:56 - 10:39:17
+	1646046401UL, 1646046696UL,	// 2022-02-28 11:06:41 - 11:11:36
+	1646049612UL, 1646049838UL,	// 2022-02-28 12:00:12 - 12:03:58
+	1646050508UL, 1646050777UL,	// 2022-02-28 12:15:08 - 12:19:37
+	1646052559UL, 1646052628UL,	// 2022-02-28 12:49:19 - 12:50:28
+	1646065406UL, 1646065494UL,	// 2022-02-28 16:23:26 - 16:24:54
+	1646066540UL, 1646066605UL,	// 2022-02-28 16:42:20 - 16:43:25
+	1646067003UL, 1646067214UL,	// 2022-02-28 16:50:03 - 16:53:34
+	1646071116UL, 1646071411UL,	// 2022-02-28 17:58:36 - 18:03:31
+	1646071873UL, 1646072088UL,	// 2022-02-28 18:11:13 - 18:14:48
+	1646072328UL, 1646072629UL,	// 2022-02-28 18:18:48 - 18:23:49
+	1646072881UL, 1646073256UL,	// 2022-02-28 18:28:01 - 18:34:16
+	1646074265UL, 1646074346UL,	// 2022-02-28 18:51:05 - 18:52:26
+	1646075801UL, 1646076049UL,	// 2022-02-28 19:16:41 - 19:20:49
+	1646077123UL, 1646077407UL,	// 2022-02-28 19:38:43 - 19:43:27
+	1646077569UL, 1646077709UL,	// 2022-02-28 19:46:09 - 19:48:29
+	1646078323UL, 1646078575UL,	// 2022-02-28 19:58:43 - 20:02:55
+	1646078890UL, 1646079279UL,	// 2022-02-28 20:08:10 - 20:14:39
+	1646080006UL, 1646080309UL,	// 2022-02-28 20:26:46 - 20:31:49
+	1646081709UL, 1646082028UL,	// 2022-02-28 20:55:09 - 21:00:28
+	1646084937UL, 1646085217UL,	// 2022-02-28 21:48:57 - 21:53:37
+	1646086045UL, 1646086352UL,	// 2022-02-28 22:07:25 - 22:12:32
+	1646087933UL, 1646088088UL,	// 2022-02-28 22:38:53 - 22:41:28
+	1646105198UL, 1646105243UL,	// 2022-03-01 03:26:38 - 03:27:23
+	1646107444UL, 1646107713UL,	// 2022-03-01 04:04:04 - 04:08:33
+	1646110626UL, 1646110847UL,	// 2022-03-01 04:57:06 - 05:00:47
+	1646113370UL, 1646113668UL,	// 2022-03-01 05:42:50 - 05:47:48
+	1646116425UL, 1646116516UL,	// 2022-03-01 06:33:45 - 06:35:16
+	1646117050UL, 1646117269UL,	// 2022-03-01 06:44:10 - 06:47:49
+	1646120773UL, 1646121077UL,	// 2022-03-01 07:46:13 - 07:51:17
+	1646122852UL, 1646122958UL,	// 2022-03-01 08:20:52 - 08:22:38
+	1646123026UL, 1646123351UL,	// 2022-03-01 08:23:46 - 08:29:11
+	1646125566UL, 1646125832UL,	// 2022-03-01 09:06:06 - 09:10:32
+	1646126785UL, 1646127052UL,	// 2022-03-01 09:26:25 - 09:30:52
+	1646128713UL, 1646129026UL,	// 2022-03-01 09:58:33 - 10:03:46
+	1646129119UL, 1646129354UL,	// 2022-03-01 10:05:19 - 10:09:14
+	1646130120UL, 1646130436UL,	// 2022-03-01 10:22:00 - 10:27:16
+	1646131551UL, 1646131858UL,	// 2022-03-01 10:45:51 - 10:50:58
+	1646134751UL, 1646135011UL,	// 2022-03-01 11:39:11 - 11:43:31
+	1646136180UL, 1646136466UL,	// 2022-03-01 12:03:00 - 12:07:46
+	1646137648UL, 1646137806UL,	// 2022-03-01 12:27:28 - 12:30:06
+	1646152734UL, 1646152915UL,	// 2022-03-01 16:38:54 - 16:41:55
+	1646156037UL, 1646156309UL,	// 2022-03-01 17:33:57 - 17:38:29
+	1646156879UL, 1646157157UL,	// 2022-03-01 17:47:59 - 17:52:37
+	1646157359UL, 1646157567UL,	// 2022-03-01 17:55:59 - 17:59:27
+	1646158576UL, 1646158897UL,	// 2022-03-01 18:16:16 - 18:21:37
+	1646161011UL, 1646161221UL,	// 2022-03-01 18:56:51 - 19:00:21
+	1646161979UL, 1646162284UL,	// 2022-03-01 19:12:59 - 19:18:04
+	1646162842UL, 1646163197UL,	// 2022-03-01 19:27:22 - 19:33:17
+	1646164072UL, 1646164362UL,	// 2022-03-01 19:47:52 - 19:52:42
+	1646164688UL, 1646164960UL,	// 2022-03-01 19:58:08 - 20:02:40
+	1646165703UL, 1646165996UL,	// 2022-03-01 20:15:03 - 20:19:56
+	1646166866UL, 1646167184UL,	// 2022-03-01 20:34:26 - 20:39:44
+	1646168975UL, 1646169018UL,	// 2022-03-01 21:09:35 - 21:10:18
+	1646170062UL, 1646170366UL,	// 2022-03-01 21:27:42 - 21:32:46
+	1646171713UL, 1646172029UL,	// 2022-03-01 21:55:13 - 22:00:29
+	1646172999UL, 1646173227UL,	// 2022-03-01 22:16:39 - 22:20:27
+};
+
+#define SATELLITE_PASS_COUNT (sizeof(satellitePassTimes) / sizeof(satellitePassTimes[0]) / 2)
+#endif
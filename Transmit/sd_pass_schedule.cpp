@@ -0,0 +1,169 @@
+#include "sd_pass_schedule.h"
+#include <string.h>
+
+static uint32_t recordOffset(uint32_t index) {
+  return PASS_FILE_HEADER_SIZE + index * PASS_FILE_RECORD_SIZE;
+}
+
+static uint32_t readLittleEndian(const uint8_t *bytes, uint8_t length) {
+  uint32_t value = 0;
+  while (length > 0) {
+    length--;
+    value = (value << 8) | bytes[length];
+  }
+  return value;
+}
+
+SdPassSchedule::SdPassSchedule(const char *filename) {
+  _filename = filename;
+  _recordCount = 0;
+  _nextRecord = 0;
+  _hasPending = false;
+  _windowStart = 0;
+  _windowCount = 0;
+  _validFrom = 0;
+}
+
+bool SdPassSchedule::begin() {
+  uint8_t header[PASS_FILE_HEADER_SIZE];
+  _recordCount = 0;
+  if (_file) {
+    _file.close();
+  }
+  _file = SD.open(_filename, FILE_READ);
+  if (!_file) {
+    return false;
+  }
+  bool valid = _file.read(header, sizeof(header)) == sizeof(header) &&
+    memcmp(header, PASS_FILE_MAGIC, 4) == 0 &&
+    header[4] == PASS_FILE_VERSION &&
+    header[5] == PASS_FILE_RECORD_SIZE;
+  if (valid) {
+    _recordCount = readLittleEndian(&header[8], 4);
+    if (_file.size() < recordOffset(_recordCount)) {
+      _recordCount = 0;
+      valid = false;
+    }
+  }
+  if (!valid) {
+    _file.close();
+  }
+  seek(0);
+  return valid;
+}
+
+uint32_t SdPassSchedule::recordCount() {
+  return _recordCount;
+}
+
+bool SdPassSchedule::readRecord(uint32_t &startTime, uint32_t &endTime) {
+  uint8_t record[PASS_FILE_RECORD_SIZE];
+  if (_file.read(record, sizeof(record)) != sizeof(record)) {
+    return false;
+  }
+  startTime = readLittleEndian(&record[0], 4);
+  endTime = startTime + readLittleEndian(&record[4], 2);
+  return true;
+}
+
+bool SdPassSchedule::readStartTime(uint32_t index, uint32_t &startTime) {
+  uint8_t start[4];
+  if (!_file.seek(recordOffset(index)) ||
+      _file.read(start, sizeof(start)) != sizeof(start)) {
+    return false;
+  }
+  startTime = readLittleEndian(start, 4);
+  return true;
+}
+
+// Restart the window from the first record which can still be in progress at targetTime
+void SdPassSchedule::seek(uint32_t targetTime) {
+  uint32_t earliestStart = targetTime > PASS_FILE_MAX_DURATION ? targetTime - PASS_FILE_MAX_DURATION : 0;
+  uint32_t low = 0;
+  uint32_t high = _recordCount;
+  while (_file && low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    uint32_t startTime;
+    if (!readStartTime(middle, startTime)) {
+      break;
+    }
+    if (startTime < earliestStart) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  _nextRecord = low;
+  _hasPending = false;
+  _windowStart = 0;
+  _windowCount = 0;
+  _validFrom = targetTime;
+}
+
+// Read the next passes into the empty window. A pass is only added once the following record
+// is known not to overlap it. The file is only repositioned after a search
+void SdPassSchedule::fill() {
+  _windowStart = 0;
+  _windowCount = 0;
+  uint32_t offset = recordOffset(_nextRecord);
+  if (!_file || (_file.position() != offset && !_file.seek(offset))) {
+    _nextRecord = _recordCount;
+    _hasPending = false;
+    return;
+  }
+  while (true) {
+    if (!_hasPending) {
+      if (_nextRecord >= _recordCount) {
+        break;
+      }
+      if (!readRecord(_pendingStart, _pendingEnd)) {
+        _nextRecord = _recordCount;
+        break;
+      }
+      _nextRecord++;
+      _hasPending = true;
+    }
+    if (_windowCount > 0 && _pendingStart <= _window[_windowCount - 1].endTime() + 1) {
+      SatellitePass &last = _window[_windowCount - 1];
+      if (_pendingEnd > last.endTime()) {
+        last = SatellitePass(last.startTime(), _pendingEnd);
+      }
+      _hasPending = false;
+      continue;
+    }
+    if (_windowCount == SD_PASS_WINDOW) {
+      break;
+    }
+    _window[_windowCount++] = SatellitePass(_pendingStart, _pendingEnd);
+    _hasPending = false;
+  }
+}
+
+bool SdPassSchedule::findPass(uint32_t targetTime, SatellitePass &pass) {
+  bool seeked = false;
+  if (targetTime < _validFrom) {
+    seek(targetTime);
+    seeked = true;
+  }
+  _validFrom = targetTime;
+  while (true) {
+    while (_windowCount > 0 && _window[_windowStart].endTime() < targetTime) {
+      _windowStart++;
+      _windowCount--;
+    }
+    if (_windowCount > 0) {
+      pass = _window[_windowStart];
+      return true;
+    }
+    if (!_hasPending && _nextRecord >= _recordCount) {
+      return false;
+    }
+    fill();
+    // Far behind targetTime, e.g. after a long power off: search instead of reading every pass
+    if (!seeked && _windowCount > 0 && _window[_windowCount - 1].endTime() < targetTime &&
+        _nextRecord < _recordCount) {
+      seek(targetTime);
+      seeked = true;
+    }
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef SdPassSchedule_h
+#define SdPassSchedule_h
+#include <SD.h>
+#include "pass_schedule.h"
+#include "pass_file_format.h"
+#define SD_PASS_WINDOW 8
+
+// Passes streamed from a binary schedule file on the SD card (see pass_file_format.h).
+// Only a window of SD_PASS_WINDOW upcoming passes is kept in RAM, the following ones are read
+// when it runs out. Overlapping passes are merged as they are read. Looking back in time, or far
+// ahead, repositions the window with a binary search in the file. The file stays open, so reading on
+// from the last pass read needs no seek.
+class SdPassSchedule : public PassSchedule {
+  public:
+    SdPassSchedule(const char *filename);
+    // Read the header. Returns false when the file is missing or is not a pass schedule
+    bool begin();
+    bool findPass(uint32_t targetTime, SatellitePass &pass);
+    uint32_t recordCount();
+  private:
+    bool readRecord(uint32_t &startTime, uint32_t &endTime);
+    bool readStartTime(uint32_t index, uint32_t &startTime);
+    void seek(uint32_t targetTime);
+    void fill();
+    const char *_filename;
+    File _file;
+    uint32_t _recordCount;
+    uint32_t _nextRecord;
+    // Record read from the file but not yet merged into the window
+    bool _hasPending;
+    uint32_t _pendingStart;
+    uint32_t _pendingEnd;
+    SatellitePass _window[SD_PASS_WINDOW];
+    uint8_t _windowStart;
+    uint8_t _windowCount;
+    // The window holds every pass ending at or after this time
+    uint32_t _validFrom;
+};
+#endif
@@ -0,0 +1,36 @@
+#include "thermistor.h"
+#include <Arduino.h>
+
+// Entry i is at reading i << THERMISTOR_STEP_BITS, spelt out as C++11 has no index sequences
+#define ENTRY(i) steinhartHart::entry((double)((i) << THERMISTOR_STEP_BITS) / (1 << THERMISTOR_EXTRA_BITS))
+#define ENTRIES_8(i) ENTRY(i), ENTRY(i + 1), ENTRY(i + 2), ENTRY(i + 3), ENTRY(i + 4), ENTRY(i + 5), ENTRY(i + 6), \
+  ENTRY(i + 7)
+#define ENTRIES_64(i) ENTRIES_8(i), ENTRIES_8(i + 8), ENTRIES_8(i + 16), ENTRIES_8(i + 24), ENTRIES_8(i + 32), \
+  ENTRIES_8(i + 40), ENTRIES_8(i + 48), ENTRIES_8(i + 56)
+
+static constexpr int16_t temperatureTable[THERMISTOR_TABLE_SIZE] PROGMEM = { ENTRIES_64(0), ENTRIES_64(64), ENTRY(128) };
+static_assert(THERMISTOR_TABLE_SIZE == 129, "the table above has 129 entries");
+
+Thermistor::Thermistor(uint8_t pin) {
+  _pin = pin;
+}
+
+uint16_t Thermistor::read() {
+  uint16_t sum = 0;
+  for (uint8_t i = 0; i < THERMISTOR_SAMPLES; i++) {
+    sum += analogRead(_pin);
+  }
+  // 16 samples add 4 bits to the sum, only THERMISTOR_EXTRA_BITS of them carry information
+  return sum >> (4 - THERMISTOR_EXTRA_BITS);
+}
+
+int16_t Thermistor::centiDegrees(uint16_t reading) {
+  if (reading > THERMISTOR_READING_MAX) {
+    reading = THERMISTOR_READING_MAX;
+  }
+  uint8_t index = reading >> THERMISTOR_STEP_BITS;
+  int16_t low = (int16_t)pgm_read_word(&temperatureTable[index]);
+  int16_t high = (int16_t)pgm_read_word(&temperatureTable[index + 1]);
+  uint8_t fraction = reading & ((1 << THERMISTOR_STEP_BITS) - 1);
+  return low + (int16_t)(((int32_t)(high - low) * fraction) >> THERMISTOR_STEP_BITS);
+}
@@ -0,0 +1,55 @@
+#ifndef Thermistor_h
+#define Thermistor_h
+#include <stdint.h>
+
+// Samples summed per reading: 16 samples of the 10 bit ADC give 2 more bits once the noise is averaged
+#define THERMISTOR_SAMPLES 16
+#define THERMISTOR_EXTRA_BITS 2
+// Readings run from 0 to THERMISTOR_READING_MAX, the ADC value times 4
+#define THERMISTOR_READING_BITS (10 + THERMISTOR_EXTRA_BITS)
+#define THERMISTOR_READING_MAX ((1 << THERMISTOR_READING_BITS) - 1)
+// Readings between two entries of the temperature table, interpolated
+#define THERMISTOR_STEP_BITS 5
+#define THERMISTOR_TABLE_SIZE ((1 << (THERMISTOR_READING_BITS - THERMISTOR_STEP_BITS)) + 1)
+
+// Temperature of the thermistor on the analogue pin in hundredths of a degree C, without floating point
+// at run time. The Steinhart-Hart equation the sketch used is evaluated by the compiler for every 8th
+// ADC value into a table in flash, readings in between are interpolated: within 0.055 C of the equation
+// from -19 C to 95 C, the most near 94 C where the curve bends the most between two entries.
+class Thermistor {
+  public:
+    Thermistor(uint8_t pin);
+    // Oversampled reading, THERMISTOR_SAMPLES samples decimated to THERMISTOR_READING_BITS
+    uint16_t read();
+    // Temperature of a reading, in hundredths of a degree C
+    static int16_t centiDegrees(uint16_t reading);
+  private:
+    uint8_t _pin;
+};
+
+// Compile time Steinhart-Hart equation of the table, one return per function for C++11
+namespace steinhartHart {
+  constexpr double LN2 = 0.69314718055994531;
+  // Sum of y^n / n over the odd n from n, for |y| <= 1/3
+  constexpr double atanhSeries(double y2, double power, int n) {
+    return n > 31 ? 0 : power / n + atanhSeries(y2, power * y2, n + 2);
+  }
+  // Natural logarithm, x brought between 1 and 2 first
+  constexpr double ln(double x) {
+    return x > 2 ? ln(x / 2) + LN2 : x < 1 ? ln(x * 2) - LN2
+      : 2 * atanhSeries(((x - 1) / (x + 1)) * ((x - 1) / (x + 1)), (x - 1) / (x + 1), 1);
+  }
+  constexpr double kelvin(double logResistance) {
+    return 1 / (0.001129148 + (0.000234125 + 0.0000000876741 * logResistance * logResistance) * logResistance);
+  }
+  // Hundredths of a degree C at an ADC value, 10000 ohm resistor in series
+  constexpr double centiDegrees(double adc) {
+    return 100 * (kelvin(ln(10000.0 * (1024.0 / adc - 1))) - 273.15);
+  }
+  // Table entry, rounded to an int16_t. The ends are taken 1 ADC value in, where the equation holds
+  constexpr int16_t entry(double adc) {
+    return adc < 1 ? entry(1) : adc > 1023 ? entry(1023) : centiDegrees(adc) >= 32767 ? 32767
+      : centiDegrees(adc) <= -32768 ? -32768 : (int16_t)(centiDegrees(adc) + (centiDegrees(adc) < 0 ? -0.5 : 0.5));
+  }
+}
+#endif
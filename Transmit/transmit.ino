@@ -10,14 +10,18 @@
 // Required for satellite comms
 #include "KIM.h"
 #include "msg_kineis_std.h"
-
-// Required for temperature sensor
-#include <math.h>
+#include "msg_kineis_layout.h"
+#include "msg_kineis_packed.h"
+#include "msg_kineis_fec.h"
+#include "msg_kineis_frag.h"
 
 // data logger
 RTC_PCF8523 rtc; // Real time clock
-unsigned int fileCounter = 1;
 #define cardSelect 10   // SD Card
+#include "data_logger.h"
+// Readings and transmissions in binary records (see Tools/log2text.c), on the card every 4 records
+#define logSyncRecords 4
+DataLogger dataLog("DATALOG.BIN", logSyncRecords);
 
 // Satellite comms
 const char BAND[] = "B1";
@@ -31,25 +35,113 @@ SoftwareSerial kserial(RX_KIM, TX_KIM);
 #endif
 KIM kim(&kserial);
 #include "satellite_pass.h"
+#include "pass_schedule.h"
+#include "satellite_passes.h"
+#include "sd_pass_schedule.h"
+// Passes from PASSES.BIN on the SD card (see Tools/prepas2bin.c), else the ones built in
+FlashPassSchedule flashPassSchedule(satellitePassTimes, SATELLITE_PASS_COUNT);
+SdPassSchedule sdPassSchedule("PASSES.BIN");
+PassSchedule *passSchedule = &flashPassSchedule;
+#if !defined(__AVR_ATmega328P__) // Not enough RAM on the Arduino UNO
+// Or passes predicted from the orbital elements in ELEMENTS.TXT (TLE sets) on the SD card
+#include "pass_predictor.h"
+// Location of the transmitter, in degrees north and east and metres above sea level. May be set by the build,
+// e.g. -DsiteLatitude=51.5 -DsiteLongitude=-0.12 -DsiteAltitude=20
+#ifndef siteLatitude
+#define siteLatitude 53.8
+#endif
+#ifndef siteLongitude
+#define siteLongitude -1.55
+#endif
+#ifndef siteAltitude
+#define siteAltitude 100
+#endif
+// Lowest elevation of a satellite above the horizon counted as a pass, in degrees
+#ifndef minElevation
+#define minElevation 5
+#endif
+PassPredictor passPredictor(siteLatitude, siteLongitude, siteAltitude, minElevation);
+PredictedPassSchedule predictedPassSchedule(passPredictor);
+#endif
 
 // General
-#define delayTime 58000 // 1 minute between messages allowing for processing
 #define redLedPin 2
 #define greenLedPin 3
 #define temperaturePin A0
-
-#include <QueueList.h>
-QueueList <String> queue;
-int minutesSinceLastReading;
+#define rtcInterruptPin 5 // INT/SQW output of the RTC, wakes the board
+
+#include "thermistor.h"
+// Temperature sensor, oversampled and converted in fixed point through a table in flash
+Thermistor thermistor(temperaturePin);
+
+#include "frame_journal.h"
+#include "frame_ring.h"
+// Frames waiting for a satellite pass, kept on the SD card across resets
+FrameJournal journal("QUEUE.BIN", "QUEUE.CKP");
+// Frames which could not be written to the journal. When full, the oldest reading is dropped
+#if defined(__AVR_ATmega328P__)
+#define frameQueueSize 8
+#else
+#define frameQueueSize 32
+#endif
+FrameRing<frameQueueSize> queue(DROP_OLDEST);
 int messageCounter;
+// Send up to 15 readings per message in binary (see msg_kineis_packed.h) rather than one as text
+#define packedPayload true
+#ifndef readingIntervalMinutes // May be set by the build, see Tools/simulate_transmit.cpp
+#define readingIntervalMinutes 20
+#endif
+#include "event_scheduler.h"
+#include "rtc_sleep.h"
+// Readings every readingIntervalMinutes on the clock, sleeping in between and until the passes
+EventScheduler events(readingIntervalMinutes * 60UL);
+RtcSleep rtcSleep(rtc, rtcInterruptPin);
+ArgosPackedReadingsTypeDef_t packedReadings; // Readings not yet in a message
+DateTime packedStart; // Time of the first of them
+// Readings not yet in a message wait for more readings until a pass, unless the pass after it starts more than
+// maxReadingDelayHours after the first of them: they are then sent with the pass. May be set by the build
+#ifndef maxReadingDelayHours
+#define maxReadingDelayHours 6
+#endif
+#if packedPayload
+// Follow every 4 messages with 2 parity messages (see msg_kineis_fec.h): any 4 of the 6 give the readings back,
+// each message is then sent once rather than 3 times. Set parityMessages to 0 to send copies instead
+#define parityGroupSize 4
+#define parityMessages 2
+// A group stays open across passes until it holds parityGroupSize messages, unless the pass after the current one
+// starts more than maxParityDelayHours after its first message: its messages are then sent a second time instead
+#ifndef maxParityDelayHours
+#define maxParityDelayHours 24
+#endif
+#else
+#define parityMessages 0
+#endif
+ArgosFecGroupTypeDef_t parityGroup; // Messages the next parity messages protect
+#if parityMessages > 0
+ArgosMsgTypeDef_t parityGroupMessages[parityGroupSize]; // The same messages, sent again when the group is closed short
+uint32_t parityGroupStart; // Time the first of them was queued
+#endif
+// Characters of text a message holds, the BCH32 is written over the end of its user data.
+// Longer text is sent in fragments (see msg_kineis_frag.h)
+#define textMessageLength 15
+
+#include "transmit_scheduler.h"
+// Send each message up to 3 times in a pass, or once with parity messages, in turn with the other messages waiting
+#define transmitInterval 16 // seconds between two transmissions: sending and the 15 s the KIM module was given after each
+#define maxCopies (parityMessages > 0 ? 1 : 3)
+TransmitScheduler transmitScheduler(transmitInterval, maxCopies);
 
 void setup() {
-  queue.setPrinter (Serial);
-  minutesSinceLastReading = 0;
   messageCounter = 1;
+  vMSGKINEIS_PACKED_init(&packedReadings, messageCounter, readingIntervalMinutes);
+#if parityMessages > 0
+  vMSGKINEIS_FEC_init(&parityGroup, parityGroupSize, parityMessages);
+#endif
   initialiseHardware();
   initialiseSdCard();
   initialiseSatellite();
+  rtcSleep.begin();
+  events.begin(rtc.now().unixtime());
   // TODO: Load PrepasRun.txt from file into PROGMEM memory see https://create.arduino.cc/projecthub/john-bradnam/reducing-your-memory-usage-26ca05
   Serial.println(F("Init complete"));
 }
@@ -57,208 +149,292 @@ void setup() {
 void loop() {
 
   DateTime now = rtc.now();
-  String filename = "datalog" + String(fileCounter) + ".txt";
-  int readingIntervalMinutes = 20;
   // Capture reading every X minutes, place in stack and log to SD card
-  if (minutesSinceLastReading == readingIntervalMinutes) {
+  if (events.readingDue(now.unixtime())) {
     digitalWrite(greenLedPin, HIGH);
-    minutesSinceLastReading = 0;
     // Assemble the data to send
-    int analogValue = analogRead(temperaturePin);
-    double temperature = getTemperatureFromThermistor(analogValue);
-
-    String dataString = "";
-    dataString.reserve(10);
-    dataString += "|";
-    dataString += messageCounter;
-    dataString += "|";
-    dataString += temperature;
-    dataString += "C;";
-    messageCounter++;
+    uint16_t reading = thermistor.read();
+    int16_t temperature = Thermistor::centiDegrees(reading); // hundredths of a degree C
 
-    char logEntry[60];
-    sprintf(logEntry, "%02d/%02d/%04d %02d:%02d:%02d%s", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second(), dataString.c_str());
+    char dataString[24];
+    uint16_t magnitude = temperature < 0 ? -temperature : temperature;
+    sprintf(dataString, "|%d|%s%u.%02uC;", messageCounter, temperature < 0 ? "-" : "", magnitude / 100, magnitude % 100);
 
-    if (dataString.length() > 20) {
-      dataString = dataString.substring(0, 19);
+    char logEntry[60];
+    sprintf(logEntry, "%02d/%02d/%04d %02d:%02d:%02d%s", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second(), dataString);
+
+    ArgosMsgTypeDef_t message;
+#if packedPayload
+    // Readings were missed, the readings packed so far cannot be followed by this one
+    if (events.missedReadings() > 0 && packedReadings.count > 0) {
+      createPackedMessage(message);
+      queueMessage(message);
+      protectMessage(message);
     }
-    String dataPacket = createSatelliteMessage(now.day(), now.hour(), now.minute(), dataString);
-    queue.push(dataPacket);
-    Serial.println("Number of entries in stack: " + String(queue.count()));
-    File dataFile = SD.open(filename, FILE_WRITE);
-    if (dataFile) {
-      dataFile.println(logEntry);
-      dataFile.println(dataPacket);
-      dataFile.close();
-      Serial.println(logEntry);
+    bool messageReady = addPackedReading(message, now, temperature);
+#else
+    uint8_t dataLength = strlen(dataString);
+    bool messageReady = dataLength <= textMessageLength;
+    if (messageReady) {
+      uint8_t userdata[USER_DATA_LENGTH];
+      memset(userdata, 0, sizeof(userdata));
+      memcpy(userdata, dataString, dataLength);
+      createSatelliteMessage(message, now.day(), now.hour(), now.minute(), userdata);
     } else {
-      Serial.println(F("Error opening SD card"));
+      queueRecord((const uint8_t *)dataString, dataLength);
+    }
+    messageCounter++;
+#endif
+    char dataPacket[ARGOS_FRAME_HEX_LENGTH + 1];
+    if (messageReady) {
+      queueMessage(message);
+      protectMessage(message);
+      vMSGKINEIS_STDV1_toHex(&message, dataPacket);
+      Serial.println(dataPacket);
+    }
+    Serial.println("Number of entries in stack: " + String(journal.count() + queue.count()));
+    Serial.println(logEntry);
+    if (!dataLog.logReading(now.unixtime(), reading >> THERMISTOR_EXTRA_BITS, temperature, messageReady ? &message : NULL)) {
+      Serial.println(F("Error writing log to SD card"));
     }
     digitalWrite(greenLedPin, LOW);
   }
 
   // If there is a message in the stack and a satellite passing overhead, then transmit the next message from the stack
   // Log the transmission to the SD card
-  if (!queue.isEmpty() && canTransmit()) {
-    File dataFile2 = SD.open(filename, FILE_WRITE);
+  ArgosMsgTypeDef_t message;
+#if packedPayload
+  // Send the readings not yet in a message with this pass when they cannot wait for the next one,
+  // and the messages of the parity group when they cannot wait for the parity
+  if (canTransmit()) {
+    if (packedReadings.count > 0 && !canWaitForNextPass(packedStart.unixtime(), maxReadingDelayHours)) {
+      createPackedMessage(message);
+      queueMessage(message);
+      protectMessage(message);
+    }
+#if parityMessages > 0
+    if (parityGroup.count > 0 && !canWaitForNextPass(parityGroupStart, maxParityDelayHours)) {
+      closeParityGroup();
+    }
+#endif
+  }
+#endif
+  SatellitePass pass;
+  if (pendingMessages() > 0 && currentPass(pass)) {
     Serial.println(F("KIM -- Sending data ... "));
-    while (!queue.isEmpty() && canTransmit()) {
-      delay(1000);
-      kim.set_sleepMode(false);
-      digitalWrite(redLedPin, HIGH);
-      char dataPacketConverted[62];
-      memset(dataPacketConverted, 0, sizeof(dataPacketConverted));
-      String dataPacketToSend = queue.pop();
-      dataPacketToSend.toCharArray(dataPacketConverted, dataPacketToSend.length());
-      now = rtc.now();
-      char logEntry2[200];
-      memset(logEntry2, 0, sizeof(logEntry2));
-      sprintf(logEntry2, "Sending: %02d/%02d/%04d %02d:%02d:%02d %s", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second(), dataPacketToSend.c_str());
-      if (dataFile2) {
-        dataFile2.println(logEntry2);
+    kim.set_sleepMode(false);
+    digitalWrite(redLedPin, HIGH);
+    delay(1000);
+    transmitScheduler.begin(pass.endTime());
+    uint8_t offset;
+    while (true) {
+      unsigned long transmissionStart = millis();
+      removeSentMessages(transmitScheduler.update(rtc.now().unixtime(), pendingMessages()));
+      if (!transmitScheduler.next(offset) || !peekMessage(offset, message)) {
+        break;
       }
-      // Send thrice to ensure transmission
-      for (int transmission = 0; transmission < 3; transmission++) {
-        Serial.println(logEntry2);
-        if (kim.send_data(dataPacketConverted, sizeof(dataPacketConverted) - 1) == OK_KIM) {
-          Serial.println(F("Message sent"));
-          delay(15000);
-        } else {
-          Serial.println(F("Error"));
-        }
+      // The hex text is written straight into the buffer handed to the module
+      char dataPacketToSend[ARGOS_FRAME_HEX_LENGTH + 1];
+      vMSGKINEIS_STDV1_toHex(&message, dataPacketToSend);
+      now = rtc.now();
+      char logEntry2[40];
+      sprintf(logEntry2, "Sending: %02d/%02d/%04d %02d:%02d:%02d ", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
+      Serial.print(logEntry2);
+      Serial.println(dataPacketToSend);
+      bool transmitted = kim.send_data(dataPacketToSend, ARGOS_FRAME_HEX_LENGTH) == OK_KIM;
+      Serial.println(transmitted ? F("Message sent") : F("Error"));
+      dataLog.logTransmission(now.unixtime(), message, transmitted);
+      transmitScheduler.sent(transmitted);
+      // Wait for the module before the next transmission
+      unsigned long elapsed = millis() - transmissionStart;
+      if (elapsed < transmitInterval * 1000UL) {
+        delay(transmitInterval * 1000UL - elapsed);
       }
     }
+    // Messages sent at least once are done with, the next pass starts with those never sent
+    removeSentMessages(transmitScheduler.end());
     Serial.println(F("KIM -- Turn OFF"));
-    dataFile2.close();
+    dataLog.sync();
     digitalWrite(redLedPin, LOW);
     kim.set_sleepMode(true);
   }
 
-  minutesSinceLastReading++; 
-  delay(delayTime); // Go to sleep until next time check
+  // Sleep until the next reading or the next pass
+  Serial.flush();
+  rtcSleep.sleepUntil(events.nextEvent(rtc.now().unixtime(), *passSchedule));
 }
 
-// Routine to work out if a satellite is passing overhead
-bool canTransmit() {
-  bool transmit = false;  
-  SatellitePass satellitePasses[] PROGMEM = {
-    SatellitePass (DateTime (2022,2,28,2,59,1), DateTime (2022,2,28,3,1,3)),
-SatellitePass (DateTime (2022,2,28,3,40,33), DateTime (2022,2,28,3,42,31)),
-SatellitePass (DateTime (2022,2,28,4,34,29), DateTime (2022,2,28,4,39,24)),
-SatellitePass (DateTime (2022,2,28,5,12,25), DateTime (2022,2,28,5,16,5)),
-SatellitePass (DateTime (2022,2,28,6,14,38), DateTime (2022,2,28,6,19,4)),
-SatellitePass (DateTime (2022,2,28,6,33,1), DateTime (2022,2,28,6,36,0)),
-SatellitePass (DateTime (2022,2,28,6,55,40), DateTime (2022,2,28,6,59,48)),
-SatellitePass (DateTime (2022,2,28,8,11,24), DateTime (2022,2,28,8,16,34)),
-SatellitePass (DateTime (2022,2,28,8,35,39), DateTime (2022,2,28,8,41,1)),
-SatellitePass (DateTime (2022,2,28,8,40,18), DateTime (2022,2,28,8,43,40)),
-SatellitePass (DateTime (2022,2,28,8,55,37), DateTime (2022,2,28,8,57,31)),
-SatellitePass (DateTime (2022,2,28,9,26,34), DateTime (2022,2,28,9,31,26)),
-SatellitePass (DateTime (2022,2,28,9,52,0), DateTime (2022,2,28,9,55,49)),
-SatellitePass (DateTime (2022,2,28,10,17,23), DateTime (2022,2,28,10,20,53)),
-SatellitePass (DateTime (2022,2,28,10,19,13), DateTime (2022,2,28,10,24,29)),
-SatellitePass (DateTime (2022,2,28,10,33,56), DateTime (2022,2,28,10,39,17)),
-SatellitePass (DateTime (2022,2,28,11,6,41), DateTime (2022,2,28,11,11,36)),
-SatellitePass (DateTime (2022,2,28,12,0,12), DateTime (2022,2,28,12,3,58)),
-SatellitePass (DateTime (2022,2,28,12,15,8), DateTime (2022,2,28,12,19,37)),
-SatellitePass (DateTime (2022,2,28,12,49,19), DateTime (2022,2,28,12,50,28)),
-SatellitePass (DateTime (2022,2,28,16,23,26), DateTime (2022,2,28,16,24,54)),
-SatellitePass (DateTime (2022,2,28,16,42,20), DateTime (2022,2,28,16,43,25)),
-SatellitePass (DateTime (2022,2,28,16,50,3), DateTime (2022,2,28,16,53,34)),
-SatellitePass (DateTime (2022,2,28,17,58,36), DateTime (2022,2,28,18,3,31)),
-SatellitePass (DateTime (2022,2,28,18,11,13), DateTime (2022,2,28,18,14,48)),
-SatellitePass (DateTime (2022,2,28,18,18,48), DateTime (2022,2,28,18,23,49)),
-SatellitePass (DateTime (2022,2,28,18,28,1), DateTime (2022,2,28,18,33,26)),
-SatellitePass (DateTime (2022,2,28,18,32,4), DateTime (2022,2,28,18,34,16)),
-SatellitePass (DateTime (2022,2,28,18,51,5), DateTime (2022,2,28,18,52,26)),
-SatellitePass (DateTime (2022,2,28,19,16,41), DateTime (2022,2,28,19,20,49)),
-SatellitePass (DateTime (2022,2,28,19,38,43), DateTime (2022,2,28,19,43,27)),
-SatellitePass (DateTime (2022,2,28,19,46,9), DateTime (2022,2,28,19,48,29)),
-SatellitePass (DateTime (2022,2,28,19,58,43), DateTime (2022,2,28,20,2,55)),
-SatellitePass (DateTime (2022,2,28,20,8,10), DateTime (2022,2,28,20,13,17)),
-SatellitePass (DateTime (2022,2,28,20,10,27), DateTime (2022,2,28,20,14,39)),
-SatellitePass (DateTime (2022,2,28,20,26,46), DateTime (2022,2,28,20,31,49)),
-SatellitePass (DateTime (2022,2,28,20,55,9), DateTime (2022,2,28,21,0,28)),
-SatellitePass (DateTime (2022,2,28,21,48,57), DateTime (2022,2,28,21,53,37)),
-SatellitePass (DateTime (2022,2,28,22,7,25), DateTime (2022,2,28,22,12,32)),
-SatellitePass (DateTime (2022,2,28,22,38,53), DateTime (2022,2,28,22,41,28)),
-SatellitePass (DateTime (2022,3,1,3,26,38), DateTime (2022,3,1,3,27,23)),
-SatellitePass (DateTime (2022,3,1,4,4,4), DateTime (2022,3,1,4,8,33)),
-SatellitePass (DateTime (2022,3,1,4,57,6), DateTime (2022,3,1,5,0,47)),
-SatellitePass (DateTime (2022,3,1,5,42,50), DateTime (2022,3,1,5,47,48)),
-SatellitePass (DateTime (2022,3,1,6,33,45), DateTime (2022,3,1,6,35,16)),
-SatellitePass (DateTime (2022,3,1,6,44,10), DateTime (2022,3,1,6,47,49)),
-SatellitePass (DateTime (2022,3,1,7,46,13), DateTime (2022,3,1,7,51,17)),
-SatellitePass (DateTime (2022,3,1,8,20,52), DateTime (2022,3,1,8,22,38)),
-SatellitePass (DateTime (2022,3,1,8,23,46), DateTime (2022,3,1,8,29,11)),
-SatellitePass (DateTime (2022,3,1,9,6,6), DateTime (2022,3,1,9,10,32)),
-SatellitePass (DateTime (2022,3,1,9,26,25), DateTime (2022,3,1,9,30,52)),
-SatellitePass (DateTime (2022,3,1,9,58,33), DateTime (2022,3,1,10,3,46)),
-SatellitePass (DateTime (2022,3,1,10,5,19), DateTime (2022,3,1,10,9,14)),
-SatellitePass (DateTime (2022,3,1,10,22,0), DateTime (2022,3,1,10,27,16)),
-SatellitePass (DateTime (2022,3,1,10,45,51), DateTime (2022,3,1,10,50,58)),
-SatellitePass (DateTime (2022,3,1,11,39,11), DateTime (2022,3,1,11,43,31)),
-SatellitePass (DateTime (2022,3,1,12,3,0), DateTime (2022,3,1,12,7,46)),
-SatellitePass (DateTime (2022,3,1,12,27,28), DateTime (2022,3,1,12,30,6)),
-SatellitePass (DateTime (2022,3,1,16,38,54), DateTime (2022,3,1,16,41,55)),
-SatellitePass (DateTime (2022,3,1,17,33,57), DateTime (2022,3,1,17,38,29)),
-SatellitePass (DateTime (2022,3,1,17,47,59), DateTime (2022,3,1,17,52,37)),
-SatellitePass (DateTime (2022,3,1,17,55,59), DateTime (2022,3,1,17,59,27)),
-SatellitePass (DateTime (2022,3,1,18,16,16), DateTime (2022,3,1,18,21,37)),
-SatellitePass (DateTime (2022,3,1,18,56,51), DateTime (2022,3,1,19,0,21)),
-SatellitePass (DateTime (2022,3,1,19,12,59), DateTime (2022,3,1,19,18,4)),
-SatellitePass (DateTime (2022,3,1,19,27,22), DateTime (2022,3,1,19,32,6)),
-SatellitePass (DateTime (2022,3,1,19,30,28), DateTime (2022,3,1,19,33,17)),
-SatellitePass (DateTime (2022,3,1,19,47,52), DateTime (2022,3,1,19,52,42)),
-SatellitePass (DateTime (2022,3,1,19,58,8), DateTime (2022,3,1,20,2,40)),
-SatellitePass (DateTime (2022,3,1,20,15,3), DateTime (2022,3,1,20,19,56)),
-SatellitePass (DateTime (2022,3,1,20,34,26), DateTime (2022,3,1,20,39,44)),
-SatellitePass (DateTime (2022,3,1,21,9,35), DateTime (2022,3,1,21,10,18)),
-SatellitePass (DateTime (2022,3,1,21,27,42), DateTime (2022,3,1,21,32,46)),
-SatellitePass (DateTime (2022,3,1,21,55,13), DateTime (2022,3,1,22,0,29)),
-SatellitePass (DateTime (2022,3,1,22,16,39), DateTime (2022,3,1,22,20,27))
-
-    // TODO: add in more passes or calculate automatically
-  };
-  for (int satellite = 0; satellite < sizeof(satellitePasses) / sizeof(SatellitePass); satellite++) {
-    if (satellitePasses[satellite].isInRange(rtc.now())) {
-      transmit = true;
-      break;
+// Messages waiting: those held in memory first, then those in the journal
+uint32_t pendingMessages() {
+  return queue.count() + journal.count();
+}
+
+// Message offset places after the oldest one waiting, offset below SCHEDULER_WINDOW
+bool peekMessage(uint8_t offset, ArgosMsgTypeDef_t &message) {
+  const ArgosMsgTypeDef_t *frame = queue.peek(offset);
+  if (frame != NULL) {
+    message = *frame;
+    return true;
+  }
+  return journal.peek(message, offset - queue.count());
+}
+
+// Remove the oldest messages once they have been sent
+void removeSentMessages(uint8_t count) {
+  for (; count > 0; count--) {
+    if (!queue.isEmpty()) {
+      ArgosMsgTypeDef_t message;
+      queue.pop(message);
+    } else {
+      journal.pop();
     }
   }
-  return transmit;
+}
+
+// Pass in progress, if any
+bool currentPass(SatellitePass &pass) {
+  uint32_t now = rtc.now().unixtime();
+  return passSchedule->findPass(now, pass) && pass.isInRange(now);
+}
+
+// Routine to work out if a satellite is passing overhead
+bool canTransmit() {
+  return passSchedule->isInPass(rtc.now().unixtime());
+}
+
+// Tell if what started at firstTime can wait for the pass after the current one, at most maxDelayHours after it
+bool canWaitForNextPass(uint32_t firstTime, uint8_t maxDelayHours) {
+  SatellitePass pass;
+  return passSchedule->nextPass(rtc.now().unixtime(), pass) &&
+    pass.startTime() - firstTime <= maxDelayHours * 3600UL;
 }
 
 // Function to create the message to send with error correction code
-String createSatelliteMessage(uint8_t day, uint8_t hour, uint8_t min, String userMessage) {
-  ArgosMsgTypeDef_t message;
-  int counter;
+void createSatelliteMessage(ArgosMsgTypeDef_t &message, uint8_t day, uint8_t hour, uint8_t min, const uint8_t userdata[USER_DATA_LENGTH]) {
   uint32_t lon  = 450000; // TODO Replace this with real coordinates
   uint32_t lat  = 25000;
   uint32_t alt  = 65;
 
-  uint8_t userdata[20];
-  memset(userdata, 0, sizeof(userdata));
-  userMessage.getBytes(userdata, userMessage.length());
-     
-  vMSGKINEIS_STDV1_cleanPayload(&message);
-  u16MSGKINEIS_STDV1_setAcqPeriod(&message, USER_MSG, POSITION_STD_ACQ_PERIOD); 
-  u16MSGKINEIS_STDV1_setDate(&message, day, hour, min, POSITION_STD_DATE);
-  u16MSGKINEIS_STDV1_setLocation(&message, lon, lat, alt, POSITION_STD_LOC);
-  u16MSGKINEIS_STDV1_setUserData(&message, userdata, 20, POSITION_STD_USER_DATA);
-  vMSGKINEIS_STDV1_setCRC16andBCH32(&message, POSITION_STD_BCH32);
-
-  char buf[3];
-  String dataPacketString = "";
-  for (counter = 0; counter < ARGOS_FRAME_LENGTH; counter++) {
-    memset(buf, 0, sizeof(buf));
-    sprintf(buf, "%02x", message.payload[counter]);
-    dataPacketString += buf;
+  vArgosStdv1_encodePosition(&message, USER_MSG, day, hour, min, lon, lat, alt, userdata);
+}
+
+// Message of the packed readings, timed at the first of them. Starts a new set of readings
+void createPackedMessage(ArgosMsgTypeDef_t &message) {
+  uint8_t userdata[USER_DATA_LENGTH];
+  bMSGKINEIS_PACKED_toUserData(&packedReadings, userdata);
+  createSatelliteMessage(message, packedStart.day(), packedStart.hour(), packedStart.minute(), userdata);
+  messageCounter++;
+  vMSGKINEIS_PACKED_init(&packedReadings, messageCounter, readingIntervalMinutes);
+}
+
+// Add a reading to the packed readings. Returns true with their message when they are full, or when
+// the reading differs too much from the previous one to be packed with it. Temperature in hundredths of a degree C
+bool addPackedReading(ArgosMsgTypeDef_t &message, const DateTime &now, int16_t temperature) {
+  int16_t tenths = constrain((temperature + (temperature < 0 ? -5 : 5)) / 10, PACKED_TEMPERATURE_MIN, PACKED_TEMPERATURE_MAX);
+  bool messageReady = false;
+  if (packedReadings.count > 0 && !bMSGKINEIS_PACKED_append(&packedReadings, tenths)) {
+    createPackedMessage(message);
+    messageReady = true;
+  }
+  if (packedReadings.count == 0) {
+    packedStart = now;
+    bMSGKINEIS_PACKED_append(&packedReadings, tenths);
+  }
+  if (packedReadings.count == PACKED_MAX_READINGS) {
+    createPackedMessage(message);
+    messageReady = true;
+  }
+  return messageReady;
+}
+
+// Add a packed message to the parity group, the parity messages are queued when the group is full
+void protectMessage(const ArgosMsgTypeDef_t &message) {
+#if parityMessages > 0
+  if (!bMSGKINEIS_FEC_addMessage(&parityGroup, &message)) {
+    closeParityGroup();
+    if (!bMSGKINEIS_FEC_addMessage(&parityGroup, &message)) {
+      return;
+    }
+  }
+  if (parityGroup.count == 1) {
+    parityGroupStart = rtc.now().unixtime();
+  }
+  parityGroupMessages[parityGroup.count - 1] = message;
+  if (parityGroup.count == parityGroupSize) {
+    closeParityGroup();
+  }
+#endif
+}
+
+// Queue the parity messages of a full parity group, or queue the messages of a group closed short a second time
+// rather than follow as few as one message with parityMessages parity messages. Then start a new group
+void closeParityGroup() {
+#if parityMessages > 0
+  if (parityGroup.count == parityGroupSize) {
+    ArgosMsgTypeDef_t parity;
+    for (uint8_t index = 0; index < parityMessages; index++) {
+      bMSGKINEIS_FEC_getParity(&parityGroup, index, &parity);
+      queueMessage(parity);
+    }
+  } else {
+    for (uint8_t index = 0; index < parityGroup.count; index++) {
+      queueMessage(parityGroupMessages[index]);
+    }
+  }
+  vMSGKINEIS_FEC_init(&parityGroup, parityGroupSize, parityMessages);
+#endif
+}
+
+// Queue a record too long for one message as fragments, numbered after messageCounter
+void queueRecord(const uint8_t *data, uint16_t length) {
+  uint8_t fragments = u8MSGKINEIS_FRAG_count(length);
+  if (fragments == 0) {
+    Serial.println(F("Record too long, not sent"));
+    return;
+  }
+  ArgosMsgTypeDef_t fragment;
+  char dataPacket[ARGOS_FRAME_HEX_LENGTH + 1];
+  for (uint8_t index = 0; index < fragments; index++) {
+    bMSGKINEIS_FRAG_getFragment(data, length, messageCounter & 0xFF, index, &fragment);
+    queueMessage(fragment);
+    vMSGKINEIS_STDV1_toHex(&fragment, dataPacket);
+    Serial.println(dataPacket);
+  }
+}
+
+// Keep a message until a satellite passes, in memory if the journal cannot be written
+void queueMessage(const ArgosMsgTypeDef_t &message) {
+  if (!journal.push(message)) {
+    Serial.println(F("Error writing journal, message kept in memory"));
+    if (!queue.push(message)) {
+      Serial.println(F("Queue full, oldest message dropped"));
+    }
+  }
+}
+
+#if !defined(__AVR_ATmega328P__)
+// Read the two line element sets of a file, name lines are skipped
+bool loadOrbitalElements(const char *filename) {
+  File file = SD.open(filename, FILE_READ);
+  if (!file) {
+    return false;
   }
-  dataPacketString.toUpperCase();
-  Serial.println(dataPacketString); 
-  return dataPacketString;
+  char line1[72];
+  char line2[72];
+  memset(line1, 0, sizeof(line1));
+  while (file.available()) {
+    memset(line2, 0, sizeof(line2));
+    file.readBytesUntil('\n', line2, sizeof(line2) - 1);
+    OrbitalElements elements;
+    if (line1[0] == '1' && line2[0] == '2' && parseTwoLineElements(line1, line2, elements)) {
+      predictedPassSchedule.addSatellite(elements);
+    }
+    memcpy(line1, line2, sizeof(line1));
+  }
+  file.close();
+  return predictedPassSchedule.satelliteCount() > 0;
 }
+#endif
 
 void initialiseSdCard() {
 
@@ -269,6 +445,25 @@ void initialiseSdCard() {
     // don't do anything more:
     while (1) delay(10);
   }
+  if (!dataLog.begin()) {
+    Serial.println(F("Error opening log on SD card"));
+  }
+  if (journal.begin()) {
+    Serial.println("Messages waiting in journal: " + String(journal.count()));
+  } else {
+    Serial.println(F("Error reading journal"));
+  }
+  if (sdPassSchedule.begin()) {
+    passSchedule = &sdPassSchedule;
+    Serial.println("Passes loaded from SD card: " + String(sdPassSchedule.recordCount()));
+#if !defined(__AVR_ATmega328P__)
+  } else if (loadOrbitalElements("ELEMENTS.TXT")) {
+    passSchedule = &predictedPassSchedule;
+    Serial.println("Satellites loaded from SD card: " + String(predictedPassSchedule.satelliteCount()));
+#endif
+  } else {
+    Serial.println(F("No pass file on SD card, using built in passes"));
+  }
 
   Serial.println(F("Init RTC")); 
   if (! rtc.begin()) {
@@ -346,12 +541,3 @@ void initialiseSatellite() {
   Serial.println(kim.get_TCXOWU());
   kim.set_sleepMode(true);
 }
-
-// Convert Analogue signal to temperature
-double getTemperatureFromThermistor(int rawADC) {
-  double temperature;
-  temperature = log(10000.0 * ((1024.0 / rawADC - 1)));
-  temperature = 1 / (0.001129148 + (0.000234125 + (0.0000000876741 * temperature * temperature )) * temperature );
-  temperature = temperature - 273.15;            // Convert Kelvin to Celcius
-  return temperature;
-}
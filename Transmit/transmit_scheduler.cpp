@@ -0,0 +1,119 @@
+#include "transmit_scheduler.h"
+
+TransmitScheduler::TransmitScheduler(uint16_t interval, uint8_t maxCopies) {
+  _interval = interval;
+  _maxCopies = maxCopies;
+  _passEnd = 0;
+  _inPass = false;
+  _copies = 0;
+  _spare = 0;
+  _windowCount = 0;
+  _turn = 0;
+}
+
+void TransmitScheduler::begin(uint32_t passEnd) {
+  _passEnd = passEnd;
+  _inPass = true;
+  _copies = _maxCopies;
+  _spare = 0;
+  _windowCount = 0;
+  _turn = 0;
+  for (uint8_t index = 0; index < SCHEDULER_WINDOW; index++) {
+    _sent[index] = 0;
+  }
+}
+
+uint32_t TransmitScheduler::transmissionsLeft(uint32_t now) {
+  if (!_inPass || now > _passEnd) {
+    return 0;
+  }
+  return (_passEnd - now) / _interval + 1;
+}
+
+uint8_t TransmitScheduler::update(uint32_t now, uint32_t pending) {
+  uint32_t left = transmissionsLeft(now);
+  if (left == 0) {
+    _inPass = false;
+    return 0;
+  }
+  if (_windowCount > pending) {
+    _windowCount = pending;
+  }
+  // Most copies of every frame waiting which fit in the transmissions left, at least one. Never more
+  // than planned before, so the copies of the older frames are always finished first
+  uint32_t needed;
+  while (true) {
+    needed = (pending - _windowCount) * _copies;
+    for (uint8_t index = 0; index < _windowCount; index++) {
+      if (_sent[index] < _copies) {
+        needed += _copies - _sent[index];
+      }
+    }
+    if (needed <= left || _copies == 1) {
+      break;
+    }
+    _copies--;
+  }
+  // The transmissions left over give the oldest frames a copy more
+  _spare = needed < left && _copies < _maxCopies ? left - needed : 0;
+  uint8_t finished = finish(false);
+  pending -= finished;
+  _windowCount = pending < SCHEDULER_WINDOW ? pending : SCHEDULER_WINDOW;
+  if (_turn >= _windowCount) {
+    _turn = 0;
+  }
+  return finished;
+}
+
+bool TransmitScheduler::next(uint8_t &offset) {
+  if (!_inPass || _windowCount == 0) {
+    return false;
+  }
+  // Skip the frames sent more than the others after a failed transmission
+  for (uint8_t tried = 0; tried < _windowCount; tried++) {
+    if (_sent[_turn] < target(_turn)) {
+      offset = _turn;
+      return true;
+    }
+    _turn = (_turn + 1) % _windowCount;
+  }
+  return false;
+}
+
+void TransmitScheduler::sent(bool transmitted) {
+  if (_windowCount == 0) {
+    return;
+  }
+  if (transmitted) {
+    _sent[_turn]++;
+  }
+  _turn = (_turn + 1) % _windowCount;
+}
+
+uint8_t TransmitScheduler::end() {
+  uint8_t finished = finish(true);
+  _inPass = false;
+  _windowCount = 0;
+  _turn = 0;
+  return finished;
+}
+
+// Copies to send of a window frame
+uint8_t TransmitScheduler::target(uint8_t index) {
+  return _spare > index ? _copies + 1 : _copies;
+}
+
+// Drop the oldest frames of the window with all their copies sent, or with one when the pass is
+// over. The following ones move up
+uint8_t TransmitScheduler::finish(bool passOver) {
+  uint8_t finished = 0;
+  while (finished < _windowCount && _sent[finished] >= (passOver ? 1 : target(finished))) {
+    finished++;
+  }
+  for (uint8_t index = 0; index < SCHEDULER_WINDOW; index++) {
+    _sent[index] = index + finished < SCHEDULER_WINDOW ? _sent[index + finished] : 0;
+  }
+  _windowCount -= finished;
+  _turn = _turn >= finished ? _turn - finished : 0;
+  return finished;
+}
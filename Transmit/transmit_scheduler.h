@@ -0,0 +1,48 @@
+#ifndef TransmitScheduler_h
+#define TransmitScheduler_h
+#include <stdint.h>
+
+// Oldest frames waiting which are sent in turn, at most JOURNAL_WINDOW
+#define SCHEDULER_WINDOW 4
+
+// Plans the transmissions of a satellite pass. Transmissions are at least interval seconds apart,
+// so the time left in the pass gives the number of transmissions left. Each frame is sent up to
+// maxCopies times, fewer when the frames waiting would not all fit, down to once as the pass closes,
+// the oldest frames getting a copy more from the transmissions left over.
+// Copies of a frame are not sent back to back but in turn with the other frames of the window,
+// the oldest frames waiting. Frames are finished oldest first, so they can be removed from a queue.
+// Times are in seconds since 1970-01-01, as DateTime::unixtime()
+class TransmitScheduler {
+  public:
+    TransmitScheduler(uint16_t interval, uint8_t maxCopies);
+    // Start of the transmissions of a pass ending at passEnd (included)
+    void begin(uint32_t passEnd);
+    // Plan the transmissions left from now with pending frames waiting, including those of the window.
+    // Returns the number of oldest frames needing no more copies, to remove from the queue
+    uint8_t update(uint32_t now, uint32_t pending);
+    // Frame to send next, as an offset from the oldest frame waiting. False when the pass is over or
+    // no frame is left
+    bool next(uint8_t &offset);
+    // Result of the transmission of the frame given by next
+    void sent(bool transmitted);
+    // End of the pass. Returns the number of oldest frames sent at least once, to remove from the queue,
+    // so the next pass starts with frames never sent
+    uint8_t end();
+    // Transmissions left in the pass at time now
+    uint32_t transmissionsLeft(uint32_t now);
+    // Copies planned for each frame
+    uint8_t copies() { return _copies; }
+  private:
+    uint8_t target(uint8_t index);
+    uint8_t finish(bool passOver);
+    uint16_t _interval;
+    uint8_t _maxCopies;
+    uint32_t _passEnd;
+    bool _inPass;
+    uint8_t _copies;
+    uint32_t _spare; // transmissions left over, a copy more for as many of the oldest frames
+    uint8_t _windowCount;
+    uint8_t _turn; // window offset of the frame sent next
+    uint8_t _sent[SCHEDULER_WINDOW]; // copies sent of the window frames, oldest first
+};
+#endif